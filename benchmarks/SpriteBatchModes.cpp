@@ -0,0 +1,130 @@
+/// Compares SpriteBatch2D quad submission modes: 6 vertices per quad vs. 4 vertices + static quad indices vs.
+/// one instance record per quad expanded in the vertex shader vs. both textures bound per draw call vs. packed
+/// 14-byte vertices.
+///
+/// Usage: sdgl_bench_spritebatch_modes [--quads:<count>] [--frames:<count>]
+#include <sdgl/sdgl.h>
+#include <sdgl/ArgParser.h>
+#include <sdgl/angles.h>
+
+#include <chrono>
+#include <cstdio>
+
+using namespace sdgl;
+
+class SpriteBatchModesBench final : public App
+{
+public:
+    SpriteBatchModesBench(int argc, char *argv[]) : App("SpriteBatch Modes Benchmark", 1280, 720),
+        m_args(argc, argv)
+    { }
+
+protected:
+    bool init() override
+    {
+        int quads = 50000, frames = 300;
+        if (ArgParser::Arg arg{"", ""}; m_args.getNamedArg("quads", &arg))
+            arg.getValue(&quads);
+        if (ArgParser::Arg arg{"", ""}; m_args.getNamedArg("frames", &arg))
+            arg.getValue(&frames);
+        m_quadCount = quads;
+        m_framesPerMode = frames;
+
+        // two textures so that batches are broken up like in a typical scene
+        for (auto &texture : m_textures)
+        {
+            if (!texture.loadBytes(vector<Color>(16 * 16, Color::White), 16, 16, TextureFilter::Nearest))
+                return false;
+        }
+
+        m_batch.init();
+        m_instancedBatch.init(SpritePath::Instanced);
+        m_multiTextureBatch.init(SpritePath::PerVertex, 2);
+        m_packedBatch.init(SpritePath::PerVertex, 1, VertexFormat::Packed);
+        m_camera.setViewport({0, 0, 1280, 720});
+        m_camera.setOrigin({0, 0});
+
+        m_modes[0] = {&m_batch, QuadMode::Vertices, "vertices (6 per quad)"};
+        m_modes[1] = {&m_batch, QuadMode::Indexed,  "indexed  (4 per quad)"};
+        m_modes[2] = {&m_instancedBatch, QuadMode::Indexed, "instanced (1 per quad)"};
+        m_modes[3] = {&m_multiTextureBatch, QuadMode::Indexed, "indexed, 2 texture slots"};
+        m_modes[4] = {&m_packedBatch, QuadMode::Indexed, "indexed, packed vertices"};
+        std::printf("%d quads, %d frames per mode\n", m_quadCount, m_framesPerMode);
+        return true;
+    }
+
+    void update() override { }
+
+    void render() override
+    {
+        if (m_modeIndex >= std::size(m_modes))
+        {
+            quit();
+            return;
+        }
+
+        auto &mode = m_modes[m_modeIndex];
+        mode.batch->setQuadMode(mode.mode);
+
+        window()->clear(Color::Black);
+
+        const auto start = std::chrono::steady_clock::now();
+        SpriteBatchBase2D &batch = *mode.batch;
+        batch.begin(m_camera.getMatrix(), SortOrder::None);
+        for (int i = 0; i < m_quadCount; ++i)
+        {
+            batch.drawTexture(m_textures[(i / 64) % 2], {0, 0, 16, 16},
+                {(float)(i * 7 % 1280), (float)(i * 13 % 720)}, Color::White, {1.f, 1.f}, {8.f, 8.f},
+                (float)i * .01f);
+        }
+        batch.end();
+        glFinish(); // include GPU time in the measurement
+
+        mode.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        mode.bytes += mode.batch->streamStats().bytesUploaded;
+
+        if (++m_frame >= m_framesPerMode)
+        {
+            std::printf("%s: %8.3f ms/frame, %8.1f KiB uploaded/frame, %u draw calls\n", mode.name,
+                mode.seconds * 1000.0 / m_framesPerMode, (double)mode.bytes / 1024.0 / m_framesPerMode,
+                mode.batch->stats().batches);
+            m_frame = 0;
+            ++m_modeIndex;
+        }
+    }
+
+    void shutdown() override
+    {
+        for (auto &texture : m_textures)
+            texture.unload();
+    }
+
+private:
+    struct Mode
+    {
+        SpriteBatch2D *batch = nullptr;
+        QuadMode::Enum mode = QuadMode::Vertices;
+        const char *name = "";
+        double seconds = 0;
+        size_t bytes = 0;
+    };
+
+    ArgParser m_args;
+    SpriteBatch2D m_batch;
+    SpriteBatch2D m_instancedBatch;
+    SpriteBatch2D m_multiTextureBatch;
+    SpriteBatch2D m_packedBatch;
+    Camera2D m_camera;
+    Texture2D m_textures[2];
+    Mode m_modes[5];
+    size_t m_modeIndex = 0;
+    int m_frame = 0;
+    int m_quadCount = 0;
+    int m_framesPerMode = 0;
+};
+
+int main(int argc, char *argv[])
+{
+    SpriteBatchModesBench bench(argc, argv);
+    return bench.run(argc, argv);
+}
@@ -0,0 +1,195 @@
+/// Compares drawing a scrolling tile map via SpriteBatch2D::drawFrame per cell against TileMap's baked chunks,
+/// with and without one tile edited per frame.
+///
+/// Usage: sdgl_bench_tilemap [--tiles:<width and height>] [--frames:<count>]
+#include <sdgl/sdgl.h>
+#include <sdgl/ArgParser.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+using namespace sdgl;
+
+class TileMapBench final : public App
+{
+public:
+    TileMapBench(int argc, char *argv[]) : App("TileMap Benchmark", 1280, 720),
+        m_args(argc, argv)
+    { }
+
+protected:
+    bool init() override
+    {
+        int tiles = 512, frames = 300;
+        if (ArgParser::Arg arg{"", ""}; m_args.getNamedArg("tiles", &arg))
+            arg.getValue(&tiles);
+        if (ArgParser::Arg arg{"", ""}; m_args.getNamedArg("frames", &arg))
+            arg.getValue(&frames);
+        m_mapSize = tiles;
+        m_framesPerMode = frames;
+
+        // a 4x4 sheet of 16x16 tiles
+        if (!m_texture.loadBytes(vector<Color>(64 * 64, Color::White), 64, 64, TextureFilter::Nearest))
+            return false;
+
+        for (int i = 0; i < TilesetSize; ++i)
+        {
+            m_frames[i].frame = {static_cast<int16>(i % 4 * TileSize), static_cast<int16>(i / 4 * TileSize),
+                TileSize, TileSize};
+            m_frames[i].size = {TileSize, TileSize};
+            m_frames[i].texture = m_texture;
+        }
+
+        m_tiles.resize(static_cast<size_t>(m_mapSize) * m_mapSize);
+        for (size_t i = 0; i < m_tiles.size(); ++i)
+            m_tiles[i] = static_cast<uint16>(i * 7 % (TilesetSize + 1)); // 1 in 17 cells empty
+
+        if (!m_map.init(m_mapSize, m_mapSize, TileSize, TileSize))
+            return false;
+        m_map.setTileset(m_frames);
+        m_map.setTiles({0, 0, m_mapSize, m_mapSize}, m_tiles);
+
+        m_batch.init();
+        m_camera.setViewport({0, 0, 1280, 720});
+        m_camera.setOrigin({0, 0});
+
+        std::printf("%dx%d tiles, %d frames per mode\n", m_mapSize, m_mapSize, m_framesPerMode);
+        return true;
+    }
+
+    void update() override { }
+
+    void render() override
+    {
+        if (m_modeIndex >= std::size(ModeNames))
+        {
+            quit();
+            return;
+        }
+
+        // scroll diagonally across the map
+        const auto travel = static_cast<float>(m_mapSize * TileSize - 1280);
+        const auto t = static_cast<float>(m_frame) / static_cast<float>(m_framesPerMode);
+        m_camera.setPosition({travel * t, travel * t * .5f});
+
+        window()->clear(Color::Black);
+
+        const auto start = std::chrono::steady_clock::now();
+        size_t bytes = 0;
+        uint drawCalls = 0;
+        switch(m_modeIndex)
+        {
+            case 0: // every cell, rejected by the batch's culling
+            {
+                m_batch.begin(m_camera, SortOrder::None);
+                for (int y = 0; y < m_mapSize; ++y)
+                {
+                    for (int x = 0; x < m_mapSize; ++x)
+                        drawCell(x, y);
+                }
+                m_batch.end();
+                bytes = m_batch.stats().bytesUploaded;
+                drawCalls = m_batch.stats().drawCalls;
+            } break;
+
+            case 1: // only the cells in view
+            {
+                const auto bounds = m_camera.getWorldBounds();
+                const auto left = std::max(static_cast<int>(std::floor(bounds.left() / TileSize)), 0);
+                const auto top = std::max(static_cast<int>(std::floor(bounds.top() / TileSize)), 0);
+                const auto right = std::min(static_cast<int>(std::ceil(bounds.right() / TileSize)), m_mapSize);
+                const auto bottom = std::min(static_cast<int>(std::ceil(bounds.bottom() / TileSize)), m_mapSize);
+
+                m_batch.begin(m_camera.getMatrix(), SortOrder::None);
+                for (int y = top; y < bottom; ++y)
+                {
+                    for (int x = left; x < right; ++x)
+                        drawCell(x, y);
+                }
+                m_batch.end();
+                bytes = m_batch.stats().bytesUploaded;
+                drawCalls = m_batch.stats().drawCalls;
+            } break;
+
+            case 3: // edit a cell in view each frame, so its chunk is rebaked
+            {
+                const auto center = m_camera.viewToWorld({640, 360});
+                const auto x = static_cast<int>(center.x) / TileSize, y = static_cast<int>(center.y) / TileSize;
+                m_map.setTile(x, y, static_cast<uint16>(m_map.getTile(x, y) % TilesetSize + 1));
+            } [[fallthrough]];
+
+            case 2:
+            {
+                m_map.render(m_camera);
+                bytes = m_map.stats().bytesUploaded;
+                drawCalls = m_map.stats().drawCalls;
+            } break;
+
+            default:
+            break;
+        }
+        glFinish(); // include GPU time in the measurement
+
+        m_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        m_bytes += bytes;
+
+        if (++m_frame >= m_framesPerMode)
+        {
+            std::printf("%s: %8.3f ms/frame, %8.1f KiB uploaded/frame, %u draw calls\n", ModeNames[m_modeIndex],
+                m_seconds * 1000.0 / m_framesPerMode, (double)m_bytes / 1024.0 / m_framesPerMode, drawCalls);
+            m_frame = 0;
+            m_seconds = 0;
+            m_bytes = 0;
+            ++m_modeIndex;
+        }
+    }
+
+    void shutdown() override
+    {
+        m_map.dispose();
+        m_texture.unload();
+    }
+
+private:
+    static constexpr int16 TileSize = 16;
+    static constexpr int TilesetSize = 16;
+    static constexpr const char *ModeNames[] = {
+        "drawFrame, every cell culled ",
+        "drawFrame, visible cells only",
+        "TileMap                      ",
+        "TileMap, 1 edit per frame    ",
+    };
+
+    void drawCell(const int x, const int y)
+    {
+        const auto tile = m_tiles[static_cast<size_t>(y) * m_mapSize + x];
+        if (tile != TileMap::EmptyTile)
+        {
+            m_batch.drawFrame(m_frames[tile - 1],
+                {static_cast<float>(x * TileSize), static_cast<float>(y * TileSize)},
+                Color::White, {1.f, 1.f}, {0, 0}, 0, 0);
+        }
+    }
+
+    ArgParser m_args;
+    SpriteBatch2D m_batch;
+    TileMap m_map;
+    Camera2D m_camera;
+    Texture2D m_texture;
+    Frame m_frames[TilesetSize];
+    vector<uint16> m_tiles;
+    size_t m_modeIndex = 0;
+    int m_frame = 0;
+    int m_mapSize = 0;
+    int m_framesPerMode = 0;
+    double m_seconds = 0;
+    size_t m_bytes = 0;
+};
+
+int main(int argc, char *argv[])
+{
+    TileMapBench bench(argc, argv);
+    return bench.run(argc, argv);
+}
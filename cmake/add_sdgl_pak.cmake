@@ -0,0 +1,52 @@
+set(SDGL_PAK_EXECUTABLE "" CACHE FILEPATH "Host sdgl_pak to use instead of building it, e.g. for Emscripten builds")
+
+# Pack a folder of assets into a .pak archive in a target's binary directory, repacked when any of the listed files
+# change (without FILES the whole folder is packed, but only once). Mount it at runtime with io::mount.
+function(add_sdgl_pak)
+    set(oneValueArgs TARGET FOLDER OUTPUT) # OUTPUT is the archive name, default: <FOLDER>.pak
+    set(multiValueArgs FILES)
+    cmake_parse_arguments(ARG "" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
+    if (ARG_TARGET)
+        set(TARGET ${ARG_TARGET})
+    else()
+        set(TARGET ${PROJECT_NAME})
+    endif()
+
+    if (NOT ARG_OUTPUT)
+        set(ARG_OUTPUT "${ARG_FOLDER}.pak")
+    endif()
+
+    if (SDGL_PAK_EXECUTABLE)
+        set(PACKER ${SDGL_PAK_EXECUTABLE})
+    elseif (TARGET sdgl_pak)
+        set(PACKER $<TARGET_FILE:sdgl_pak>)
+    else()
+        message(FATAL_ERROR "add_sdgl_pak needs the sdgl_pak tool: configure with -DSDGL_BUILD_TOOLS=ON, "
+            "or set SDGL_PAK_EXECUTABLE to a host build of it")
+    endif()
+
+    get_target_property(BINARY_DIR ${TARGET} BINARY_DIR)
+    set(LOCAL_ASSET_DIR ${CMAKE_CURRENT_SOURCE_DIR}/${ARG_FOLDER})
+    set(PAK_PATH ${BINARY_DIR}/${ARG_OUTPUT})
+
+    set(DEPENDENCIES "")
+    foreach(FILE ${ARG_FILES})
+        list(APPEND DEPENDENCIES ${LOCAL_ASSET_DIR}/${FILE})
+    endforeach()
+    if (TARGET sdgl_pak AND NOT SDGL_PAK_EXECUTABLE)
+        list(APPEND DEPENDENCIES sdgl_pak)
+    endif()
+
+    add_custom_command(OUTPUT ${PAK_PATH}
+        COMMAND ${PACKER} ${PAK_PATH} ${LOCAL_ASSET_DIR} ${ARG_FILES}
+        DEPENDS ${DEPENDENCIES}
+        COMMENT "Packing ${ARG_OUTPUT}"
+        VERBATIM)
+    string(MAKE_C_IDENTIFIER "${TARGET}_${ARG_OUTPUT}" PAK_TARGET)
+    add_custom_target(${PAK_TARGET} DEPENDS ${PAK_PATH})
+    add_dependencies(${TARGET} ${PAK_TARGET})
+
+    if (EMSCRIPTEN)
+        target_link_options(${TARGET} PRIVATE "SHELL:--preload-file ${PAK_PATH}@${ARG_OUTPUT}")
+    endif()
+endfunction()
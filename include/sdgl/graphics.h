@@ -6,9 +6,15 @@
 #include <sdgl/graphics/atlas/TextureAtlas.h>
 #include <sdgl/graphics/font/BitmapFont.h>
 #include <sdgl/graphics/font/FontText.h>
+#include <sdgl/graphics/GLState.h>
+#include <sdgl/graphics/RenderCommandBuffer.h>
 #include <sdgl/graphics/RenderProgram.h>
+#include <sdgl/graphics/RenderStatsPlugin.h>
+#include <sdgl/graphics/RenderThread.h>
 #include <sdgl/graphics/Shader.h>
 #include <sdgl/graphics/ShaderAttribs.h>
 #include <sdgl/graphics/SpriteBatchBase2D.h>
 #include <sdgl/graphics/SpriteBatch2D.h>
+#include <sdgl/graphics/StaticSpriteBatch2D.h>
 #include <sdgl/graphics/Texture2D.h>
+#include <sdgl/graphics/TileMap.h>
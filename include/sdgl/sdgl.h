@@ -11,6 +11,7 @@
 #include <sdgl/Camera2D.h>
 #include <sdgl/ContentManager.h>
 #include <sdgl/Delegate.h>
+#include <sdgl/ThreadPool.h>
 
 #include <sdgl/core/Window.h>
 
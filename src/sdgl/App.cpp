@@ -2,6 +2,7 @@
 
 #include <sdgl/platform.h>
 #include <sdgl/core/backend/Backend.h>
+#include <sdgl/graphics/GLState.h>
 #include <sdgl/logging.h>
 #include <angles.h>
 
@@ -10,9 +11,10 @@
 namespace sdgl {
     struct App::Impl {
         Impl(Backend *backend, string title, int width, int height, WindowInit::Flags flags,
-          PluginConfig plugins) :
+          PluginConfig plugins, bool useRenderThread) :
             backend(backend), title(std::move(title)), width(width), height(height),
-            flags(flags), plugins(std::move(plugins)), window(nullptr), args(), audio(), currentTime(), lastFrameTime()
+            flags(flags), plugins(std::move(plugins)), window(nullptr), args(), audio(), currentTime(), lastFrameTime(),
+            useRenderThread(useRenderThread), renderThread()
         {}
 
         Backend *backend;
@@ -26,12 +28,18 @@ namespace sdgl {
         AudioEngine audio;
 
         double currentTime, lastFrameTime;
+
+        bool useRenderThread;
+        RenderThread renderThread;
     };
 
     App::App(const string &title, const int width, const int height,
-             const WindowInit::Flags flags, const PluginConfig &plugins) :
-        m(new Impl(new Backend, title, width, height, flags, plugins))
+             const WindowInit::Flags flags, const PluginConfig &plugins, const bool useRenderThread) :
+        m(new Impl(new Backend, title, width, height, flags, plugins, useRenderThread))
     {
+#ifdef SDGL_PLATFORM_EMSCRIPTEN
+        m->useRenderThread = false; // no threads to render from
+#endif
     }
 
     App::~App()
@@ -92,6 +100,19 @@ namespace sdgl {
             return ErrorCode::AppInitError;
         }
 
+        if (m->useRenderThread)
+        {
+            if (!m->renderThread.start(window))
+            {
+                shutdown();
+                m->audio.shutdown();
+                be->destroyWindow(window);
+                be->shutdown();
+                return ErrorCode::RenderThreadError;
+            }
+            SDGL_LOG("Render thread started");
+        }
+
         SDGL_LOG("App initialized, entering main loop");
 
 #ifdef SDGL_PLATFORM_EMSCRIPTEN
@@ -106,6 +127,7 @@ namespace sdgl {
     SDGL_EMSCRIPTEN_MAINLOOP_END
 #endif
 
+        m->renderThread.stop(); // resources are released on this thread
         shutdown();
 
         m->audio.shutdown();
@@ -124,6 +146,12 @@ namespace sdgl {
         m->lastFrameTime = m->currentTime;
         m->currentTime = m->backend->getAppTime();
 
+        if (m->renderThread.isRunning())
+        {
+            runOneThreadedFrame();
+            return;
+        }
+
         window->startFrame();
         update();
         m->audio.update();
@@ -134,9 +162,41 @@ namespace sdgl {
         window->render(); // future: to give control over plugin render order vs app render, make call to render a
         // window render plugin with 0 priority, or modify callbacks
         // startRender / endRender like startFrame / endFrame
+        GLState::invalidate(); // plugins may have changed bindings with raw GL calls
         window->swapBuffers();
     }
 
+    void App::runOneThreadedFrame()
+    {
+        const auto window = m->window;
+        auto &renderThread = m->renderThread;
+
+        // User plugins may touch GL when starting a frame, or rebuild what the last frame still renders, so they start
+        // on the render thread once it's done with the last frame. ImGui renders from a copy of its draw data made at
+        // the end of each frame, so it starts right away and the update overlaps the last frame's execution.
+        if (!m->plugins.plugins.empty())
+            renderThread.invokeSync([window] { window->startFrame(); });
+        else
+            window->startFrame();
+        update();
+        m->audio.update();
+        window->endFrame();
+
+        // record this frame, which executes while the next one updates
+        render();
+        renderThread.commands().invoke([window] {
+            window->render();
+            GLState::invalidate(); // plugins may have changed bindings with raw GL calls
+            window->swapBuffers();
+        });
+        renderThread.submit();
+    }
+
+    RenderThread *App::renderThread() const
+    {
+        return m->useRenderThread ? &m->renderThread : nullptr;
+    }
+
     void App::quit()
     {
         m->window->setShouldClose(true);
@@ -1,6 +1,7 @@
 #pragma once
 #include <sdgl/core/Window.h>
 #include <sdgl/audio/AudioEngine.h>
+#include <sdgl/graphics/RenderThread.h>
 
 namespace sdgl {
 
@@ -12,7 +13,8 @@ namespace sdgl {
             int width,                                     ///< Initial window width
             int height,                                    ///< Initial window height
             WindowInit::Flags flags = WindowInit::None,   ///< Window flags
-            const PluginConfig &plugins = {.imgui=true}    ///< Window plugin configuration
+            const PluginConfig &plugins = {.imgui=true},   ///< Window plugin configuration
+            bool useRenderThread = false                   ///< Whether to submit GL work from a dedicated thread
         );
         virtual ~App();
 
@@ -31,6 +33,13 @@ namespace sdgl {
 
         AudioEngine *audio();
 
+        /// Get the render thread that owns the GL context once `init` returns, or nullptr if the app was created
+        /// without one (or the platform doesn't support threads). Pass it to `SpriteBatchBase2D::setRenderThread` in
+        /// `init` so that batches are recorded during `render` and executed while the next frame updates. Other GL
+        /// calls made after `init` must be recorded via `RenderThread::commands` or run via `RenderThread::invokeSync`.
+        [[nodiscard]]
+        RenderThread *renderThread() const;
+
         /// Get the time, in seconds, since the windowing library was initialized
         [[nodiscard]]
         double getTime() const;
@@ -54,6 +63,8 @@ namespace sdgl {
                 AudioInitError,
                 /// Application subclass failed to init
                 AppInitError,
+                /// Render thread failed to start
+                RenderThreadError,
             };
         };
     protected:
@@ -63,6 +74,8 @@ namespace sdgl {
         virtual void shutdown() = 0;
     private:
         void runOneFrame();
+        /// Frame of the render thread mode: update here, then record and hand GL work over to the render thread
+        void runOneThreadedFrame();
         struct Impl;
         Impl *m;
     };
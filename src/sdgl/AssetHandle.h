@@ -0,0 +1,36 @@
+#pragma once
+#include "sdglib.h"
+
+namespace sdgl {
+    class ContentManager;
+
+    /// Typed reference to an asset held by a `ContentManager`: a slot index plus the generation of the slot when the
+    /// handle was acquired. Once the asset is unloaded its slot's generation advances, so the handle goes stale and
+    /// `ContentManager::get` returns null instead of a dangling pointer. Reloading an asset in place keeps its handles
+    /// valid. Handles are plain values; acquiring and releasing them counts references in the manager.
+    template <typename T>
+    class AssetHandle {
+    public:
+        /// Null handle, never valid
+        AssetHandle() : m_index(), m_generation() { }
+
+        [[nodiscard]]
+        uint index() const { return m_index; }
+
+        /// Generation of the slot when the handle was acquired, 0 for a null handle
+        [[nodiscard]]
+        uint generation() const { return m_generation; }
+
+        /// Whether the handle was acquired; it may still be stale, see `ContentManager::isValid`
+        explicit operator bool() const { return m_generation != 0; }
+
+        bool operator==(const AssetHandle &other) const = default;
+
+    private:
+        friend class ContentManager;
+        AssetHandle(uint index, uint generation) : m_index(index), m_generation(generation) { }
+
+        uint m_index;
+        uint m_generation;
+    };
+}
@@ -3,6 +3,8 @@
 #include <glm/ext/matrix_clip_space.hpp>
 #include <glm/ext/matrix_transform.hpp>
 
+#include <algorithm>
+
 namespace sdgl {
     struct Camera2D::Impl
     {
@@ -125,11 +127,24 @@ namespace sdgl {
 
     FRectangle Camera2D::getWorldBounds() const
     {
+        m->updateMatrix(); // clears cached bounds if the camera changed
+
         if (!m->worldBounds)
         {
-            auto worldPos = viewToWorld(Vector2::Zero);
-            auto worldSize = viewToWorld({(float)m->viewport.w, (float)m->viewport.h});;
-            m->worldBounds = FRectangle(worldPos.x, worldPos.y, worldSize.x - worldPos.x, worldSize.y - worldPos.y);
+            // each corner of the view, which may be rotated in the world
+            const auto w = (float)m->viewport.w, h = (float)m->viewport.h;
+            const Vector2 corners[] = {
+                viewToWorld(Vector2::Zero), viewToWorld({w, 0}), viewToWorld({0, h}), viewToWorld({w, h})
+            };
+
+            auto min = corners[0], max = corners[0];
+            for (const auto &corner : corners)
+            {
+                min = {std::min(min.x, corner.x), std::min(min.y, corner.y)};
+                max = {std::max(max.x, corner.x), std::max(max.y, corner.y)};
+            }
+
+            m->worldBounds = FRectangle(min.x, min.y, max.x - min.x, max.y - min.y);
         }
 
         return m->worldBounds.value();
@@ -67,8 +67,8 @@ namespace sdgl {
         [[nodiscard]]
         Vector2 worldToView(Vector2 worldCoords) const;
 
-        /// FIXME: doesn't take rotation into account; it probably will need to use a point for each corner to
-        /// represent non-axis aligned rect
+        /// Get the axis-aligned area of the world that is visible in the viewport. When the camera is rotated, this
+        /// is the smallest rectangle that contains the rotated view.
         [[nodiscard]]
         FRectangle getWorldBounds() const;
     private:
@@ -1,86 +1,810 @@
 #include "ContentManager.h"
+#include "ThreadPool.h"
 
+#include "assert.h"
 #include "graphics/atlas/TextureAtlas.h"
 #include "graphics/font/BitmapFont.h"
+#include "graphics/RenderThread.h"
+#include "io/FileWatcher.h"
+#include "io/io.h"
+#include "io/MappedFile.h"
+#include "logging.h"
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
 
 namespace sdgl {
+    /// Texture read and decoded by a worker thread, waiting to be uploaded by `ContentManager::update`
+    struct ContentManager::TextureLoad
+    {
+        TextureLoad(Texture2D *texture, fs::path path, const TextureFilter::Enum filter, const bool reload) :
+            texture(texture), path(std::move(path)), filter(filter), reload(reload), cancelled(false),
+            pixels(nullptr, stbi_image_free), width(0), height(0), file()
+        { }
+
+        Texture2D *texture;           ///< cached texture to swap the image into, only touched on the GL thread
+        fs::path path;
+        TextureFilter::Enum filter;
+        bool reload;                  ///< texture shows its previous image instead of the placeholder meanwhile
+        std::atomic<bool> cancelled;  ///< set when the texture was unloaded before the upload
+        std::unique_ptr<stbi_uc, void(*)(void *)> pixels; ///< RGBA8888, null if reading or decoding failed
+        int width, height;
+        io::MappedFile file;          ///< SBC IMG file, kept mapped to upload in place instead of decoding
+    };
+
+    ContentManager::ContentManager() : onTextureChanged(), m_slots(), m_freeSlots(), m_lookup(), m_loads(), m_decoded(),
+        m_decodedMutex(), m_placeholder(), m_defaultPlaceholder(), m_failedLoads(), m_workers(), m_residency(), m_lru(),
+        m_residentBytes(0), m_textureBudget(0), m_frame(0), m_watcher(), m_watchedFiles(), m_watchedPages()
+    {
+    }
+
     ContentManager::~ContentManager()
     {
+        // let in-flight decodes finish, discarding queued ones
+        m_workers.reset();
+
         // clean up any remaining assets
         unloadAll();
     }
 
+    /// Whether a file was converted to SBC content, which loads in place
+    static bool isSbc(const fs::path &filepath)
+    {
+        return filepath.extension() == ".sbc";
+    }
+
+    /// Load a texture file on the calling thread
+    static bool loadTextureFile(Texture2D *texture, const fs::path &filepath, const TextureFilter::Enum filter)
+    {
+        return isSbc(filepath) ? texture->loadSbc(filepath, filter) : texture->loadFile(filepath, filter);
+    }
+
+    template<typename T>
+    T *ContentManager::checkCache(const fs::path &filepath, uint *outIndex)
+    {
+        *outIndex = NoSlot;
+        const auto it = m_lookup.find(filepath.native());
+        if (it == m_lookup.end())
+            return nullptr;
+
+        const auto asset = dynamic_cast<T *>(m_slots[it->second].asset);
+        if (asset)
+            *outIndex = it->second;
+        else
+            SDGL_ERROR("\"{}\" is already loaded as another type of asset", filepath);
+        return asset;
+    }
+
     const Texture2D *ContentManager::loadTexture(const fs::path &filepath)
     {
-        if (const auto cached = checkCache<Texture2D>(filepath))
-            return cached;
+        return pinSlot<Texture2D>(loadTextureSlot(filepath));
+    }
+
+    const Texture2D *ContentManager::loadTextureAsync(const fs::path &filepath, const TextureFilter::Enum filter)
+    {
+        return pinSlot<Texture2D>(loadTextureAsyncSlot(filepath, filter));
+    }
+
+    TextureHandle ContentManager::acquireTexture(const fs::path &filepath)
+    {
+        return acquireSlot<Texture2D>(loadTextureSlot(filepath));
+    }
+
+    TextureHandle ContentManager::acquireTextureAsync(const fs::path &filepath, const TextureFilter::Enum filter)
+    {
+        return acquireSlot<Texture2D>(loadTextureAsyncSlot(filepath, filter));
+    }
+
+    BitmapFontHandle ContentManager::acquireBitmapFont(const fs::path &filepath)
+    {
+        return acquireSlot<BitmapFont>(loadBitmapFontSlot(filepath));
+    }
+
+    TextureAtlasHandle ContentManager::acquireTextureAtlas(const fs::path &filepath)
+    {
+        return acquireSlot<TextureAtlas>(loadTextureAtlasSlot(filepath));
+    }
+
+    uint ContentManager::loadTextureSlot(const fs::path &filepath)
+    {
+        uint index;
+        if (const auto cached = checkCache<Texture2D>(filepath, &index))
+        {
+            useTexture(cached);
+            return index;
+        }
+
+        if (m_lookup.contains(filepath.native()))
+            return NoSlot;
+
+        const auto filter = Texture2D::getDefaultFilter();
         auto texture = new Texture2D();
-        if (!texture->loadFile(filepath))
+        if (!loadTextureFile(texture, filepath, filter))
         {
             delete texture;
-            return nullptr;
+            return NoSlot;
+        }
+
+        index = addSlot(filepath, texture);
+        trackTexture(texture, filepath, filter, false);
+        evictTexturesMidFrame();
+        return index;
+    }
+
+    uint ContentManager::loadTextureAsyncSlot(const fs::path &filepath, const TextureFilter::Enum filter)
+    {
+        uint index;
+        if (const auto cached = checkCache<Texture2D>(filepath, &index))
+        {
+            useTexture(cached);
+            return index;
+        }
+
+        if (m_lookup.contains(filepath.native()))
+            return NoSlot;
+
+        auto texture = new Texture2D();
+        if (!queueTextureLoad(texture, filepath, filter))
+        {
+            delete texture;
+            return NoSlot;
+        }
+
+        index = addSlot(filepath, texture);
+        trackTexture(texture, filepath, filter, true);
+        return index;
+    }
+
+    bool ContentManager::queueTextureLoad(Texture2D *texture, const fs::path &filepath,
+        const TextureFilter::Enum filter)
+    {
+        if (!m_placeholder.id())
+        {
+            if (!m_defaultPlaceholder.id() &&
+                !m_defaultPlaceholder.loadBytes(vector<Color>{Color(0, 0, 0, 0)}, 1, 1, TextureFilter::Nearest))
+            {
+                return false;
+            }
+
+            m_placeholder = m_defaultPlaceholder;
+        }
+
+        const auto placeholderSize = m_placeholder.size();
+        *texture = Texture2D(m_placeholder.id(), placeholderSize.x, placeholderSize.y);
+
+        decodeTexture(texture, filepath, filter, false);
+        return true;
+    }
+
+    void ContentManager::decodeTexture(Texture2D *texture, const fs::path &filepath, const TextureFilter::Enum filter,
+        const bool reload)
+    {
+        if (!m_workers)
+            m_workers = std::make_unique<ThreadPool>();
+
+        auto load = std::make_shared<TextureLoad>(texture, filepath, filter, reload);
+        m_loads[filepath.native()] = load;
+
+        m_workers->push([this, load] {
+            if (load->cancelled)
+                return;
+
+            if (io::MappedFile file; file.open(load->path))
+            {
+                // SBC images need no decoding, their mip chain is uploaded straight from the mapping
+                if (isSbc(load->path))
+                {
+                    load->file = std::move(file);
+                    std::lock_guard lock(m_decodedMutex);
+                    m_decoded.emplace_back(load);
+                    return;
+                }
+
+                int width, height, channels;
+                load->pixels.reset(stbi_load_from_memory(
+                    file.data().data(),
+                    static_cast<int>(file.size()),
+                    &width, &height, &channels, STBI_rgb_alpha));
+
+                if (load->pixels)
+                {
+                    load->width = width;
+                    load->height = height;
+                }
+                else
+                {
+                    SDGL_ERROR("stb_image failed to load image \"{}\": {}", load->path, stbi_failure_reason());
+                }
+            }
+
+            std::lock_guard lock(m_decodedMutex);
+            m_decoded.emplace_back(load);
+        });
+    }
+
+    int ContentManager::update(const double budget)
+    {
+        SDGL_ASSERT(RenderThread::isRenderThread(), "ContentManager::update must be called on the GL thread");
+        if (m_watcher)
+            reloadChanged();
+
+        // textures used last frame are protected, then a new frame starts
+        evictTextures(m_frame);
+        ++m_frame;
+
+        return uploadTextures(budget);
+    }
+
+    int ContentManager::uploadTextures(const double budget)
+    {
+        SDGL_ASSERT(RenderThread::isRenderThread(), "Textures must be uploaded on the GL thread");
+        const auto start = std::chrono::steady_clock::now();
+
+        int uploaded = 0;
+        while (true)
+        {
+            std::shared_ptr<TextureLoad> load;
+            {
+                std::lock_guard lock(m_decodedMutex);
+                if (m_decoded.empty())
+                    break;
+
+                load = std::move(m_decoded.front());
+                m_decoded.pop_front();
+            }
+
+            if (load->cancelled)
+                continue;
+
+            m_loads.erase(load->path.native());
+
+            // the image is uploaded beside the placeholder, which isn't deleted, and only swapped in once it loaded;
+            // a failed load keeps showing the placeholder, while a failed reload keeps the previous image
+            const auto texture = load->texture;
+            auto image = load->reload ? *texture : Texture2D();
+            const auto previousId = image.id();
+            const auto loaded = load->file.isOpen() ? image.loadSbcMem(load->file.data(), load->filter) :
+                load->pixels && image.loadBytes(load->pixels.get(),
+                    static_cast<size_t>(load->width) * load->height * 4, load->width, load->height, load->filter);
+            if (loaded)
+            {
+                SDGL_ASSERT(!previousId || image.id() == previousId, "Reloaded texture should keep its GL id");
+                *texture = image;
+                m_failedLoads.erase(texture);
+                if (previousId)
+                    onTextureChanged(previousId, *texture);
+                if (const auto it = m_residency.find(texture); it != m_residency.end())
+                {
+                    setResident(it->second);
+                }
+                else // the file was fixed after failing to load
+                {
+                    trackTexture(texture, load->path, load->filter, true);
+                    setResident(m_residency.at(texture));
+                }
+            }
+            else if (load->reload)
+            {
+                SDGL_ERROR("Failed to reload texture \"{}\", keeping its previous image", load->path);
+            }
+            else
+            {
+                SDGL_ERROR("Failed to load texture \"{}\" in the background, showing the placeholder", load->path);
+                untrackTexture(texture); // don't retry a broken file on each use
+                m_failedLoads.insert(texture);
+            }
+            load->pixels.reset();
+            load->file = io::MappedFile();
+            ++uploaded;
+
+            const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+            if (elapsed.count() >= budget)
+                break;
+        }
+
+        return uploaded;
+    }
+
+    void ContentManager::finishLoading()
+    {
+        if (m_workers)
+            m_workers->wait();
+
+        uploadTextures(std::numeric_limits<double>::infinity());
+    }
+
+    bool ContentManager::isLoading(const fs::path &filepath) const
+    {
+        return m_loads.contains(filepath.native());
+    }
+
+    void ContentManager::setTextureBudget(const size_t bytes)
+    {
+        m_textureBudget = bytes;
+        evictTexturesMidFrame();
+    }
+
+    bool ContentManager::useTexture(const Texture2D *texture)
+    {
+        const auto it = m_residency.find(texture);
+        if (it == m_residency.end())
+            return texture && texture->id() && !m_failedLoads.contains(texture);
+
+        auto &residency = it->second;
+        if (!residency.resident && !isLoading(residency.path) && !reloadTexture(residency))
+            return false;
+
+        touchTexture(residency);
+        return true;
+    }
+
+    bool ContentManager::setEvictable(const Texture2D *texture, const bool evictable)
+    {
+        const auto it = m_residency.find(texture);
+        if (it == m_residency.end())
+            return false;
+
+        auto &residency = it->second;
+        residency.evictable = evictable;
+        if (evictable)
+        {
+            // counts as a use, so the texture isn't evicted before the caller could mark it used
+            touchTexture(residency);
+            evictTexturesMidFrame();
+        }
+        return true;
+    }
+
+    bool ContentManager::isEvicted(const Texture2D *texture) const
+    {
+        const auto it = m_residency.find(texture);
+        return it != m_residency.end() && !it->second.resident && !isLoading(it->second.path);
+    }
+
+    void ContentManager::trackTexture(Texture2D *texture, const fs::path &filepath,
+        const TextureFilter::Enum filter, const bool async)
+    {
+        auto &residency = m_residency[texture];
+        residency = {
+            .texture = texture,
+            .path = filepath,
+            .filter = filter,
+            .async = async,
+            .evictable = false,
+            .resident = false,
+            .bytes = 0,
+            .lastUsed = m_frame,
+            .lru = m_lru.end(),
+        };
+
+        if (!async)
+            setResident(residency);
+    }
+
+    void ContentManager::untrackTexture(const Texture2D *texture)
+    {
+        const auto it = m_residency.find(texture);
+        if (it == m_residency.end())
+            return;
+
+        if (it->second.resident)
+        {
+            m_residentBytes -= it->second.bytes;
+            m_lru.erase(it->second.lru);
+        }
+
+        m_residency.erase(it);
+    }
+
+    void ContentManager::setResident(TextureResidency &residency)
+    {
+        if (residency.resident)
+        {
+            m_residentBytes -= residency.bytes;
+            m_lru.erase(residency.lru);
+        }
+
+        // an upload counts as a use, which keeps `m_lru` ordered by `lastUsed`
+        residency.resident = true;
+        residency.lastUsed = m_frame;
+        residency.bytes = residency.texture->byteSize();
+        residency.lru = m_lru.insert(m_lru.end(), residency.texture);
+        m_residentBytes += residency.bytes;
+    }
+
+    void ContentManager::touchTexture(TextureResidency &residency)
+    {
+        residency.lastUsed = m_frame;
+        if (residency.resident)
+            m_lru.splice(m_lru.end(), m_lru, residency.lru);
+    }
+
+    bool ContentManager::reloadTexture(TextureResidency &residency)
+    {
+        if (residency.async)
+            return queueTextureLoad(residency.texture, residency.path, residency.filter);
+
+        if (!loadTextureFile(residency.texture, residency.path, residency.filter))
+        {
+            SDGL_ERROR("Failed to reload evicted texture \"{}\"", residency.path);
+            return false;
+        }
+
+        setResident(residency);
+        evictTexturesMidFrame();
+        return true;
+    }
+
+    void ContentManager::evictTextures(const uint64 keepFrom)
+    {
+        SDGL_ASSERT(RenderThread::isRenderThread(), "Textures must be evicted on the GL thread");
+        if (m_textureBudget == 0)
+            return;
+
+        // `m_lru` is ordered by last use, so once a texture used since `keepFrom` is reached, the rest were too
+        for (auto it = m_lru.begin(); m_residentBytes > m_textureBudget && it != m_lru.end(); )
+        {
+            auto &residency = m_residency.at(*it);
+            if (residency.lastUsed >= keepFrom)
+                break;
+
+            if (!residency.evictable)
+            {
+                ++it;
+                continue;
+            }
+
+            it = m_lru.erase(it);
+            m_residentBytes -= residency.bytes;
+            const auto id = residency.texture->id();
+            residency.texture->unload();
+            onTextureChanged(id, *residency.texture);
+            residency.resident = false;
+            residency.bytes = 0;
         }
+    }
 
-        m_cache[filepath] = texture;
-        return texture;
+    bool ContentManager::cancelLoad(const fs::path::string_type &key)
+    {
+        const auto it = m_loads.find(key);
+        if (it == m_loads.end())
+            return false;
+
+        it->second->cancelled = true;
+        const auto showsPlaceholder = !it->second->reload;
+        m_loads.erase(it);
+        return showsPlaceholder;
+    }
+
+    bool ContentManager::watchForChanges(const double debounce)
+    {
+        stopWatching();
+
+        auto watcher = std::make_unique<io::FileWatcher>();
+        if (!watcher->open(io::getResourcePath(), debounce))
+            return false;
+
+        m_watcher = std::move(watcher);
+        for (uint i = 0; i < m_slots.size(); ++i)
+        {
+            if (m_slots[i].asset)
+                watchSlot(i);
+        }
+
+        return true;
+    }
+
+    void ContentManager::stopWatching()
+    {
+        m_watcher.reset();
+        m_watchedFiles.clear();
+        m_watchedPages.clear();
+    }
+
+    fs::path::string_type ContentManager::getWatchKey(const fs::path &filepath)
+    {
+        return fs::absolute(filepath.is_absolute() ? filepath : io::getResourcePath() / filepath)
+            .lexically_normal().native();
+    }
+
+    void ContentManager::watchSlot(const uint index)
+    {
+        const auto &slot = m_slots[index];
+        m_watchedFiles[getWatchKey(*slot.path)] = index;
+
+        // pages are loaded from their own files
+        const vector<string> *pageFiles = nullptr;
+        if (const auto atlas = dynamic_cast<const TextureAtlas *>(slot.asset))
+            pageFiles = &atlas->pageFiles();
+        else if (const auto font = dynamic_cast<const BitmapFont *>(slot.asset))
+            pageFiles = &font->pageFiles();
+
+        if (pageFiles)
+        {
+            for (const auto &pageFile : *pageFiles)
+                m_watchedPages.emplace(getWatchKey(pageFile), index);
+        }
+    }
+
+    void ContentManager::unwatchSlot(const uint index)
+    {
+        const auto key = getWatchKey(*m_slots[index].path);
+        if (const auto it = m_watchedFiles.find(key); it != m_watchedFiles.end() && it->second == index)
+            m_watchedFiles.erase(it);
+
+        // pages may have changed since they were watched
+        std::erase_if(m_watchedPages, [index](const auto &page) { return page.second == index; });
+    }
+
+    void ContentManager::reloadChanged()
+    {
+        vector<fs::path> changed;
+        if (m_watcher->poll(&changed) == 0)
+            return;
+
+        // an atlas or font may have several of its files change at once, reload it once
+        vector<uint> slots;
+        for (const auto &path : changed)
+        {
+            if (const auto it = m_watchedFiles.find(path.native()); it != m_watchedFiles.end())
+                slots.emplace_back(it->second);
+
+            const auto [first, last] = m_watchedPages.equal_range(path.native());
+            for (auto it = first; it != last; ++it)
+                slots.emplace_back(it->second);
+        }
+
+        std::sort(slots.begin(), slots.end());
+        slots.erase(std::unique(slots.begin(), slots.end()), slots.end());
+        for (const auto index : slots)
+            reloadChangedSlot(index);
+    }
+
+    void ContentManager::reloadChangedSlot(const uint index)
+    {
+        const auto &slot = m_slots[index];
+        const fs::path filepath(*slot.path);
+
+        // textures are read, and images decoded, in the background
+        const auto texture = dynamic_cast<Texture2D *>(slot.asset);
+        if (!texture)
+        {
+            reloadSlot(index);
+            return;
+        }
+
+        const auto residency = m_residency.find(texture);
+        if (residency != m_residency.end() && !residency->second.resident && !isLoading(filepath))
+            return; // evicted, the new file is loaded when next used
+
+        const auto filter = (residency != m_residency.end()) ? residency->second.filter : Texture2D::getDefaultFilter();
+
+        // a pending load would upload the previous file
+        const auto showsPlaceholder = cancelLoad(*slot.path) || m_failedLoads.contains(texture);
+        decodeTexture(texture, filepath, filter, !showsPlaceholder);
+    }
+
+    /// Load a bitmap font file in place
+    static bool loadBitmapFontFile(BitmapFont *font, const fs::path &filepath)
+    {
+        return isSbc(filepath) ? font->loadSbc(filepath) : font->loadBMFont(filepath);
+    }
+
+    /// Load a texture atlas file in place
+    static bool loadTextureAtlasFile(TextureAtlas *atlas, const fs::path &filepath)
+    {
+        return isSbc(filepath) ? atlas->loadSbc(filepath) : atlas->loadCrunch(filepath);
     }
 
     const BitmapFont *ContentManager::loadBitmapFont(const fs::path &filepath)
     {
-        if (const auto cached = checkCache<BitmapFont>(filepath))
-            return cached;
+        return pinSlot<BitmapFont>(loadBitmapFontSlot(filepath));
+    }
+
+    const TextureAtlas *ContentManager::loadTextureAtlas(const fs::path &filepath)
+    {
+        return pinSlot<TextureAtlas>(loadTextureAtlasSlot(filepath));
+    }
+
+    uint ContentManager::loadBitmapFontSlot(const fs::path &filepath)
+    {
+        uint index;
+        if (checkCache<BitmapFont>(filepath, &index) || m_lookup.contains(filepath.native()))
+            return index;
+
         auto font = new BitmapFont();
-        if (!font->loadBMFont(filepath))
+        if (!loadBitmapFontFile(font, filepath))
         {
             delete font;
-            return nullptr;
+            return NoSlot;
         }
 
-        m_cache[filepath] = font;
-        return font;
+        return addSlot(filepath, font);
     }
 
-    const TextureAtlas *ContentManager::loadTextureAtlas(const fs::path &filepath)
+    uint ContentManager::loadTextureAtlasSlot(const fs::path &filepath)
     {
-        if (const auto cached = checkCache<TextureAtlas>(filepath))
-            return cached;
+        uint index;
+        if (checkCache<TextureAtlas>(filepath, &index) || m_lookup.contains(filepath.native()))
+            return index;
+
         auto atlas = new TextureAtlas();
-        if (!atlas->loadCrunch(filepath))
+        if (!loadTextureAtlasFile(atlas, filepath))
         {
             delete atlas;
-            return nullptr;
+            return NoSlot;
+        }
+
+        return addSlot(filepath, atlas);
+    }
+
+    uint ContentManager::addSlot(const fs::path &filepath, Asset *asset)
+    {
+        uint index;
+        if (m_freeSlots.empty())
+        {
+            index = static_cast<uint>(m_slots.size());
+            m_slots.push_back({nullptr, nullptr, 1, 0, false});
+        }
+        else
+        {
+            index = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+
+        const auto key = m_lookup.try_emplace(filepath.native(), index).first;
+
+        auto &slot = m_slots[index];
+        slot.asset = asset;
+        slot.path = &key->first;
+        slot.refCount = 0;
+        slot.pinned = false;
+
+        if (m_watcher)
+            watchSlot(index);
+        return index;
+    }
+
+    void ContentManager::freeSlot(const uint index)
+    {
+        auto &slot = m_slots[index];
+        if (m_watcher)
+            unwatchSlot(index);
+
+        // a texture still loading, or whose load failed, only shows the placeholder
+        auto showsPlaceholder = cancelLoad(*slot.path);
+        if (const auto texture = dynamic_cast<Texture2D *>(slot.asset))
+        {
+            untrackTexture(texture);
+            showsPlaceholder |= m_failedLoads.erase(texture) > 0;
+        }
+        if (!showsPlaceholder)
+        {
+            if (const auto texture = dynamic_cast<Texture2D *>(slot.asset); texture && texture->id())
+            {
+                const auto id = texture->id();
+                texture->unload();
+                onTextureChanged(id, *texture);
+            }
+            else
+            {
+                slot.asset->unload();
+            }
         }
+        delete slot.asset;
+        m_lookup.erase(m_lookup.find(*slot.path));
 
-        m_cache[filepath] = atlas;
-        return atlas;
+        slot.asset = nullptr;
+        slot.path = nullptr;
+        slot.refCount = 0;
+        slot.pinned = false;
+        if (++slot.generation == 0) // 0 is reserved for null handles
+            slot.generation = 1;
+        m_freeSlots.push_back(index);
+    }
+
+    bool ContentManager::releaseSlot(const uint index, const uint generation)
+    {
+        const auto slot = findSlot(index, generation);
+        if (!slot)
+            return false;
+
+        if (slot->refCount > 0 && --slot->refCount == 0 && !slot->pinned)
+            freeSlot(index);
+        return true;
+    }
+
+    bool ContentManager::reload(const fs::path &filepath)
+    {
+        const auto it = m_lookup.find(filepath.native());
+        return it != m_lookup.end() && reloadSlot(it->second);
+    }
+
+    bool ContentManager::reloadSlot(const uint index)
+    {
+        const auto &slot = m_slots[index];
+        const fs::path filepath(*slot.path);
+
+        if (const auto texture = dynamic_cast<Texture2D *>(slot.asset))
+        {
+            const auto residency = m_residency.find(texture);
+            const auto filter = (residency != m_residency.end()) ?
+                residency->second.filter : Texture2D::getDefaultFilter();
+
+            // a pending background load would overwrite the reload; drop the placeholder without deleting it
+            if (cancelLoad(*slot.path) || m_failedLoads.erase(texture))
+                *texture = Texture2D();
+
+            const auto previousId = texture->id();
+            if (!loadTextureFile(texture, filepath, filter))
+            {
+                SDGL_ERROR("Failed to reload texture \"{}\"", filepath);
+                return false;
+            }
+            SDGL_ASSERT(!previousId || texture->id() == previousId, "Reloaded texture should keep its GL id");
+            if (previousId)
+                onTextureChanged(previousId, *texture);
+
+            if (residency != m_residency.end())
+            {
+                setResident(residency->second);
+                evictTexturesMidFrame();
+            }
+            return true;
+        }
+
+        auto result = false;
+        if (const auto font = dynamic_cast<BitmapFont *>(slot.asset))
+            result = loadBitmapFontFile(font, filepath);
+        else if (const auto atlas = dynamic_cast<TextureAtlas *>(slot.asset))
+            result = loadTextureAtlasFile(atlas, filepath);
+
+        // the reload may have changed which page files it uses
+        if (result && m_watcher)
+        {
+            unwatchSlot(index);
+            watchSlot(index);
+        }
+
+        return result;
     }
 
     bool ContentManager::unload(const fs::path &filepath)
     {
         // See if this container holds this asset in memory
-        auto it = m_cache.find(filepath.native());
-        if (it == m_cache.end())
+        const auto it = m_lookup.find(filepath.native());
+        if (it == m_lookup.end())
         {
             // It doesn't
             return false;
         }
 
         // It does, unload and delete it
-        it->second->unload();
-        delete it->second;
-        m_cache.erase(it);
-
+        freeSlot(it->second);
         return true;
     }
 
     void ContentManager::unloadAll()
     {
-        for (auto &[key, asset] : m_cache)
+        // slots are kept, so their generations keep handles from before stale
+        for (uint i = 0; i < m_slots.size(); ++i)
         {
-            asset->unload();
-            delete asset;
+            if (m_slots[i].asset)
+                freeSlot(i);
         }
 
-        m_cache.clear();
+        m_residency.clear();
+        m_failedLoads.clear();
+        m_lru.clear();
+        m_residentBytes = 0;
+
+        // nothing shows the default placeholder anymore
+        if (m_placeholder.id() == m_defaultPlaceholder.id())
+            m_placeholder = {};
+        m_defaultPlaceholder.unload();
     }
 }
@@ -2,35 +2,227 @@
 #include <sdgl/sdglib.h>
 
 #include "Asset.h"
+#include "AssetHandle.h"
+#include "Delegate.h"
 #include "graphics/Texture2D.h"
 
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
 namespace sdgl {
     // Forward declarations
     class BitmapFont;
     class TextureAtlas;
+    class ThreadPool;
+
+    namespace io {
+        class FileWatcher;
+    }
+
+    using TextureHandle = AssetHandle<Texture2D>;
+    using BitmapFontHandle = AssetHandle<BitmapFont>;
+    using TextureAtlasHandle = AssetHandle<TextureAtlas>;
 
-    /// Manages loading textures, fonts, etc. Caches each asset per filepath
+    /// Manages loading textures, fonts, etc. Caches each asset per filepath in a slot, which can be referred to via
+    /// a pointer, or a generational handle that detects when the asset was unloaded.
+    /// Loading, `update` and unloading make GL calls, so they must run on the GL thread: the running
+    /// `RenderThread`, e.g. via `RenderThread::invokeSync`, or else the thread holding the context. Only image
+    /// decoding for background loads happens on worker threads.
     class ContentManager
     {
     public:
-        ContentManager() : m_cache() { }
+        /// Milliseconds per `update` call spent uploading textures loaded in the background, by default
+        static constexpr double DefaultUploadBudget = 2.0;
+        /// Milliseconds a changed file must go without changes before it's reloaded, by default
+        static constexpr double DefaultReloadDebounce = 100.0;
+
+        ContentManager();
         ~ContentManager();
 
-        /// Load a 2D texture from a .png, .jpg, .tga, .bmp, or .hdr file.
-        /// Make sure to set desired filter type via Texture2D
+        /// Load a 2D texture from a .png, .jpg, .tga, .bmp, .hdr, or SBC IMG .sbc file.
+        /// Make sure to set desired filter type via Texture2D. Requesting a cached texture marks it used this frame,
+        /// and reloads it if it was evicted to stay within the texture budget.
         /// @param filepath path to the image file
         /// @param flags    filter type
         /// @return loaded or cached texture
         const Texture2D *loadTexture(const fs::path &filepath);
 
+        /// Start loading a 2D texture in the background: the file is read, and images decoded, on a worker thread,
+        /// then uploaded by `update`; SBC files upload their mip chain in place. Until then the returned texture
+        /// shows the placeholder; it is swapped in place, so the pointer stays valid. Loading a path that is still
+        /// pending returns the same texture.
+        /// @param filepath path to the image or SBC file
+        /// @param filter   filter to upload the texture with
+        /// @return texture showing the placeholder, or the cached texture if already loaded
+        const Texture2D *loadTextureAsync(const fs::path &filepath,
+            TextureFilter::Enum filter = Texture2D::getDefaultFilter());
+
+        /// Upload textures that finished decoding in the background, and evict textures over the budget that weren't
+        /// used last frame. While watching for changes, it also starts reloading changed assets. Call it once per
+        /// frame on the GL thread (see `RenderThread::isRenderThread`).
+        /// @param budget milliseconds to spend uploading, checked after each texture so at least one is uploaded
+        /// @returns number of textures uploaded
+        int update(double budget = DefaultUploadBudget);
+
+        /// Block until every background load finished and was uploaded
+        void finishLoading();
+
+        /// Whether a texture loaded via `loadTextureAsync` is still waiting for its image data
+        [[nodiscard]]
+        bool isLoading(const fs::path &filepath) const;
+
+        /// Number of background loads that haven't been uploaded yet
+        [[nodiscard]]
+        size_t loadingCount() const { return m_loads.size(); }
+
+        /// Set the texture that textures loading in the background show, not owned by the manager. Only affects
+        /// loads started afterward. By default, a 1x1 transparent texture is used.
+        void setPlaceholder(const Texture2D &placeholder) { m_placeholder = placeholder; }
+
+        /// Set how much GPU memory textures loaded via `loadTexture` and `loadTextureAsync` may use. Past it, the least
+        /// recently used textures made evictable via `setEvictable` are unloaded, unless they were used this frame or
+        /// the one before, which may still be rendering; their pointers stay valid, and they're reloaded from their
+        /// file when next requested or passed to `useTexture`. Other textures count toward the budget but are never
+        /// unloaded. Textures of atlases and fonts aren't managed.
+        /// @param bytes budget in bytes, or 0 for no limit (default)
+        void setTextureBudget(size_t bytes);
+
+        [[nodiscard]]
+        size_t textureBudget() const { return m_textureBudget; }
+
+        /// Estimated GPU memory used by resident textures loaded via `loadTexture` and `loadTextureAsync`
+        [[nodiscard]]
+        size_t residentTextureBytes() const { return m_residentBytes; }
+
+        /// Mark a texture loaded by this manager as used this frame, so it isn't evicted before the next `update`.
+        /// Call it for textures drawn each frame without being requested again. An evicted texture is reloaded.
+        /// @returns whether the texture is resident or loading in the background
+        bool useTexture(const Texture2D *texture);
+
+        /// Let a texture loaded via `loadTexture` or `loadTextureAsync` be unloaded to stay within the texture budget.
+        /// Drawing doesn't mark a texture used, so an evictable texture must be requested or passed to `useTexture`
+        /// each frame it's drawn, and copies of it, e.g. in retained sprite batches, must not outlive its eviction
+        /// (see `onTextureChanged`).
+        /// @returns whether the texture is managed by the texture budget
+        bool setEvictable(const Texture2D *texture, bool evictable = true);
+
+        /// Whether a texture was unloaded to stay within the texture budget
+        [[nodiscard]]
+        bool isEvicted(const Texture2D *texture) const;
+
+        /// Invoked on the GL thread after a texture loaded via `loadTexture` or `loadTextureAsync` is reloaded,
+        /// evicted or unloaded, with its previous GL id. A reload keeps the id but may change the size; otherwise the
+        /// texture's id is now 0 and the old one may be reused. Lets copies kept across frames, e.g. by
+        /// `StaticSpriteBatch2D::textureChanged`, follow the texture.
+        Delegate<uint, const Texture2D &> onTextureChanged;
+
         /// Load a bitmap font
-        /// @param filepath
+        /// @param filepath BMFont binary file, or SBC FNT .sbc file
         /// @return
         const BitmapFont *loadBitmapFont(const fs::path &filepath);
 
+        /// Load a texture atlas
+        /// @param filepath crunch binary file, or SBC ATL .sbc file
         const TextureAtlas *loadTextureAtlas(const fs::path &filepath);
 
-        /// Unload an asset that was previously loaded
+        /// Acquire a handle to a texture, loaded like `loadTexture` if it isn't cached. Each acquired handle holds a
+        /// reference; once the last one is released, the texture is unloaded, unless it was also requested via a
+        /// pointer-returning function, which keeps it until `unload`.
+        /// @returns handle to the texture, or a null handle on failure
+        TextureHandle acquireTexture(const fs::path &filepath);
+
+        /// Acquire a handle to a texture, loaded in the background like `loadTextureAsync` if it isn't cached
+        TextureHandle acquireTextureAsync(const fs::path &filepath,
+            TextureFilter::Enum filter = Texture2D::getDefaultFilter());
+
+        /// Acquire a handle to a bitmap font, loaded like `loadBitmapFont` if it isn't cached
+        BitmapFontHandle acquireBitmapFont(const fs::path &filepath);
+
+        /// Acquire a handle to a texture atlas, loaded like `loadTextureAtlas` if it isn't cached
+        TextureAtlasHandle acquireTextureAtlas(const fs::path &filepath);
+
+        /// Add a reference to the asset of a handle, e.g. when storing a copy of it
+        /// @returns whether the handle is valid
+        template <typename T>
+        bool retain(const AssetHandle<T> handle)
+        {
+            const auto slot = findSlot(handle.m_index, handle.m_generation);
+            if (!slot)
+                return false;
+
+            ++slot->refCount;
+            return true;
+        }
+
+        /// Drop the reference of a handle, unloading the asset if it was the last one and the asset wasn't requested
+        /// via a pointer-returning function. The handle is nulled.
+        /// @returns whether the handle was valid
+        template <typename T>
+        bool release(AssetHandle<T> &handle)
+        {
+            const auto valid = releaseSlot(handle.m_index, handle.m_generation);
+            handle = {};
+            return valid;
+        }
+
+        /// Get the asset of a handle in constant time
+        /// @returns the asset, or null if the handle is null or stale, i.e. the asset was unloaded
+        template <typename T> [[nodiscard]]
+        const T *get(const AssetHandle<T> handle) const
+        {
+            const auto slot = findSlot(handle.m_index, handle.m_generation);
+            return slot ? static_cast<const T *>(slot->asset) : nullptr;
+        }
+
+        /// Whether a handle refers to a loaded asset
+        template <typename T> [[nodiscard]]
+        bool isValid(const AssetHandle<T> handle) const
+        {
+            return findSlot(handle.m_index, handle.m_generation) != nullptr;
+        }
+
+        /// Mark the texture of a handle as used this frame, see `useTexture`
+        bool useTexture(const TextureHandle handle) { return useTexture(get(handle)); }
+
+        /// Let the texture of a handle be unloaded to stay within the texture budget, see `setEvictable`
+        bool setEvictable(const TextureHandle handle, const bool evictable = true)
+        {
+            return setEvictable(get(handle), evictable);
+        }
+
+        /// Reload an asset from its file in place: pointers and handles to it stay valid. If reloading fails, the
+        /// asset keeps its current data.
+        /// @returns whether the asset was reloaded
+        template <typename T>
+        bool reload(const AssetHandle<T> handle)
+        {
+            return findSlot(handle.m_index, handle.m_generation) && reloadSlot(handle.m_index);
+        }
+
+        /// Reload the asset cached for a path in place, see `reload(AssetHandle)`
+        /// @returns whether the asset was cached and reloaded
+        bool reload(const fs::path &filepath);
+
+        /// Watch the resource directory and reload cached assets in place when their files change, so pointers,
+        /// handles and atlas frames stay valid. Changed images are decoded in the background and swapped into their
+        /// textures by `update`; atlases, fonts and SBC textures are reloaded by `update`, as are atlases and fonts
+        /// whose page files changed. Evicted textures load the new file when next used.
+        /// Supported where `io::FileWatcher` is, e.g. for iterating on content during development.
+        /// @param debounce milliseconds a file must go without changes before it's reloaded
+        /// @returns whether watching started
+        bool watchForChanges(double debounce = DefaultReloadDebounce);
+
+        /// Stop reloading changed assets
+        void stopWatching();
+
+        [[nodiscard]]
+        bool isWatching() const { return static_cast<bool>(m_watcher); }
+
+        /// Unload an asset that was previously loaded. Handles to it go stale, even if they weren't released.
         /// @param filepath path that the asset was previously loaded from
         /// @returns whether unload succeeded - it will not if filepath doesn't exist in cache
         bool unload(const fs::path &filepath);
@@ -38,15 +230,145 @@ namespace sdgl {
         void unloadAll();
 
     private:
+        struct TextureLoad;
+
+        static constexpr uint NoSlot = ~0u;
+
+        /// Cached asset, or a free slot waiting for reuse
+        struct AssetSlot
+        {
+            Asset *asset;                           ///< null while free
+            const fs::path::string_type *path;      ///< interned key in `m_lookup`, null while free
+            uint generation;                        ///< advanced when freed, so handles to the old asset go stale
+            uint refCount;                          ///< handles acquired or retained, and not released
+            bool pinned;                            ///< requested via a pointer-returning function, kept until unloaded
+        };
+
+        /// Residency of a texture loaded via `loadTexture` or `loadTextureAsync`
+        struct TextureResidency
+        {
+            Texture2D *texture;
+            fs::path path;
+            TextureFilter::Enum filter;
+            bool async;                             ///< reload in the background
+            bool evictable;                         ///< may be unloaded to stay within the budget
+            bool resident;                          ///< uploaded and counted in `m_residentBytes`
+            size_t bytes;                           ///< estimated GPU memory while resident
+            uint64 lastUsed;                        ///< frame of the last request or use
+            std::list<Texture2D *>::iterator lru;   ///< position in `m_lru` while resident
+        };
+
+        /// Upload textures decoded in the background
+        int uploadTextures(double budget);
+
+        /// Start reading and decoding a texture in the background, showing the placeholder meanwhile
+        bool queueTextureLoad(Texture2D *texture, const fs::path &filepath, TextureFilter::Enum filter);
+        /// Read a texture on a worker, decoding it unless it's an SBC file, to be uploaded by `uploadTextures`
+        /// @param reload whether the texture keeps showing its current image until the upload
+        void decodeTexture(Texture2D *texture, const fs::path &filepath, TextureFilter::Enum filter, bool reload);
+
+        void trackTexture(Texture2D *texture, const fs::path &filepath, TextureFilter::Enum filter, bool async);
+        void untrackTexture(const Texture2D *texture);
+        /// Count a tracked texture whose image was just uploaded
+        void setResident(TextureResidency &residency);
+        void touchTexture(TextureResidency &residency);
+        bool reloadTexture(TextureResidency &residency);
+        /// Evict least recently used evictable textures until within budget
+        /// @param keepFrom textures used on this frame or later are kept: the current frame in `update`, the one
+        ///                 before otherwise, as its draws may still be in flight
+        void evictTextures(uint64 keepFrom);
+        /// Evict textures between updates, keeping those of the previous frame
+        void evictTexturesMidFrame() { evictTextures(m_frame > 0 ? m_frame - 1 : 0); }
+
+        /// Abandon a background load
+        /// @returns whether a load was pending for the path and left its texture showing the placeholder; a texture
+        ///          being reloaded keeps its current image
+        bool cancelLoad(const fs::path::string_type &key);
+
+        /// Watch key of an asset path: absolute, lexically normal, as reported by `io::FileWatcher`
+        static fs::path::string_type getWatchKey(const fs::path &filepath);
+        void watchSlot(uint index);
+        void unwatchSlot(uint index);
+        /// Start reloading assets whose files changed
+        void reloadChanged();
+        /// Reload a cached asset whose file changed, decoding images in the background
+        void reloadChangedSlot(uint index);
+
+        /// Load an asset into a slot, or find its cached slot
+        /// @returns the slot index, or `NoSlot` on failure
+        uint loadTextureSlot(const fs::path &filepath);
+        uint loadTextureAsyncSlot(const fs::path &filepath, TextureFilter::Enum filter);
+        uint loadBitmapFontSlot(const fs::path &filepath);
+        uint loadTextureAtlasSlot(const fs::path &filepath);
+
+        /// Find the slot cached for a path, checking its asset type
+        /// @param outIndex [out] receives the slot index, or `NoSlot` if the path holds another type of asset
+        /// @returns the cached asset, or null if none of this type
         template<typename T>
-        T *checkCache(const fs::path &filepath)
+        T *checkCache(const fs::path &filepath, uint *outIndex);
+
+        /// Store a newly loaded asset in a free slot
+        uint addSlot(const fs::path &filepath, Asset *asset);
+        /// Unload and delete a slot's asset, making its handles stale
+        void freeSlot(uint index);
+        bool releaseSlot(uint index, uint generation);
+        bool reloadSlot(uint index);
+
+        /// @returns the slot a handle refers to, or null if the handle is null or stale
+        [[nodiscard]]
+        AssetSlot *findSlot(const uint index, const uint generation)
+        {
+            return (index < m_slots.size() && generation != 0 && m_slots[index].generation == generation) ?
+                &m_slots[index] : nullptr;
+        }
+
+        [[nodiscard]]
+        const AssetSlot *findSlot(const uint index, const uint generation) const
+        {
+            return const_cast<ContentManager *>(this)->findSlot(index, generation);
+        }
+
+        template <typename T>
+        AssetHandle<T> acquireSlot(const uint index)
         {
-            if (const auto it = m_cache.find(filepath.native()); it != m_cache.end())
-                return dynamic_cast<T *>(it->second);
-            return nullptr;
+            if (index == NoSlot)
+                return {};
+
+            ++m_slots[index].refCount;
+            return {index, m_slots[index].generation};
         }
 
-        map<fs::path::string_type, Asset *> m_cache;
+        template <typename T>
+        const T *pinSlot(const uint index)
+        {
+            if (index == NoSlot)
+                return nullptr;
+
+            m_slots[index].pinned = true;
+            return static_cast<const T *>(m_slots[index].asset);
+        }
+
+        vector<AssetSlot> m_slots;                          ///< cached assets, indexed by handles
+        vector<uint> m_freeSlots;                           ///< indices of free slots in `m_slots`
+        std::unordered_map<fs::path::string_type, uint> m_lookup; ///< slot index per path, interning the paths
+
+        map<fs::path::string_type, std::shared_ptr<TextureLoad>> m_loads; ///< background loads not yet uploaded
+        std::deque<std::shared_ptr<TextureLoad>> m_decoded; ///< finished by workers, guarded by `m_decodedMutex`
+        std::mutex m_decodedMutex;
+        Texture2D m_placeholder;
+        Texture2D m_defaultPlaceholder;                    ///< created on first use, owned
+        std::unordered_set<const Texture2D *> m_failedLoads; ///< cached textures left showing the placeholder
+        std::unique_ptr<ThreadPool> m_workers;             ///< started on first use
+
+        std::unordered_map<const Texture2D *, TextureResidency> m_residency;
+        std::list<Texture2D *> m_lru;                      ///< resident tracked textures, least recently used first
+        size_t m_residentBytes;
+        size_t m_textureBudget;                            ///< 0 for no limit
+        uint64 m_frame;                                    ///< advanced by `update`
+
+        std::unique_ptr<io::FileWatcher> m_watcher;         ///< set while watching for changes
+        std::unordered_map<fs::path::string_type, uint> m_watchedFiles;       ///< slot index per watch key
+        std::unordered_multimap<fs::path::string_type, uint> m_watchedPages;  ///< atlas and font slots per page file
     };
 }
 
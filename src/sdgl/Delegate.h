@@ -93,6 +93,7 @@ namespace sdgl
         {
             m_callbacks = std::move(other.m_callbacks);
             m_isDirty = other.m_isDirty;
+            return *this;
         }
 
         [[nodiscard]]
@@ -101,7 +102,7 @@ namespace sdgl
         [[nodiscard]]
         bool empty() const { return m_callbacks.empty(); }
 
-        void clear() const { m_callbacks.clear(); }
+        void clear() { m_callbacks.clear(); }
 
         template <typename T>
         Delegate &operator+=(Callback<T, Args...> callback)
@@ -166,7 +167,7 @@ namespace sdgl
         void processRemovals()
         {
             m_callbacks.erase(std::remove_if(m_callbacks.begin(), m_callbacks.end(),
-                [](const CallbackData &data) { return data.shouldRemove;}));
+                [](const CallbackData &data) { return data.shouldRemove;}), m_callbacks.end());
         }
 
         vector<CallbackData> m_callbacks;
@@ -0,0 +1,98 @@
+#include "ThreadPool.h"
+
+#include <sdgl/logging.h>
+#include <sdgl/platform.h>
+
+#include <algorithm>
+
+namespace sdgl {
+    ThreadPool::ThreadPool(int threadCount) : m_threads(), m_tasks(), m_mutex(), m_signal(), m_idle(), m_running(0),
+        m_quit(false)
+    {
+#ifndef SDGL_PLATFORM_EMSCRIPTEN
+        if (threadCount <= 0)
+            threadCount = std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 1);
+
+        m_threads.reserve(threadCount);
+        for (int i = 0; i < threadCount; ++i)
+        {
+            try
+            {
+                m_threads.emplace_back(&ThreadPool::run, this);
+            }
+            catch(const std::exception &e)
+            {
+                SDGL_ERROR("ThreadPool failed to start worker {}: {}", i, e.what());
+                break;
+            }
+        }
+#endif
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_tasks.clear();
+            m_quit = true;
+        }
+        m_signal.notify_all();
+
+        for (auto &thread : m_threads)
+            thread.join();
+    }
+
+    void ThreadPool::push(std::function<void()> task)
+    {
+        if (m_threads.empty()) // no workers to hand it to
+        {
+            task();
+            return;
+        }
+
+        {
+            std::lock_guard lock(m_mutex);
+            m_tasks.emplace_back(std::move(task));
+        }
+        m_signal.notify_one();
+    }
+
+    void ThreadPool::wait()
+    {
+        std::unique_lock lock(m_mutex);
+        m_idle.wait(lock, [this] { return m_tasks.empty() && m_running == 0; });
+    }
+
+    void ThreadPool::run()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock lock(m_mutex);
+                m_signal.wait(lock, [this] { return !m_tasks.empty() || m_quit; });
+                if (m_quit)
+                    break;
+
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+                ++m_running;
+            }
+
+            try
+            {
+                task();
+            }
+            catch(const std::exception &e)
+            {
+                SDGL_ERROR("ThreadPool: exception in task: {}", e.what());
+            }
+
+            {
+                std::lock_guard lock(m_mutex);
+                --m_running;
+            }
+            m_idle.notify_all();
+        }
+    }
+}
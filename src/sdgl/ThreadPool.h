@@ -0,0 +1,44 @@
+#pragma once
+#include <sdgl/sdglib.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace sdgl {
+    /// Fixed set of worker threads running queued tasks in submission order, e.g. to read and decode assets off the
+    /// main thread. Tasks must not make GL calls. Builds without threads (Emscripten) run each task inside `push`.
+    class ThreadPool {
+    public:
+        /// @param threadCount number of workers to start, or 0 for one less than the number of hardware threads
+        explicit ThreadPool(int threadCount = 0);
+
+        /// Discards tasks that haven't started and waits for running ones to return
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        /// Queue a task to run on the next free worker
+        void push(std::function<void()> task);
+
+        /// Block until the queue is empty and no task is running
+        void wait();
+
+        [[nodiscard]]
+        int threadCount() const { return static_cast<int>(m_threads.size()); }
+
+    private:
+        void run();
+
+        vector<std::thread> m_threads;
+        std::deque<std::function<void()>> m_tasks;
+        std::mutex m_mutex;
+        std::condition_variable m_signal;   ///< notifies workers of new tasks or quitting
+        std::condition_variable m_idle;     ///< notifies `wait` of finished tasks
+        int m_running;                      ///< number of tasks currently running
+        bool m_quit;
+    };
+}
@@ -1,6 +1,6 @@
 #include "Sound.h"
 
-#include <sdgl/io/io.h>
+#include <sdgl/io/MappedFile.h>
 #include <sdgl/logging.h>
 
 #include "al.h"
@@ -55,13 +55,23 @@ namespace sdgl {
             if (!alCheck())
                 return false;
 
+            // SDL decodes straight from the mapped file
+            io::MappedFile file;
+            if (!file.open(filepath))
+            {
+                alDeleteBuffers(1, &buffer);
+                return false;
+            }
+
             SDL_AudioSpec spec;
             ubyte *data;
             uint length;
 
-            if (!SDL_LoadWAV((io::getResourcePath() / filepath).c_str(), &spec, &data, &length))
+            if (!SDL_LoadWAV_RW(SDL_RWFromConstMem(file.data().data(), static_cast<int>(file.size())), 1,
+                &spec, &data, &length))
             {
                 SDGL_ERROR("Failed to load WAV: {}", SDL_GetError());
+                alDeleteBuffers(1, &buffer);
                 return false;
             }
 
@@ -13,6 +13,7 @@ using SDL_GLContext = void *;
 
 namespace sdgl {
     class Color;
+    class RenderThread;
 
     struct PluginConfig {
         /** Whether to include ImGui renderer - when true, ImGui functions may be called during update */
@@ -103,8 +104,18 @@ namespace sdgl {
 
         void swapBuffers() const;
         void makeCurrent() const;
+        /// Release the GL context from the calling thread, so that another thread can make it current
+        void releaseCurrent() const;
+
+        /// Clear the screen; recorded into the render thread's commands while one owns the GL context
         void clear(const Color &color);
 
+        /// Set the render thread owning this window's GL context, or nullptr if it's used from the main thread.
+        /// Set by `RenderThread::start` / `RenderThread::stop`.
+        void setRenderThread(RenderThread *thread);
+        [[nodiscard]]
+        RenderThread *renderThread() const;
+
         /**
          * Start frame for plugins, makes this window context current
          */
@@ -0,0 +1,50 @@
+#include "ImGuiDrawDataQueue.h"
+
+namespace sdgl {
+    ImGuiDrawDataQueue::~ImGuiDrawDataQueue()
+    {
+        clear();
+    }
+
+    void ImGuiDrawDataQueue::push(const ImDrawData *drawData)
+    {
+        if (m_pushed - m_popped == Capacity) // drop the oldest frame if it was never rendered
+            ++m_popped;
+
+        auto &frame = m_frames[m_pushed % Capacity];
+        release(frame);
+        if (drawData && drawData->Valid)
+        {
+            // the lists are reused by ImGui next frame, so own copies of their buffers
+            frame = *drawData;
+            for (auto &list : frame.CmdLists)
+                list = list->CloneOutput();
+        }
+
+        ++m_pushed;
+    }
+
+    ImDrawData *ImGuiDrawDataQueue::pop()
+    {
+        if (m_popped == m_pushed)
+            return nullptr;
+
+        auto &frame = m_frames[m_popped++ % Capacity];
+        return frame.Valid ? &frame : nullptr;
+    }
+
+    void ImGuiDrawDataQueue::clear()
+    {
+        for (auto &frame : m_frames)
+            release(frame);
+        m_pushed = 0;
+        m_popped = 0;
+    }
+
+    void ImGuiDrawDataQueue::release(ImDrawData &drawData)
+    {
+        for (const auto list : drawData.CmdLists)
+            IM_DELETE(list);
+        drawData.Clear();
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <sdgl/sdglib.h>
+
+#include <imgui.h>
+
+namespace sdgl {
+    /// Copies of ImGui draw data for frames that ended but weren't rendered yet, so a frame can render on the render
+    /// thread while the next one is built. Frames render in the order they ended; at most `Capacity` are held, which
+    /// covers one frame in flight and one being recorded.
+    class ImGuiDrawDataQueue {
+    public:
+        static constexpr int Capacity = 2;
+
+        ImGuiDrawDataQueue() : m_frames(), m_pushed(), m_popped() { }
+        ~ImGuiDrawDataQueue();
+
+        ImGuiDrawDataQueue(const ImGuiDrawDataQueue &) = delete;
+        ImGuiDrawDataQueue &operator=(const ImGuiDrawDataQueue &) = delete;
+
+        /// Copy the draw data of the frame that just ended; call after `ImGui::Render`
+        void push(const ImDrawData *drawData);
+
+        /// Take the draw data of the oldest frame not rendered yet
+        /// @returns the copy, valid until the frame after next is pushed; nullptr if every frame was rendered
+        ImDrawData *pop();
+
+        /// Free all copies
+        void clear();
+
+    private:
+        static void release(ImDrawData &drawData);
+
+        ImDrawData m_frames[Capacity];
+        uint m_pushed, m_popped;
+    };
+}
@@ -198,6 +198,8 @@ namespace sdgl {
 
             case SDL_WINDOWEVENT_RESIZED:
             {
+                if (window->renderThread()) // applies the framebuffer size with each submitted frame
+                    break;
                 window->makeCurrent();
                 glViewport(0, 0, e.data1, e.data2); GL_ERR_CHECK();
             } break;
@@ -48,6 +48,8 @@ namespace sdgl {
         io.IniFilename = nullptr;
 #endif
 
+        // Create GL objects and build the font atlas while the context is current, since frames start without GL
+        ImGui_ImplOpenGL3_NewFrame();
         return true;
     }
 
@@ -58,7 +60,7 @@ namespace sdgl {
 
     void ImGuiSdl2::startFrame()
     {
-        ImGui_ImplOpenGL3_NewFrame();
+        // no GL calls here, so frames can start while the render thread draws the last one
         ImGui_ImplSDL2_NewFrame();
         ImGui::NewFrame();
     }
@@ -66,15 +68,19 @@ namespace sdgl {
     void ImGuiSdl2::endFrame()
     {
         ImGui::Render();
+        m_drawData.push(ImGui::GetDrawData());
     }
 
     void ImGuiSdl2::render()
     {
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        ImGui_ImplOpenGL3_NewFrame(); // recreates GL objects if they were destroyed
+        if (const auto drawData = m_drawData.pop())
+            ImGui_ImplOpenGL3_RenderDrawData(drawData);
     }
 
     void ImGuiSdl2::shutdown()
     {
+        m_drawData.clear();
         ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplSDL2_Shutdown();
         ImGui::DestroyContext();
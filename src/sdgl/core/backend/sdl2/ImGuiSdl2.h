@@ -1,12 +1,13 @@
 #pragma once
 #include "../../IPlugin.h"
+#include "../ImGuiDrawDataQueue.h"
 
 #include <SDL2/SDL.h>
 
 namespace sdgl {
     class ImGuiSdl2 final :  public IPlugin, public IFramePlugin, public IRenderPlugin, public IEventPlugin {
     public:
-        ImGuiSdl2(SDL_Window *window, SDL_GLContext context) : m_window(window), m_context(context) { }
+        ImGuiSdl2(SDL_Window *window, SDL_GLContext context) : m_window(window), m_context(context), m_drawData() { }
 
         bool init() override;
         void processEvent(const void *event) override;
@@ -18,5 +19,6 @@ namespace sdgl {
     private:
         SDL_Window *m_window;
         SDL_GLContext m_context;
+        ImGuiDrawDataQueue m_drawData; ///< frames ended but not rendered yet
     };
 }
@@ -4,6 +4,7 @@
 #include "../../InputManager.h"
 
 #include <sdgl/graphics/Color.h>
+#include <sdgl/graphics/RenderThread.h>
 
 #include <angles.h>
 #include <SDL_events.h>
@@ -11,7 +12,8 @@
 
 namespace sdgl {
     struct Window::Impl {
-        Impl(SDL_Window *window, SDL_GLContext context, const Gamepad *gamepads) : window(window), context(context), shouldClose(), input() {
+        Impl(SDL_Window *window, SDL_GLContext context, const Gamepad *gamepads) : window(window), context(context), shouldClose(), input(),
+            renderThread() {
             input.init(InputInit::All, gamepads);
         }
 
@@ -19,6 +21,7 @@ namespace sdgl {
         SDL_GLContext context;
         InputManager input;
         bool shouldClose;
+        RenderThread *renderThread;
     };
 
     Window::Window(SDL_Window *window, SDL_GLContext context, const Gamepad *gamepads) : m(new Impl(window, context, gamepads)) { }
@@ -175,8 +178,36 @@ namespace sdgl {
         SDL_GL_MakeCurrent(m->window, m->context);
     }
 
+    void Window::releaseCurrent() const
+    {
+        SDL_GL_MakeCurrent(m->window, nullptr);
+    }
+
+    void Window::setRenderThread(RenderThread *thread)
+    {
+        m->renderThread = thread;
+    }
+
+    RenderThread *Window::renderThread() const
+    {
+        return m->renderThread;
+    }
+
     void Window::clear(const Color &color)
     {
+        if (m->renderThread)
+        {
+            m->renderThread->commands().invoke([this, color] {
+                glClearColor(
+                    static_cast<float>(color.r) / 255.f,
+                    static_cast<float>(color.g) / 255.f,
+                    static_cast<float>(color.b) / 255.f,
+                    static_cast<float>(color.a) / 255.f);
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            });
+            return;
+        }
+
         makeCurrent();
         glClearColor(
             static_cast<float>(color.r) / 255.f,
@@ -46,6 +46,8 @@ namespace sdgl::backends::sdl3 {
         io.IniFilename = nullptr;
 #endif
 
+        // Create GL objects and build the font atlas while the context is current, since frames start without GL
+        ImGui_ImplOpenGL3_NewFrame();
         return true;
     }
 
@@ -56,7 +58,7 @@ namespace sdgl::backends::sdl3 {
 
     void ImGuiSdl3::startFrame()
     {
-        ImGui_ImplOpenGL3_NewFrame();
+        // no GL calls here, so frames can start while the render thread draws the last one
         ImGui_ImplSDL3_NewFrame();
         ImGui::NewFrame();
     }
@@ -64,15 +66,19 @@ namespace sdgl::backends::sdl3 {
     void ImGuiSdl3::endFrame()
     {
         ImGui::Render();
+        m_drawData.push(ImGui::GetDrawData());
     }
 
     void ImGuiSdl3::render()
     {
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        ImGui_ImplOpenGL3_NewFrame(); // recreates GL objects if they were destroyed
+        if (const auto drawData = m_drawData.pop())
+            ImGui_ImplOpenGL3_RenderDrawData(drawData);
     }
 
     void ImGuiSdl3::shutdown()
     {
+        m_drawData.clear();
         ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplSDL3_Shutdown();
         ImGui::DestroyContext();
@@ -1,12 +1,13 @@
 #pragma once
 #include <../../IPlugin.h>
+#include "../ImGuiDrawDataQueue.h"
 
 #include <SDL3/SDL_video.h>
 
 namespace sdgl::backends::sdl3 {
     class ImGuiSdl3 final : public IPlugin, public IFramePlugin, public IRenderPlugin, public IEventPlugin {
     public:
-        explicit ImGuiSdl3(SDL_Window *window, SDL_GLContext context) : m_window(window), m_context(context) { }
+        explicit ImGuiSdl3(SDL_Window *window, SDL_GLContext context) : m_window(window), m_context(context), m_drawData() { }
         bool init() override;
         void processEvent(const void *event) override;
         void startFrame() override;
@@ -16,5 +17,6 @@ namespace sdgl::backends::sdl3 {
     private:
         SDL_Window *m_window;
         SDL_GLContext m_context;
+        ImGuiDrawDataQueue m_drawData; ///< frames ended but not rendered yet
     };
 }
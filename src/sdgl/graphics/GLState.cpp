@@ -0,0 +1,213 @@
+#include "GLState.h"
+
+#include <sdgl/angles.h>
+#include <sdgl/assert.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+
+namespace sdgl {
+    /// Binding value for state that may have been changed outside of GLState
+    static constexpr uint Unknown = UINT32_MAX;
+
+    static constexpr int MaxTextureUnits = 32;
+
+    /// Bytes last uploaded to a uniform location. Values up to a mat4 are stored inline; larger arrays use a heap
+    /// buffer that only grows, so uploading a new value never allocates once the slot has been used.
+    struct UniformValue
+    {
+        static constexpr size_t InlineSize = 64;
+
+        UniformValue() : inlineData(), heapData(), heapCapacity(0), size(0), layout(0) { }
+
+        [[nodiscard]]
+        const ubyte *data() const { return size <= InlineSize ? inlineData : heapData.get(); }
+
+        ubyte inlineData[InlineSize];
+        std::unique_ptr<ubyte[]> heapData;
+        size_t heapCapacity;
+        size_t size;   ///< byte size of the value, 0 if nothing was uploaded yet
+        ubyte layout;
+    };
+
+    static struct
+    {
+        uint program = Unknown;
+        uint vao = Unknown;
+        uint arrayBuffer = Unknown;
+        uint elementBuffer = Unknown;
+        int activeUnit = -1;
+        uint textures[MaxTextureUnits] = {
+            Unknown, Unknown, Unknown, Unknown, Unknown, Unknown, Unknown, Unknown,
+            Unknown, Unknown, Unknown, Unknown, Unknown, Unknown, Unknown, Unknown,
+            Unknown, Unknown, Unknown, Unknown, Unknown, Unknown, Unknown, Unknown,
+            Unknown, Unknown, Unknown, Unknown, Unknown, Unknown, Unknown, Unknown,
+        };
+
+        /// program => uniform location => value last uploaded
+        std::unordered_map<uint, vector<UniformValue>> uniforms;
+
+        GLState::Stats stats;
+    } s_state;
+
+    /// Whether a binding changes, counting the call either way
+    static bool changes(uint &current, const uint value)
+    {
+        if (current == value)
+        {
+            ++s_state.stats.redundantCalls;
+            return false;
+        }
+
+        current = value;
+        ++s_state.stats.calls;
+        return true;
+    }
+
+    void GLState::useProgram(const uint program)
+    {
+        if (changes(s_state.program, program))
+        {
+            glUseProgram(program); GL_ERR_CHECK();
+        }
+    }
+
+    void GLState::bindVertexArray(const uint vao)
+    {
+        if (changes(s_state.vao, vao))
+        {
+            glBindVertexArray(vao); GL_ERR_CHECK();
+            s_state.elementBuffer = Unknown; // belongs to the vertex array
+        }
+    }
+
+    void GLState::bindArrayBuffer(const uint buffer)
+    {
+        if (changes(s_state.arrayBuffer, buffer))
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, buffer); GL_ERR_CHECK();
+        }
+    }
+
+    void GLState::bindElementBuffer(const uint buffer)
+    {
+        if (changes(s_state.elementBuffer, buffer))
+        {
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer); GL_ERR_CHECK();
+        }
+    }
+
+    bool GLState::bindTexture(const int unit, const uint texture)
+    {
+        SDGL_ASSERT(unit >= 0 && unit < MaxTextureUnits);
+
+        if (s_state.textures[unit] == texture)
+        {
+            ++s_state.stats.redundantCalls;
+            return false;
+        }
+
+        if (s_state.activeUnit != unit)
+        {
+            glActiveTexture(GL_TEXTURE0 + unit); GL_ERR_CHECK();
+            s_state.activeUnit = unit;
+            ++s_state.stats.calls;
+        }
+
+        glBindTexture(GL_TEXTURE_2D, texture); GL_ERR_CHECK();
+        s_state.textures[unit] = texture;
+        ++s_state.stats.calls;
+        return true;
+    }
+
+    bool GLState::setUniform(const uint program, const int location, const void *data, const size_t size,
+        const ubyte layout)
+    {
+        if (location < 0)
+            return false;
+
+        auto &values = s_state.uniforms[program];
+        if (values.size() <= static_cast<size_t>(location))
+            values.resize(location + 1);
+
+        auto &value = values[location];
+        if (value.size == size && value.layout == layout && std::memcmp(value.data(), data, size) == 0)
+        {
+            ++s_state.stats.redundantCalls;
+            return false;
+        }
+
+        auto storage = value.inlineData;
+        if (size > UniformValue::InlineSize)
+        {
+            if (value.heapCapacity < size)
+            {
+                value.heapData = std::make_unique<ubyte[]>(size);
+                value.heapCapacity = size;
+            }
+            storage = value.heapData.get();
+        }
+
+        std::memcpy(storage, data, size);
+        value.size = size;
+        value.layout = layout;
+        ++s_state.stats.calls;
+        return true;
+    }
+
+    void GLState::deleteProgram(const uint program)
+    {
+        glDeleteProgram(program); GL_ERR_CHECK();
+        s_state.uniforms.erase(program); // the id may be reused by a new program
+
+        if (s_state.program == program)
+            s_state.program = Unknown; // a deleted program stays in use until another one is used
+    }
+
+    void GLState::deleteTexture(const uint texture)
+    {
+        glDeleteTextures(1, &texture); GL_ERR_CHECK();
+        std::replace(std::begin(s_state.textures), std::end(s_state.textures), texture, 0u);
+    }
+
+    void GLState::deleteBuffer(const uint buffer)
+    {
+        glDeleteBuffers(1, &buffer); GL_ERR_CHECK();
+        if (s_state.arrayBuffer == buffer)
+            s_state.arrayBuffer = 0;
+        if (s_state.elementBuffer == buffer)
+            s_state.elementBuffer = 0;
+    }
+
+    void GLState::deleteVertexArray(const uint vao)
+    {
+        glDeleteVertexArrays(1, &vao); GL_ERR_CHECK();
+        if (s_state.vao == vao)
+        {
+            s_state.vao = 0;
+            s_state.elementBuffer = Unknown;
+        }
+    }
+
+    void GLState::invalidate()
+    {
+        s_state.program = Unknown;
+        s_state.vao = Unknown;
+        s_state.arrayBuffer = Unknown;
+        s_state.elementBuffer = Unknown;
+        s_state.activeUnit = -1;
+        std::fill(std::begin(s_state.textures), std::end(s_state.textures), Unknown);
+    }
+
+    const GLState::Stats &GLState::stats()
+    {
+        return s_state.stats;
+    }
+
+    void GLState::resetStats()
+    {
+        s_state.stats = {};
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <sdgl/sdglib.h>
+
+namespace sdgl {
+    /// Shadows the bindings and uniform values of the current GL context, so that calls which wouldn't change
+    /// anything are skipped. Binds and deletions in sdgl go through here; call `invalidate` after code outside of
+    /// sdgl changed bindings directly.
+    class GLState {
+    public:
+        /// State change counters, accumulated until `resetStats` is called
+        struct Stats
+        {
+            uint calls = 0;          ///< number of state changes passed on to GL
+            uint redundantCalls = 0; ///< number of state changes skipped since they wouldn't change anything
+        };
+
+        static void useProgram(uint program);
+        static void bindVertexArray(uint vao);
+        static void bindArrayBuffer(uint buffer);
+        /// Element buffer bindings are part of vertex array state, bind the vertex array first
+        static void bindElementBuffer(uint buffer);
+        /// Bind a 2D texture to a texture unit, activating the unit if needed
+        /// @returns whether the texture had to be bound
+        static bool bindTexture(int unit, uint texture);
+
+        /// Record a uniform value of a program
+        /// @param program  program the uniform belongs to
+        /// @param location uniform location; -1 is ignored by GL, so it never needs uploading
+        /// @param data     value to upload
+        /// @param size     byte size of `data`
+        /// @param layout   how GL reads `data`, e.g. whether matrices are transposed on upload
+        /// @returns whether the value differs from the one last uploaded and needs to be passed on to GL
+        static bool setUniform(uint program, int location, const void *data, size_t size, ubyte layout = 0);
+
+        /// Delete objects, resetting any bindings and uniform values they had
+        static void deleteProgram(uint program);
+        static void deleteTexture(uint texture);
+        static void deleteBuffer(uint buffer);
+        static void deleteVertexArray(uint vao);
+
+        /// Forget all bindings, so that the next bind of each kind is passed on to GL. Uniform values are kept, since
+        /// they belong to programs.
+        static void invalidate();
+
+        [[nodiscard]]
+        static const Stats &stats();
+        static void resetStats();
+    };
+}
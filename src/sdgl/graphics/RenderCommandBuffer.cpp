@@ -0,0 +1,193 @@
+#include "RenderCommandBuffer.h"
+
+#include <sdgl/assert.h>
+
+#include <glm/vec2.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace sdgl {
+    /// Alignment of vertex data in the buffer, enough for any vertex type
+    static constexpr size_t DataAlignment = alignof(std::max_align_t);
+
+    /// Upper limit of textures per `setTextures` command
+    static constexpr int MaxTextures = 32;
+
+    RenderCommandBuffer::RenderCommandBuffer() : m_commands(), m_data(), m_textures(), m_callbacks(),
+        m_bytesUploaded(0), m_uploadBases()
+    {
+    }
+
+    size_t RenderCommandBuffer::reserveData(const size_t size)
+    {
+        const auto offset = (m_data.size() + DataAlignment - 1) / DataAlignment * DataAlignment;
+        m_data.resize(offset + size);
+        return offset;
+    }
+
+    void RenderCommandBuffer::setMatrix(RenderProgram *program, const int location, const float *matrix)
+    {
+        const auto data = reserveData(sizeof(float) * 16);
+        std::memcpy(m_data.data() + data, matrix, sizeof(float) * 16);
+        m_commands.emplace_back(Command{CommandType::SetMatrix, false, program, {location}, data});
+    }
+
+    void RenderCommandBuffer::setTextures(RenderProgram *program, const int textureLocation, const int sizeLocation,
+        const Texture2D *textures, const int count)
+    {
+        SDGL_ASSERT(count >= 0 && count <= MaxTextures);
+
+        const auto data = m_textures.size();
+        m_textures.insert(m_textures.end(), textures, textures + count);
+        m_commands.emplace_back(Command{CommandType::SetTextures, false, program,
+            {textureLocation, sizeLocation, count}, data});
+    }
+
+    void *RenderCommandBuffer::uploadVertices(RenderProgram *program, const int count)
+    {
+        const auto size = program->attributes().sizeofVertex() * count;
+        const auto data = reserveData(size);
+        m_commands.emplace_back(Command{CommandType::UploadVertices, false, program, {count}, data});
+        m_bytesUploaded += size;
+
+        return m_data.data() + data;
+    }
+
+    void RenderCommandBuffer::setBaseVertex(RenderProgram *program, const int baseVertex, const bool relative)
+    {
+        m_commands.emplace_back(Command{CommandType::SetBaseVertex, relative, program, {baseVertex}, 0});
+    }
+
+    void RenderCommandBuffer::setQuadIndices(RenderProgram *program, const int quadCount)
+    {
+        m_commands.emplace_back(Command{CommandType::SetQuadIndices, false, program, {quadCount}, 0});
+    }
+
+    void RenderCommandBuffer::clearIndices(RenderProgram *program)
+    {
+        m_commands.emplace_back(Command{CommandType::ClearIndices, false, program, {}, 0});
+    }
+
+    void RenderCommandBuffer::draw(RenderProgram *program, const PrimitiveType::Enum primitiveType, const int offset,
+        const int count, const bool relative)
+    {
+        m_commands.emplace_back(Command{CommandType::Draw, relative, program, {primitiveType, offset, count}, 0});
+    }
+
+    void RenderCommandBuffer::drawInstanced(RenderProgram *program, const PrimitiveType::Enum primitiveType,
+        const int vertexCount, const int instanceCount)
+    {
+        m_commands.emplace_back(Command{CommandType::DrawInstanced, false, program,
+            {primitiveType, vertexCount, instanceCount}, 0});
+    }
+
+    void RenderCommandBuffer::invoke(std::function<void()> callback)
+    {
+        m_commands.emplace_back(Command{CommandType::Invoke, false, nullptr, {}, m_callbacks.size()});
+        m_callbacks.emplace_back(std::move(callback));
+    }
+
+    void RenderCommandBuffer::execute()
+    {
+        m_uploadBases.clear();
+
+        // where the program's last uploaded vertices landed, or 0 if none were uploaded
+        const auto uploadBase = [this](const RenderProgram *program) {
+            const auto it = std::find_if(m_uploadBases.begin(), m_uploadBases.end(),
+                [program](const auto &base) { return base.first == program; });
+            return it == m_uploadBases.end() ? 0 : it->second;
+        };
+
+        for (const auto &command : m_commands)
+        {
+            const auto program = command.program;
+            const auto &args = command.args;
+            const auto relativeOffset = command.relative ? uploadBase(program) : 0;
+
+            switch(command.type)
+            {
+                case CommandType::SetMatrix:
+                    program->shader()->setUniformMatrix(args[0],
+                        reinterpret_cast<const float *>(m_data.data() + command.data));
+                break;
+
+                case CommandType::SetTextures:
+                {
+                    const auto textures = m_textures.data() + command.data;
+                    glm::vec2 sizes[MaxTextures];
+                    for (int i = 0; i < args[2]; ++i)
+                    {
+                        const auto size = textures[i].size();
+                        sizes[i] = {static_cast<float>(size.x), static_cast<float>(size.y)};
+                    }
+
+                    program->shader()->setUniform(args[1], sizes, args[2]);
+                    program->shader()->setUniform(args[0], textures, args[2]);
+                } break;
+
+                case CommandType::UploadVertices:
+                {
+                    // the recorded copy is written once more if the driver lost the mapped vertices
+                    const auto size = program->attributes().sizeofVertex() * args[0];
+                    auto base = -1;
+                    for (auto attempt = 0; base < 0 && attempt < 2; ++attempt)
+                    {
+                        const auto vertices = program->mapVertices(args[0]);
+                        if (!vertices)
+                        {
+                            SDGL_ERROR("RenderCommandBuffer failed to map vertex buffer");
+                            break;
+                        }
+
+                        std::memcpy(vertices, m_data.data() + command.data, size);
+                        base = program->unmapVertices();
+                    }
+
+                    if (base < 0)
+                        break;
+
+                    const auto it = std::find_if(m_uploadBases.begin(), m_uploadBases.end(),
+                        [program](const auto &entry) { return entry.first == program; });
+                    if (it == m_uploadBases.end())
+                        m_uploadBases.emplace_back(program, base);
+                    else
+                        it->second = base;
+                } break;
+
+                case CommandType::SetBaseVertex:
+                    program->setBaseVertex(args[0] + relativeOffset);
+                break;
+
+                case CommandType::SetQuadIndices:
+                    program->setQuadIndices(args[0]);
+                break;
+
+                case CommandType::ClearIndices:
+                    program->clearIndices();
+                break;
+
+                case CommandType::Draw:
+                    program->render(static_cast<PrimitiveType::Enum>(args[0]), args[1] + relativeOffset, args[2]);
+                break;
+
+                case CommandType::DrawInstanced:
+                    program->renderInstanced(static_cast<PrimitiveType::Enum>(args[0]), args[1], args[2]);
+                break;
+
+                case CommandType::Invoke:
+                    m_callbacks[command.data]();
+                break;
+            }
+        }
+    }
+
+    void RenderCommandBuffer::clear()
+    {
+        m_commands.clear();
+        m_data.clear();
+        m_textures.clear();
+        m_callbacks.clear();
+        m_bytesUploaded = 0;
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <sdgl/graphics/RenderProgram.h>
+#include <sdgl/graphics/Texture2D.h>
+
+#include <functional>
+
+namespace sdgl {
+    /// Compact list of recorded GL work, executed later on the thread that owns the GL context.
+    /// Vertex data, matrices and textures are copied into the buffer on record, so the recording side may reuse its
+    /// memory right away. Programs must outlive the execution of any buffer they were recorded into.
+    class RenderCommandBuffer {
+    public:
+        RenderCommandBuffer();
+
+        /// Set a mat4 uniform of a program's shader
+        /// @param matrix 16 floats, copied
+        void setMatrix(RenderProgram *program, int location, const float *matrix);
+
+        /// Bind textures to consecutive texture units, pointing a sampler array and a texture size array at them
+        /// @param textureLocation location of the `sampler2D[]` uniform
+        /// @param sizeLocation    location of the `vec2[]` uniform receiving each texture's size in pixels
+        void setTextures(RenderProgram *program, int textureLocation, int sizeLocation, const Texture2D *textures,
+            int count);
+
+        /// Reserve room for `count` vertices that get written into the program via `RenderProgram::mapVertices`
+        /// on execution. Later relative commands for this program are offset by the index the vertices land at.
+        /// @returns pointer to write `count` vertices into, valid until the next command is recorded
+        [[nodiscard]]
+        void *uploadVertices(RenderProgram *program, int count);
+
+        /// Record `RenderProgram::setBaseVertex`
+        /// @param relative whether to add the index that the program's last uploaded vertices landed at
+        void setBaseVertex(RenderProgram *program, int baseVertex, bool relative);
+
+        /// Record `RenderProgram::setQuadIndices`
+        void setQuadIndices(RenderProgram *program, int quadCount);
+
+        /// Record `RenderProgram::clearIndices`
+        void clearIndices(RenderProgram *program);
+
+        /// Record `RenderProgram::render`
+        /// @param relative whether to add the index that the program's last uploaded vertices landed at to `offset`
+        void draw(RenderProgram *program, PrimitiveType::Enum primitiveType, int offset, int count, bool relative);
+
+        /// Record `RenderProgram::renderInstanced`
+        void drawInstanced(RenderProgram *program, PrimitiveType::Enum primitiveType, int vertexCount,
+            int instanceCount);
+
+        /// Run arbitrary GL work, e.g. clearing the screen or rendering window plugins
+        void invoke(std::function<void()> callback);
+
+        /// Run all commands in recording order; the GL context must be current on the calling thread
+        void execute();
+
+        /// Remove all commands, keeping allocated memory for the next recording
+        void clear();
+
+        [[nodiscard]]
+        bool empty() const { return m_commands.empty(); }
+
+        /// Number of recorded commands
+        [[nodiscard]]
+        size_t size() const { return m_commands.size(); }
+
+        /// Number of vertex bytes recorded for upload
+        [[nodiscard]]
+        size_t bytesUploaded() const { return m_bytesUploaded; }
+
+    private:
+        struct CommandType
+        {
+            enum Enum : ubyte
+            {
+                SetMatrix,
+                SetTextures,
+                UploadVertices,
+                SetBaseVertex,
+                SetQuadIndices,
+                ClearIndices,
+                Draw,
+                DrawInstanced,
+                Invoke,
+            };
+        };
+
+        struct Command
+        {
+            CommandType::Enum type;
+            bool relative;
+            RenderProgram *program;
+            int args[3];
+            size_t data; ///< offset into `m_data`, index into `m_textures` or `m_callbacks`, depending on type
+        };
+
+        /// Append `size` bytes to `m_data`, aligned for any vertex type
+        /// @returns offset of the reserved bytes
+        size_t reserveData(size_t size);
+
+        vector<Command> m_commands;
+        vector<ubyte> m_data;
+        vector<Texture2D> m_textures;
+        vector<std::function<void()>> m_callbacks;
+        size_t m_bytesUploaded;
+
+        /// Where each program's last uploaded vertices landed during `execute`
+        vector<std::pair<RenderProgram *, int>> m_uploadBases;
+    };
+}
@@ -1,16 +1,32 @@
 #include "RenderProgram.h"
+#include "GLState.h"
 
 #include <sdgl/angles.h>
+#include <sdgl/platform.h>
+
+#include <algorithm>
 #include <utility>
 
 namespace sdgl {
+#ifdef SDGL_PLATFORM_EMSCRIPTEN
+    static constexpr bool CanMapBuffers = false; // WebGL2 does not provide glMapBufferRange
+#else
+    static constexpr bool CanMapBuffers = true;
+#endif
+
+    /// Largest fraction of the ring buffer a single write may take before the buffer grows, so that writes for at
+    /// least this many frames can be in flight at once without stalling
+    static constexpr size_t StreamFramesInFlight = 3;
+
     RenderProgram::RenderProgram(Config config) :
-      m_vao(0), m_vbo(0), m_ebo(0), m_shader(), m_config(std::move(config)), m_indexCount(0), m_vertexCount(0)
+      m_vao(0), m_vbo(0), m_ebo(0), m_shader(), m_config(std::move(config)), m_indexCount(0), m_vertexCount(0),
+      m_indexType(GL_UNSIGNED_INT), m_quadCapacity(0), m_baseVertex(0)
     {
     }
 
     RenderProgram::RenderProgram() :
-      m_vao(0), m_vbo(0), m_ebo(0), m_shader(), m_config(), m_indexCount(0), m_vertexCount(0)
+      m_vao(0), m_vbo(0), m_ebo(0), m_shader(), m_config(), m_indexCount(0), m_vertexCount(0),
+      m_indexType(GL_UNSIGNED_INT), m_quadCapacity(0), m_baseVertex(0)
     {
     }
 
@@ -18,14 +34,19 @@ namespace sdgl {
       m_vao(other.m_vao), m_vbo(other.m_vbo), m_ebo(other.m_ebo),
       m_shader(std::move(other.m_shader)),
       m_config(std::move(other.m_config)),
-      m_indexCount(other.m_indexCount), m_vertexCount(other.m_vertexCount)
+      m_indexCount(other.m_indexCount), m_vertexCount(other.m_vertexCount),
+      m_indexType(other.m_indexType), m_quadCapacity(other.m_quadCapacity), m_baseVertex(other.m_baseVertex),
+      m_stream(std::move(other.m_stream))
     {
         // Invalidate other
         other.m_vertexCount = 0;
         other.m_indexCount = 0;
+        other.m_quadCapacity = 0;
+        other.m_baseVertex = 0;
         other.m_vao = 0;
         other.m_vbo = 0;
         other.m_ebo = 0;
+        other.m_stream = {};
     }
 
     RenderProgram &RenderProgram::operator=(RenderProgram &&other) noexcept
@@ -37,13 +58,20 @@ namespace sdgl {
         m_config = std::move(other.m_config);
         m_indexCount = other.m_indexCount;
         m_vertexCount = other.m_vertexCount;
+        m_indexType = other.m_indexType;
+        m_quadCapacity = other.m_quadCapacity;
+        m_baseVertex = other.m_baseVertex;
+        m_stream = std::move(other.m_stream);
 
         // Invalidate other
         other.m_vertexCount = 0;
         other.m_indexCount = 0;
+        other.m_quadCapacity = 0;
+        other.m_baseVertex = 0;
         other.m_vao = 0;
         other.m_vbo = 0;
         other.m_ebo = 0;
+        other.m_stream = {};
 
         return *this;
     }
@@ -87,24 +115,23 @@ namespace sdgl {
         SDGL_ASSERT(ebo);
 
         // Set up the vertex array object
-        glBindVertexArray(vao); GL_ERR_CHECK();
-        glBindBuffer(GL_ARRAY_BUFFER, vbo); GL_ERR_CHECK();
+        GLState::bindVertexArray(vao);
+        GLState::bindArrayBuffer(vbo);
 
-
-        for (uint i = 0; const auto &[count, normalized, type, stride, offset] : m_config.attributes)
+        // Allocate ring buffer storage up front when streaming
+        StreamState stream;
+        if (m_config.streamBufferSize > 0)
         {
-            glEnableVertexAttribArray(i); GL_ERR_CHECK();
-            glVertexAttribPointer(i, count, type, normalized, static_cast<int>(stride),
-              (void *)(uintptr_t)offset); GL_ERR_CHECK();
-            ++i;
+            stream.capacity = m_config.streamBufferSize / m_config.attributes.sizeofVertex();
+            stream.useMapping = CanMapBuffers;
+            glBufferData(GL_ARRAY_BUFFER,
+                static_cast<GLsizeiptr>(stream.capacity * m_config.attributes.sizeofVertex()),
+                nullptr, GL_STREAM_DRAW); GL_ERR_CHECK();
         }
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo); GL_ERR_CHECK();
+        bindAttributes(0);
 
-        // Unbind buffers
-        glBindVertexArray(0); GL_ERR_CHECK();
-        glBindBuffer(GL_ARRAY_BUFFER, 0); GL_ERR_CHECK();
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0); GL_ERR_CHECK();
+        GLState::bindElementBuffer(ebo);
 
         // Commit changes
         if (isLoaded())
@@ -116,6 +143,10 @@ namespace sdgl {
         m_vao = vao;
         m_vbo = vbo;
         m_ebo = ebo;
+        m_stream = std::move(stream);
+        m_indexCount = 0;
+        m_quadCapacity = 0;
+        m_baseVertex = 0;
 
         return true;
     }
@@ -141,44 +172,340 @@ namespace sdgl {
         return &m_shader;
     }
 
-    RenderProgram &RenderProgram::setIndices(const uint *indices, int count, bool dynamic)
+    RenderProgram &RenderProgram::setIndices(const uint *indices, const int count, const bool dynamic)
+    {
+        return setIndices(indices, count, GL_UNSIGNED_INT, dynamic);
+    }
+
+    RenderProgram &RenderProgram::setIndices(const ushort *indices, const int count, const bool dynamic)
+    {
+        return setIndices(indices, count, GL_UNSIGNED_SHORT, dynamic);
+    }
+
+    RenderProgram &RenderProgram::setIndices(const void *indices, const int count, const int indexType,
+        const bool dynamic)
     {
         SDGL_ASSERT(m_ebo);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo); GL_ERR_CHECK();
 
-        const auto size = static_cast<GLsizeiptr>(sizeof(uint) * count);
+        // the element buffer binding belongs to the vertex array
+        GLState::bindVertexArray(m_vao);
+        GLState::bindElementBuffer(m_ebo);
+
+        const auto indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(ushort) : sizeof(uint);
+        const auto size = static_cast<GLsizeiptr>(indexSize * count);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, nullptr,
             dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW); GL_ERR_CHECK();
         glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, size, indices); GL_ERR_CHECK();
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0); GL_ERR_CHECK();
-
         m_indexCount = count;
+        m_indexType = indexType;
+        m_quadCapacity = 0; // any quad pattern was overwritten
         return *this;
     }
 
+    /// Max number of quads whose vertices can be addressed with 16-bit indices
+    static constexpr int MaxShortIndexQuads = (UINT16_MAX + 1) / 4;
+
+    template <typename T>
+    static vector<T> makeQuadIndices(const int quadCount)
+    {
+        vector<T> indices(static_cast<size_t>(quadCount) * 6);
+        T vert = 0;
+        for (size_t i = 0; i < indices.size(); i += 6, vert += 4)
+        {
+            indices[i]     = vert;
+            indices[i + 1] = vert + 1;
+            indices[i + 2] = vert + 2;
+            indices[i + 3] = vert + 2;
+            indices[i + 4] = vert + 3;
+            indices[i + 5] = vert;
+        }
+
+        return indices;
+    }
+
+    RenderProgram &RenderProgram::setQuadIndices(const int quadCount)
+    {
+        if (quadCount <= m_quadCapacity)
+        {
+            m_indexCount = m_quadCapacity * 6; // restore, in case indices were cleared
+            return *this;
+        }
+
+        // grow geometrically so that rebuilds are rare
+        auto capacity = std::max(quadCount, m_quadCapacity * 2);
+        if (quadCount <= MaxShortIndexQuads)
+        {
+            capacity = std::min(capacity, MaxShortIndexQuads);
+            setIndices(makeQuadIndices<ushort>(capacity));
+        }
+        else
+        {
+            setIndices(makeQuadIndices<uint>(capacity));
+        }
+
+        m_quadCapacity = capacity;
+        return *this;
+    }
+
+    RenderProgram &RenderProgram::setBaseVertex(const int baseVertex)
+    {
+        if (baseVertex == m_baseVertex)
+            return *this;
+
+        SDGL_ASSERT(m_vao);
+        SDGL_ASSERT(m_vbo);
+        SDGL_ASSERT(baseVertex >= 0);
+
+        GLState::bindVertexArray(m_vao);
+        GLState::bindArrayBuffer(m_vbo);
+
+        bindAttributes(static_cast<size_t>(baseVertex) * m_config.attributes.sizeofVertex());
+
+        m_baseVertex = baseVertex;
+        return *this;
+    }
+
+    void RenderProgram::bindAttributes(const size_t byteOffset) const
+    {
+        for (uint i = 0; const auto &[count, normalized, type, stride, offset] : m_config.attributes)
+        {
+            glEnableVertexAttribArray(i); GL_ERR_CHECK();
+            glVertexAttribPointer(i, count, type, normalized, static_cast<int>(stride),
+              (void *)(uintptr_t)(byteOffset + offset)); GL_ERR_CHECK();
+            glVertexAttribDivisor(i, m_config.attributes.divisor()); GL_ERR_CHECK();
+            ++i;
+        }
+    }
+
     RenderProgram &RenderProgram::setVertices(const void *vertices, int count, bool dynamic)
     {
         SDGL_ASSERT(m_vbo);
-        glBindBuffer(GL_ARRAY_BUFFER, m_vbo); GL_ERR_CHECK();
+        GLState::bindArrayBuffer(m_vbo);
 
         const auto size = static_cast<GLsizeiptr>(m_config.attributes.sizeofVertex() * count);
 
         // orphan buffer, then fill it
         glBufferData(GL_ARRAY_BUFFER, size, nullptr, dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW); GL_ERR_CHECK();
-        glBufferSubData(GL_ARRAY_BUFFER, 0, size, vertices); GL_ERR_CHECK();
-
-        glBindBuffer(GL_ARRAY_BUFFER, 0); GL_ERR_CHECK();
+        if (vertices)
+        {
+            glBufferSubData(GL_ARRAY_BUFFER, 0, size, vertices); GL_ERR_CHECK();
+        }
 
         m_vertexCount = count;
         return *this;
     }
 
+    RenderProgram &RenderProgram::updateVertices(const void *vertices, const int offset, const int count)
+    {
+        SDGL_ASSERT(m_vbo);
+        SDGL_ASSERT(vertices);
+        SDGL_ASSERT(offset >= 0 && count >= 0 && offset + count <= m_vertexCount);
+        GLState::bindArrayBuffer(m_vbo);
+
+        const auto vertexSize = m_config.attributes.sizeofVertex();
+        glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(vertexSize * offset),
+            static_cast<GLsizeiptr>(vertexSize * count), vertices); GL_ERR_CHECK();
+
+        return *this;
+    }
+
     void RenderProgram::clearIndices()
     {
         m_indexCount = 0;
     }
 
+    void *RenderProgram::mapVertices(const int count)
+    {
+        SDGL_ASSERT(m_vbo);
+        SDGL_ASSERT(!m_stream.mapped, "Mismatched RenderProgram::mapVertices call. Did you call unmapVertices?");
+
+        if (count <= 0)
+            return nullptr;
+
+        auto &stream = m_stream;
+        const auto stride = m_config.attributes.sizeofVertex();
+
+        // Static program: stage the vertices, they replace the buffer contents on unmap
+        if (!isStreaming())
+        {
+            if (stream.staging.size() < count * stride)
+                stream.staging.resize(count * stride);
+            stream.mappedBegin = 0;
+            stream.mappedCount = count;
+            stream.mapped = true;
+            return stream.staging.data();
+        }
+
+        // Fence the last committed region: all draw calls that read from it have been issued by now
+        if (stream.pendingFence)
+        {
+            if (stream.useMapping)
+            {
+                stream.fences.emplace_back(StreamFence {
+                    .begin = stream.mappedBegin,
+                    .end = stream.mappedBegin + stream.mappedCount,
+                    .sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)
+                });
+            }
+            stream.pendingFence = false;
+        }
+
+        GLState::bindArrayBuffer(m_vbo);
+
+        if (static_cast<size_t>(count) * StreamFramesInFlight > stream.capacity)
+        {
+            growStream(static_cast<size_t>(count) * stride * StreamFramesInFlight);
+        }
+
+        // Wrap around to the start of the ring
+        if (stream.head + count > stream.capacity)
+        {
+            stream.head = 0;
+            if (!stream.useMapping)
+            {
+                // No fences to wait on: orphan the storage, the driver keeps the old one alive until the GPU is done
+                glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(stream.capacity * stride), nullptr,
+                    GL_STREAM_DRAW); GL_ERR_CHECK();
+                ++stream.stats.orphans;
+            }
+        }
+
+        stream.mappedBegin = stream.head;
+        stream.mappedCount = count;
+
+        void *result = nullptr;
+        if (stream.useMapping)
+        {
+            waitStreamRange(stream.mappedBegin, stream.mappedBegin + count);
+
+            // Synchronization is done via fences, so the driver doesn't need to
+            result = glMapBufferRange(GL_ARRAY_BUFFER,
+                static_cast<GLintptr>(stream.mappedBegin * stride),
+                static_cast<GLsizeiptr>(count * stride),
+                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+
+            if (!result) // mapping unsupported by this driver, fall back to staging from here on
+            {
+                SDGL_WARN("glMapBufferRange failed, falling back to buffer orphaning for vertex streaming");
+                glGetError(); // clear error flag
+                releaseStreamFences();
+                stream.useMapping = false;
+            }
+        }
+
+        if (!result)
+        {
+            if (stream.staging.size() < count * stride)
+                stream.staging.resize(count * stride);
+            result = stream.staging.data();
+        }
+
+        stream.mapped = true;
+        return result;
+    }
+
+    int RenderProgram::unmapVertices()
+    {
+        SDGL_ASSERT(m_stream.mapped, "Mismatched RenderProgram::unmapVertices call. Did you call mapVertices?");
+
+        auto &stream = m_stream;
+        const auto stride = m_config.attributes.sizeofVertex();
+        const auto size = static_cast<GLsizeiptr>(stream.mappedCount * stride);
+
+        if (!isStreaming())
+        {
+            setVertices(stream.staging.data(), static_cast<int>(stream.mappedCount), false);
+            stream.stats.bytesUploaded += size;
+            stream.mapped = false;
+            return 0;
+        }
+
+        GLState::bindArrayBuffer(m_vbo);
+        auto lost = false;
+        if (stream.useMapping)
+        {
+            // GL_FALSE means the buffer contents were corrupted while mapped, e.g. by a display mode change
+            lost = glUnmapBuffer(GL_ARRAY_BUFFER) == GL_FALSE; GL_ERR_CHECK();
+        }
+        else
+        {
+            glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(stream.mappedBegin * stride), size,
+                stream.staging.data()); GL_ERR_CHECK();
+        }
+
+        stream.head = stream.mappedBegin + stream.mappedCount;
+        stream.stats.bytesUploaded += size;
+        stream.mapped = false;
+        stream.pendingFence = true;
+
+        m_vertexCount = static_cast<int>(stream.head);
+        if (lost)
+        {
+            SDGL_ERROR("RenderProgram lost {} mapped vertices, they must be written again", stream.mappedCount);
+            return -1;
+        }
+        return static_cast<int>(stream.mappedBegin);
+    }
+
+    void RenderProgram::waitStreamRange(const size_t begin, const size_t end)
+    {
+        auto &fences = m_stream.fences;
+        for (auto it = fences.begin(); it != fences.end();)
+        {
+            if (it->begin < end && begin < it->end) // regions overlap
+            {
+                const auto sync = static_cast<GLsync>(it->sync);
+
+                // Poll first so that we only count actual waits as stalls
+                auto status = glClientWaitSync(sync, 0, 0);
+                if (status == GL_TIMEOUT_EXPIRED)
+                {
+                    ++m_stream.stats.stalls;
+                    do {
+                        status = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1ms
+                    } while (status == GL_TIMEOUT_EXPIRED);
+                }
+
+                glDeleteSync(sync);
+                it = fences.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    void RenderProgram::growStream(const size_t minBytes)
+    {
+        const auto stride = m_config.attributes.sizeofVertex();
+
+        auto newSize = m_stream.capacity * stride;
+        while (newSize < minBytes)
+            newSize = newSize ? newSize * 2 : minBytes;
+
+        SDGL_WARN("RenderProgram stream buffer grew from {} to {} bytes", m_stream.capacity * stride, newSize);
+
+        // Respecifying the storage orphans the old one, so in-flight regions no longer need to be waited on
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(newSize), nullptr, GL_STREAM_DRAW); GL_ERR_CHECK();
+        releaseStreamFences();
+
+        m_config.streamBufferSize = newSize;
+        m_stream.capacity = newSize / stride;
+        m_stream.head = 0;
+    }
+
+    void RenderProgram::releaseStreamFences()
+    {
+        for (const auto &fence : m_stream.fences)
+        {
+            glDeleteSync(static_cast<GLsync>(fence.sync));
+        }
+
+        m_stream.fences.clear();
+    }
+
     static int s_primitiveTypes[] = {
         GL_POINTS,
         GL_LINES,
@@ -197,19 +524,18 @@ namespace sdgl {
         SDGL_ASSERT(m_ebo);
 
         m_shader.use();
-
-        glBindVertexArray(m_vao); GL_ERR_CHECK();
+        GLState::bindVertexArray(m_vao);
 
         auto glPrimitiveType = s_primitiveTypes[primitiveType];
         if (m_indexCount > 0) // render by index
         {
-            // constrain indices for best performance of glDrawRangeElements
             offset = mathf::clampi(offset, 0, m_indexCount);
-            auto maxIndex =  mathf::clampi(offset + count - 1, offset, m_indexCount);
             count = mathf::clampi(count, 0, m_indexCount - offset + 1);
 
-            glDrawRangeElements(glPrimitiveType, offset, maxIndex, count, GL_UNSIGNED_INT, (void *)(sizeof(uint) * offset) ) ; GL_ERR_CHECK();
-            glBindVertexArray(0); GL_ERR_CHECK();
+            const auto indexSize = m_indexType == GL_UNSIGNED_SHORT ? sizeof(ushort) : sizeof(uint);
+            glDrawElements(glPrimitiveType, count, m_indexType, (void *)(indexSize * offset)); GL_ERR_CHECK();
+            ++m_drawStats.drawCalls;
+            m_drawStats.verticesDrawn += count;
         }
         else                  // render vertices directly
         {
@@ -217,29 +543,49 @@ namespace sdgl {
             count = mathf::clampi(count, 0, m_vertexCount - offset + 1);
 
             glDrawArrays(glPrimitiveType, offset, count); GL_ERR_CHECK();
-            glBindVertexArray(0); GL_ERR_CHECK();
+            ++m_drawStats.drawCalls;
+            m_drawStats.verticesDrawn += count;
         }
+    }
 
-        m_shader.unuse();
+    void RenderProgram::renderInstanced(const PrimitiveType::Enum primitiveType, const int vertexCount,
+        const int instanceCount) const
+    {
+        SDGL_ASSERT(m_shader.isLoaded());
+        SDGL_ASSERT(m_vao);
+        SDGL_ASSERT(m_config.attributes.divisor() > 0, "RenderProgram attributes must be instanced");
+
+        if (vertexCount <= 0 || instanceCount <= 0)
+            return;
+
+        m_shader.use();
+        GLState::bindVertexArray(m_vao);
+
+        glDrawArraysInstanced(s_primitiveTypes[primitiveType], 0, vertexCount, instanceCount); GL_ERR_CHECK();
+        ++m_drawStats.drawCalls;
+        m_drawStats.verticesDrawn += static_cast<size_t>(vertexCount) * instanceCount;
     }
 
     void RenderProgram::dispose()
     {
+        releaseStreamFences();
+        m_stream = {};
+
         if (m_ebo)
         {
-            glDeleteBuffers(1, &m_ebo);
+            GLState::deleteBuffer(m_ebo);
             m_ebo = 0;
         }
 
         if (m_vbo)
         {
-            glDeleteBuffers(1, &m_vbo);
+            GLState::deleteBuffer(m_vbo);
             m_vbo = 0;
         }
 
         if (m_vao)
         {
-            glDeleteVertexArrays(1, &m_vao);
+            GLState::deleteVertexArray(m_vao);
             m_vao = 0;
         }
 
@@ -34,6 +34,25 @@ namespace sdgl {
             /// Whether `vertShaer` & `fragShader` values are filepaths to be opened.
             /// If false, these fields contain code strings.
             bool openFiles;
+
+            /// Size of the streaming vertex ring buffer in bytes. When non-zero, vertices are written in place via
+            /// `mapVertices` / `unmapVertices` instead of being respecified with `setVertices`.
+            size_t streamBufferSize = 0;
+        };
+
+        /// Streaming buffer counters, accumulated until `resetStreamStats` is called
+        struct StreamStats
+        {
+            size_t bytesUploaded = 0; ///< number of vertex bytes written into the ring buffer
+            uint stalls = 0;          ///< number of times the CPU had to wait for the GPU to release a buffer region
+            uint orphans = 0;         ///< number of times the buffer storage was orphaned on wrap (no-fence fallback)
+        };
+
+        /// Draw call counters, accumulated until `resetDrawStats` is called
+        struct DrawStats
+        {
+            uint drawCalls = 0;       ///< number of draw calls issued via `render` / `renderInstanced`
+            size_t verticesDrawn = 0; ///< number of vertices processed by those draw calls
         };
 
         explicit RenderProgram(Config config);
@@ -72,8 +91,33 @@ namespace sdgl {
             return setIndices(indices.data(), static_cast<int>(indices.size()), dynamic);
         }
 
+        RenderProgram &setIndices(const ushort *indices, int count, bool dynamic = false);
+        RenderProgram &setIndices(const vector<ushort> &indices, const bool dynamic = false)
+        {
+            return setIndices(indices.data(), static_cast<int>(indices.size()), dynamic);
+        }
+
+        /// Use a static index buffer holding the pattern {0, 1, 2, 2, 3, 0} for each quad of 4 vertices.
+        /// The buffer is only rebuilt when `quadCount` exceeds its capacity; 16-bit indices are used while all quads
+        /// are addressable by them.
+        /// @param quadCount number of quads that need to be drawable
+        RenderProgram &setQuadIndices(int quadCount);
+
+        /// Offset the vertex attributes so that index 0 refers to vertex `baseVertex` in the vertex buffer.
+        /// GLES3 has no glDrawElementsBaseVertex, so this is needed to draw indexed vertices that were not written
+        /// at the start of the buffer (e.g. via `mapVertices`).
+        RenderProgram &setBaseVertex(int baseVertex);
+
+        /// Respecify the vertex buffer's storage
+        /// @param vertices data to fill it with, or nullptr to only allocate room for `count` vertices
         RenderProgram &setVertices(const void *vertices, int count, bool dynamic = false);
 
+        /// Overwrite part of the vertex buffer in place, without respecifying its storage
+        /// @param vertices data to write
+        /// @param offset   index of the first vertex to overwrite
+        /// @param count    number of vertices to write, `offset + count` must not exceed the buffer's vertex count
+        RenderProgram &updateVertices(const void *vertices, int offset, int count);
+
         template <typename T>
         RenderProgram &setVertices(const vector<T> &vertices, bool dynamic = false)
         {
@@ -88,20 +132,91 @@ namespace sdgl {
 
         void clearIndices();
 
+        /// Reserve room for `count` vertices in the streaming ring buffer. Every call must be paired with
+        /// `unmapVertices`. Without a `Config::streamBufferSize`, the vertices are staged and replace the whole
+        /// buffer as static data on unmap.
+        /// @param count number of vertices to reserve
+        /// @returns pointer to write `count` vertices into, or nullptr on failure
+        [[nodiscard]]
+        void *mapVertices(int count);
+
+        /// Commit vertices written to the pointer received from `mapVertices`
+        /// @returns index of the first committed vertex, pass this as the `offset` to `render`; or -1 if the driver
+        ///          lost the mapped vertices, which must then be mapped and written again or not drawn
+        int unmapVertices();
+
+        /// Attribute layout of the program's vertices
+        [[nodiscard]]
+        const ShaderAttribs &attributes() const { return m_config.attributes; }
+
+        /// Whether this program streams its vertices via a ring buffer
+        [[nodiscard]]
+        bool isStreaming() const { return m_config.streamBufferSize > 0; }
+
+        [[nodiscard]]
+        const StreamStats &streamStats() const { return m_stream.stats; }
+        void resetStreamStats() { m_stream.stats = {}; }
+
+        [[nodiscard]]
+        const DrawStats &drawStats() const { return m_drawStats; }
+        void resetDrawStats() { m_drawStats = {}; }
+
         /// Draw the program
         /// @param primitiveType type of primitives to render vertices with - corresponds to OpenGL mode
         /// @param offset number of vertices or indices (if setIndices was called) to begin drawing from
         /// @param count number of vertices or indices (if setIndices was called) to draw, by default all are drawn
         void render(PrimitiveType::Enum primitiveType = PrimitiveType::Triangles, int offset = 0, int count = INT_MAX) const;
 
+        /// Draw `instanceCount` instances of `vertexCount` vertices each; the program's attributes must be set up via
+        /// `ShaderAttribs::instanced`. Indices are not used. GLES3 has no base instance, so to start at a later
+        /// instance in the buffer, call `setBaseVertex` with its index first.
+        /// @param primitiveType type of primitives to render each instance with
+        /// @param vertexCount   number of vertices per instance, available in the vertex shader as `gl_VertexID`
+        /// @param instanceCount number of instances to draw
+        void renderInstanced(PrimitiveType::Enum primitiveType, int vertexCount, int instanceCount) const;
+
         /// Clean up - all calls to render after calling `dispose` will fail until `init` is called again
         void dispose();
 
     private:
+        /// Block until the GPU is done reading vertex range [begin, end) of the ring buffer
+        void waitStreamRange(size_t begin, size_t end);
+        /// Reallocate the ring buffer so that it holds at least `minBytes`
+        void growStream(size_t minBytes);
+        void releaseStreamFences();
+        /// Point vertex attributes at the currently bound array buffer, starting at `byteOffset`
+        void bindAttributes(size_t byteOffset) const;
+        RenderProgram &setIndices(const void *indices, int count, int indexType, bool dynamic);
+
+        struct StreamFence
+        {
+            size_t begin, end; ///< vertex range guarded by this fence
+            void *sync;        ///< GLsync handle
+        };
+
+        struct StreamState
+        {
+            size_t capacity = 0;        ///< ring buffer capacity in vertices
+            size_t head = 0;            ///< next vertex index to write to
+            size_t mappedBegin = 0;     ///< start of the region currently mapped
+            size_t mappedCount = 0;     ///< number of vertices currently mapped
+            bool mapped = false;        ///< whether a region is currently mapped
+            bool pendingFence = false;  ///< last committed region still needs a fence
+            bool useMapping = true;     ///< false when glMapBufferRange is unavailable: stage + orphan instead
+            vector<ubyte> staging;      ///< persistent staging memory for the no-mapping fallback
+            vector<StreamFence> fences; ///< in-flight regions, oldest first
+            StreamStats stats;
+        };
+
         uint m_vao, m_vbo, m_ebo;
         Shader m_shader;
         Config m_config;
 
         int m_indexCount, m_vertexCount;
+        int m_indexType;    ///< GL type of the indices in the element buffer
+        int m_quadCapacity; ///< number of quads held in the element buffer when set via `setQuadIndices`, or 0
+        int m_baseVertex;
+        StreamState m_stream;
+        mutable DrawStats m_drawStats{};
     };
 }
@@ -0,0 +1,51 @@
+#include "RenderStatsPlugin.h"
+#include "GLState.h"
+#include "SpriteBatchBase2D.h"
+
+#include <imgui.h>
+
+#include <algorithm>
+
+namespace sdgl {
+    void RenderStatsPlugin::endFrame()
+    {
+        if (!ImGui::GetCurrentContext()) // ImGui plugin is not active
+            return;
+
+        if (ImGui::Begin(m_title.c_str()))
+        {
+            // GL state is shared by all batches; counters cover the last frame rendered. With a render thread they
+            // are updated concurrently, so they're left out.
+            const auto threaded = std::any_of(m_sources.begin(), m_sources.end(),
+                [](const Source &source) { return source.batch && source.batch->getRenderThread(); });
+            if (!threaded)
+            {
+                const auto &glStats = GLState::stats();
+                ImGui::Text("GL state changes: %u (%u skipped)", glStats.calls, glStats.redundantCalls);
+                ImGui::Separator();
+            }
+
+            for (const auto &[name, batch] : m_sources)
+            {
+                if (!batch || !ImGui::CollapsingHeader(name.c_str(), ImGuiTreeNodeFlags_DefaultOpen))
+                    continue;
+
+                const auto &stats = batch->stats();
+                ImGui::Text("Sprites:         %u (%u culled)", stats.sprites, stats.culledSprites);
+                ImGui::Text("Batches:         %u (%u unsorted, %u clustered sprites)", stats.batches,
+                    stats.baselineBatches, stats.clusteredSprites);
+                ImGui::Text("Draw calls:      %u", stats.drawCalls);
+                ImGui::Text("Texture binds:   %u", stats.textureBinds);
+                ImGui::Text("Uniform uploads: %u", stats.uniformUploads);
+                ImGui::Text("Uploaded:        %.1f KiB", static_cast<double>(stats.bytesUploaded) / 1024.0);
+                ImGui::Separator();
+                ImGui::Text("Sort:   %.3f ms", stats.sortTime);
+                ImGui::Text("Batch:  %.3f ms", stats.batchTime);
+                ImGui::Text("Render: %.3f ms", stats.renderTime);
+            }
+        }
+        ImGui::End();
+
+        GLState::resetStats();
+    }
+}
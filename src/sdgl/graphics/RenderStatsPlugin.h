@@ -0,0 +1,36 @@
+#pragma once
+#include <sdgl/core/IPlugin.h>
+#include <sdgl/sdglib.h>
+
+namespace sdgl {
+    class SpriteBatchBase2D;
+
+    /// Shows the `SpriteBatchStats` of one or more sprite batches in an ImGui window.
+    /// Requires the ImGui plugin; add via `Window::plugins()->addPlugin(new RenderStatsPlugin({...}))`.
+    class RenderStatsPlugin final : public IPlugin, public IFramePlugin {
+    public:
+        struct Source
+        {
+            string name;                    ///< header to show the batch's stats under
+            const SpriteBatchBase2D *batch; ///< batch to read stats from, must outlive this plugin
+        };
+
+        explicit RenderStatsPlugin(vector<Source> sources, string title = "Render Stats") :
+            m_sources(std::move(sources)), m_title(std::move(title)) { }
+
+        bool init() override { return true; }
+        void shutdown() override { }
+
+        void startFrame() override { }
+        /// Builds the window; runs before the ImGui plugin renders its frame
+        void endFrame() override;
+
+        /** Lower than the ImGui plugin, so that it wraps this plugin's frame */
+        [[nodiscard]]
+        int framePriority() const override { return -1; }
+
+    private:
+        vector<Source> m_sources;
+        string m_title;
+    };
+}
@@ -0,0 +1,225 @@
+#include "RenderThread.h"
+#include "GLState.h"
+
+#include <sdgl/angles.h>
+#include <sdgl/assert.h>
+#include <sdgl/logging.h>
+#include <sdgl/core/Window.h>
+
+namespace sdgl {
+    /// Id of the running render thread, or a default id while none is running
+    static std::atomic<std::thread::id> s_renderThreadId;
+
+    RenderThread::RenderThread() : m_window(), m_thread(), m_mutex(), m_signal(), m_buffers(), m_recording(0),
+        m_pending(), m_executing(false), m_viewport(), m_syncCallback(), m_quit(false)
+    {
+    }
+
+    RenderThread::~RenderThread()
+    {
+        stop();
+    }
+
+    bool RenderThread::start(Window *window)
+    {
+        if (isRunning())
+        {
+            SDGL_ERROR("RenderThread is already running");
+            return false;
+        }
+
+        m_window = window;
+        m_quit = false;
+        m_pending = nullptr;
+        m_executing = false;
+        m_syncCallback = nullptr;
+        m_recording = 0;
+        m_buffers[0].clear();
+        m_buffers[1].clear();
+
+        // a context may only be current on one thread at a time
+        if (window)
+        {
+            window->setRenderThread(this);
+            window->releaseCurrent();
+        }
+
+        try
+        {
+            m_thread = std::thread(&RenderThread::run, this);
+            s_renderThreadId = m_thread.get_id();
+        }
+        catch(const std::exception &e)
+        {
+            SDGL_ERROR("RenderThread failed to start: {}", e.what());
+            if (window)
+            {
+                window->setRenderThread(nullptr);
+                window->makeCurrent();
+            }
+            return false;
+        }
+
+        return true;
+    }
+
+    void RenderThread::stop()
+    {
+        if (!isRunning())
+            return;
+
+        {
+            std::unique_lock lock(m_mutex);
+            m_signal.wait(lock, [this] { return !m_pending && !m_executing && !m_syncCallback; });
+            m_quit = true;
+        }
+        m_signal.notify_all();
+        m_thread.join();
+        s_renderThreadId = std::thread::id();
+
+        m_buffers[m_recording].clear(); // discard a frame recorded but never submitted
+        if (m_window)
+        {
+            m_window->setRenderThread(nullptr);
+            m_window->makeCurrent();
+            GLState::invalidate();
+        }
+    }
+
+    void RenderThread::submit()
+    {
+        if (!isRunning())
+        {
+            SDGL_ERROR("RenderThread::submit called while the thread isn't running");
+            m_buffers[m_recording].clear();
+            return;
+        }
+
+        int width = 0, height = 0;
+        if (m_window)
+            m_window->getFrameBufferSize(&width, &height);
+
+        {
+            std::unique_lock lock(m_mutex);
+            m_signal.wait(lock, [this] { return !m_pending && !m_executing; });
+
+            m_pending = &m_buffers[m_recording];
+            m_viewport[0] = width;
+            m_viewport[1] = height;
+            m_recording = 1 - m_recording;
+        }
+        m_signal.notify_all();
+
+        // the other buffer finished executing before it was handed back
+        m_buffers[m_recording].clear();
+    }
+
+    void RenderThread::wait()
+    {
+        if (!isRunning())
+            return;
+
+        std::unique_lock lock(m_mutex);
+        m_signal.wait(lock, [this] { return !m_pending && !m_executing; });
+    }
+
+    void RenderThread::invokeSync(const std::function<void()> &callback)
+    {
+        if (!isRunning())
+        {
+            callback();
+            return;
+        }
+
+        std::unique_lock lock(m_mutex);
+        m_signal.wait(lock, [this] { return !m_syncCallback; });
+        m_syncCallback = &callback;
+        m_signal.notify_all();
+        m_signal.wait(lock, [this, &callback] { return m_syncCallback != &callback; });
+    }
+
+    bool RenderThread::isRenderThread()
+    {
+        const auto id = s_renderThreadId.load();
+        return id == std::thread::id() || id == std::this_thread::get_id();
+    }
+
+    void RenderThread::run()
+    {
+        if (m_window)
+        {
+            m_window->makeCurrent();
+            GLState::invalidate(); // bindings shadowed so far belong to the other thread's view
+        }
+
+        int viewport[2] = {-1, -1};
+        while (true)
+        {
+            RenderCommandBuffer *frame = nullptr;
+            const std::function<void()> *callback = nullptr;
+            int width, height;
+            {
+                std::unique_lock lock(m_mutex);
+                m_signal.wait(lock, [this] { return m_pending || m_syncCallback || m_quit; });
+
+                // a frame submitted before a callback was posted executes first, since the callback may start the
+                // next frame or delete resources the frame still uses
+                if (m_pending)
+                {
+                    frame = m_pending;
+                    width = m_viewport[0];
+                    height = m_viewport[1];
+                    m_executing = true;
+                }
+                else if (m_syncCallback)
+                {
+                    callback = m_syncCallback;
+                }
+                else // quit once everything was executed
+                {
+                    break;
+                }
+            }
+
+            try
+            {
+                if (callback)
+                {
+                    (*callback)();
+                }
+                else
+                {
+                    if (m_window && (width != viewport[0] || height != viewport[1]))
+                    {
+                        glViewport(0, 0, width, height); GL_ERR_CHECK();
+                        viewport[0] = width;
+                        viewport[1] = height;
+                    }
+
+                    frame->execute();
+                }
+            }
+            catch(const std::exception &e)
+            {
+                SDGL_ERROR("RenderThread: exception while executing commands: {}", e.what());
+            }
+
+            {
+                std::lock_guard lock(m_mutex);
+                if (callback)
+                {
+                    m_syncCallback = nullptr;
+                }
+                else
+                {
+                    m_pending = nullptr;
+                    m_executing = false;
+                }
+            }
+            m_signal.notify_all();
+        }
+
+        if (m_window)
+            m_window->releaseCurrent();
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "RenderCommandBuffer.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace sdgl {
+    class Window;
+
+    /// Dedicated thread that owns a window's GL context and executes frames of recorded commands.
+    /// The main thread records frame N into one command buffer while the render thread executes frame N-1 from the
+    /// other, so that simulation and GL submission overlap. While running, GL calls must not be made from any
+    /// other thread: record them via `commands().invoke` or run them with `invokeSync` instead.
+    class RenderThread {
+    public:
+        RenderThread();
+        ~RenderThread();
+
+        RenderThread(const RenderThread &) = delete;
+        RenderThread &operator=(const RenderThread &) = delete;
+
+        /// Hand `window`'s GL context over to a newly started render thread. The context must be current on the
+        /// calling thread.
+        /// @param window window whose context to take over, or nullptr to execute commands without a GL context,
+        ///               e.g. when they only invoke callbacks
+        /// @returns whether the thread started
+        bool start(Window *window);
+
+        /// Execute all submitted frames, then stop the thread and make the GL context current on the calling
+        /// thread again
+        void stop();
+
+        [[nodiscard]]
+        bool isRunning() const { return m_thread.joinable(); }
+
+        /// Command buffer of the frame currently being recorded
+        [[nodiscard]]
+        RenderCommandBuffer &commands() { return m_buffers[m_recording]; }
+
+        /// Hand the recorded frame over to the render thread. Waits for the previous frame to finish executing
+        /// first, so that at most one frame is in flight while the next is recorded.
+        void submit();
+
+        /// Block until all submitted frames were executed
+        void wait();
+
+        /// Run `callback` on the render thread and wait for it to return, e.g. to load textures while running.
+        /// Frames submitted before the call are executed first. Runs it right away when the thread isn't running.
+        void invokeSync(const std::function<void()> &callback);
+
+        /// Whether GL calls may be made from the calling thread: it's the running render thread, or no render thread
+        /// is running, in which case the thread holding the context is trusted to be the caller
+        [[nodiscard]]
+        static bool isRenderThread();
+
+    private:
+        void run();
+
+        Window *m_window;
+        std::thread m_thread;
+        std::mutex m_mutex;
+        std::condition_variable m_signal;
+
+        RenderCommandBuffer m_buffers[2];
+        int m_recording;                 ///< index of the buffer being recorded into
+        RenderCommandBuffer *m_pending;  ///< submitted frame waiting to be executed, or nullptr
+        bool m_executing;                ///< whether the render thread is executing a frame
+        int m_viewport[2];               ///< framebuffer size to apply before the pending frame
+
+        const std::function<void()> *m_syncCallback; ///< callback passed to `invokeSync`, or nullptr
+        bool m_quit;
+    };
+}
@@ -4,6 +4,8 @@
 #include <sdgl/logging.h>
 #include <sdgl/io/io.h>
 
+#include "GLState.h"
+
 #include <sdgl/angles.h>
 #include <glm/glm.hpp>
 
@@ -19,7 +21,7 @@ namespace sdgl {
     {
         if (m_program)
         {
-            glDeleteProgram(m_program);
+            GLState::deleteProgram(m_program);
         }
     }
 
@@ -27,7 +29,7 @@ namespace sdgl {
     {
         if (m_program)
         {
-            glDeleteProgram(m_program);
+            GLState::deleteProgram(m_program);
         }
 
         m_program = other.m_program;
@@ -49,7 +51,7 @@ namespace sdgl {
 
         if (!linkProgram(program, vs, fs, true))
         {
-            glDeleteProgram(program);
+            GLState::deleteProgram(program);
             return false;
         }
 
@@ -74,7 +76,7 @@ namespace sdgl {
 
         if (!linkProgram(program, vs, fs, true))
         {
-            glDeleteProgram(program);
+            GLState::deleteProgram(program);
             return false;
         }
 
@@ -105,8 +107,10 @@ namespace sdgl {
 
     Shader &Shader::setUniform(int location, const float *value, int count)
     {
-        glUseProgram(m_program);
-        GL_ERR_CHECK();
+        if (!GLState::setUniform(m_program, location, value, sizeof(float) * count))
+            return *this;
+        ++m_stats.uniformUploads;
+        GLState::useProgram(m_program);
         glUniform1fv(location, count, value);
         GL_ERR_CHECK();
         return *this;
@@ -114,7 +118,11 @@ namespace sdgl {
 
     Shader &Shader::setUniform(int location, const glm::mat4 *value, int count, bool transpose)
     {
-        glUseProgram(m_program);
+        // GL transposes on upload, so the same matrix uploaded with the other layout is a different value
+        if (!GLState::setUniform(m_program, location, value, sizeof(glm::mat4) * count, transpose))
+            return *this;
+        ++m_stats.uniformUploads;
+        GLState::useProgram(m_program);
         glUniformMatrix4fv(location, count, transpose, &(*value)[0][0]);
         GL_ERR_CHECK();
         return *this;
@@ -122,8 +130,10 @@ namespace sdgl {
 
     Shader &Shader::setUniform(int location, const glm::vec4 *value, int count)
     {
-        glUseProgram(m_program);
-        GL_ERR_CHECK();
+        if (!GLState::setUniform(m_program, location, value, sizeof(glm::vec4) * count))
+            return *this;
+        ++m_stats.uniformUploads;
+        GLState::useProgram(m_program);
         glUniform4fv(location, count, &value->x);
         GL_ERR_CHECK();
         return *this;
@@ -131,8 +141,10 @@ namespace sdgl {
 
     Shader &Shader::setUniform(int location, const glm::vec3 *value, int count)
     {
-        glUseProgram(m_program);
-        GL_ERR_CHECK();
+        if (!GLState::setUniform(m_program, location, value, sizeof(glm::vec3) * count))
+            return *this;
+        ++m_stats.uniformUploads;
+        GLState::useProgram(m_program);
         glUniform3fv(location, count, &value->x);
         GL_ERR_CHECK();
         return *this;
@@ -140,8 +152,10 @@ namespace sdgl {
 
     Shader &Shader::setUniform(int location, const glm::vec2 *value, int count)
     {
-        glUseProgram(m_program);
-        GL_ERR_CHECK();
+        if (!GLState::setUniform(m_program, location, value, sizeof(glm::vec2) * count))
+            return *this;
+        ++m_stats.uniformUploads;
+        GLState::useProgram(m_program);
         glUniform2fv(location, count, &value->x);
         GL_ERR_CHECK();
         return *this;
@@ -149,8 +163,10 @@ namespace sdgl {
 
     Shader &Shader::setUniform(int location, const int *value, int count)
     {
-        glUseProgram(m_program);
-        GL_ERR_CHECK();
+        if (!GLState::setUniform(m_program, location, value, sizeof(int) * count))
+            return *this;
+        ++m_stats.uniformUploads;
+        GLState::useProgram(m_program);
         glUniform1iv(location, count, value);
         GL_ERR_CHECK();
         return *this;
@@ -158,8 +174,10 @@ namespace sdgl {
 
     Shader &Shader::setUniform(int location, const uint *value, int count)
     {
-        glUseProgram(m_program);
-        GL_ERR_CHECK();
+        if (!GLState::setUniform(m_program, location, value, sizeof(uint) * count))
+            return *this;
+        ++m_stats.uniformUploads;
+        GLState::useProgram(m_program);
         glUniform1uiv(location, count, value);
         GL_ERR_CHECK();
         return *this;
@@ -167,21 +185,26 @@ namespace sdgl {
 
     Shader &Shader::setUniform(int location, const Texture2D *textures, int count, int slot)
     {
-        glUseProgram(m_program);
-        GL_ERR_CHECK();
+        SDGL_ASSERT(slot >= 0 && count >= 0 && slot + count <= 32);
+
+        // bind each texture to consecutive units, then point the sampler array at them in one call
+        int units[32];
         for (auto i = 0; i < count; ++i)
         {
-            setUniform(location, textures[i], slot + i);
-            GL_ERR_CHECK();
+            if (GLState::bindTexture(slot + i, textures[i].id()))
+                ++m_stats.textureBinds;
+            units[i] = slot + i;
         }
 
-        return *this;
+        return setUniform(location, units, count);
     }
 
     Shader &Shader::setUniform(const int location, const float value)
     {
-        glUseProgram(m_program);
-        GL_ERR_CHECK();
+        if (!GLState::setUniform(m_program, location, &value, sizeof(value)))
+            return *this;
+        ++m_stats.uniformUploads;
+        GLState::useProgram(m_program);
         glUniform1f(location, value);
         GL_ERR_CHECK();
         return *this;
@@ -189,17 +212,15 @@ namespace sdgl {
 
     Shader &Shader::setUniform(int location, const glm::mat4 &value, bool transpose)
     {
-        glUseProgram(m_program);
-        GL_ERR_CHECK();
-        glUniformMatrix4fv(location, 1, transpose, &value[0][0]);
-        GL_ERR_CHECK();
-        return *this;
+        return setUniform(location, &value, 1, transpose);
     }
 
     Shader &Shader::setUniform(int location, const glm::vec4 &value)
     {
-        glUseProgram(m_program);
-        GL_ERR_CHECK();
+        if (!GLState::setUniform(m_program, location, &value, sizeof(value)))
+            return *this;
+        ++m_stats.uniformUploads;
+        GLState::useProgram(m_program);
         glUniform4f(location, value.x, value.y, value.z, value.w);
         GL_ERR_CHECK();
         return *this;
@@ -207,8 +228,10 @@ namespace sdgl {
 
     Shader &Shader::setUniform(int location, const glm::vec3 &value)
     {
-        glUseProgram(m_program);
-        GL_ERR_CHECK();
+        if (!GLState::setUniform(m_program, location, &value, sizeof(value)))
+            return *this;
+        ++m_stats.uniformUploads;
+        GLState::useProgram(m_program);
         glUniform3f(location, value.x, value.y, value.z);
         GL_ERR_CHECK();
         return *this;
@@ -216,8 +239,10 @@ namespace sdgl {
 
     Shader &Shader::setUniform(int location, const glm::vec2 &value)
     {
-        glUseProgram(m_program);
-        GL_ERR_CHECK();
+        if (!GLState::setUniform(m_program, location, &value, sizeof(value)))
+            return *this;
+        ++m_stats.uniformUploads;
+        GLState::useProgram(m_program);
         glUniform2f(location, value.x, value.y);
         GL_ERR_CHECK();
         return *this;
@@ -225,15 +250,20 @@ namespace sdgl {
 
     Shader & Shader::setUniform(int location, const Vector2 &value)
     {
-        glUseProgram(m_program); GL_ERR_CHECK();
+        if (!GLState::setUniform(m_program, location, &value, sizeof(value)))
+            return *this;
+        ++m_stats.uniformUploads;
+        GLState::useProgram(m_program);
         glUniform2f(location, value.x, value.y); GL_ERR_CHECK();
         return *this;
     }
 
     Shader &Shader::setUniform(const int location, const int value)
     {
-        glUseProgram(m_program);
-        GL_ERR_CHECK();
+        if (!GLState::setUniform(m_program, location, &value, sizeof(value)))
+            return *this;
+        ++m_stats.uniformUploads;
+        GLState::useProgram(m_program);
         glUniform1i(location, value);
         GL_ERR_CHECK();
         return *this;
@@ -241,82 +271,45 @@ namespace sdgl {
 
     Shader &Shader::setUniform(const int location, const uint value)
     {
-        glUseProgram(m_program);
-        GL_ERR_CHECK();
+        if (!GLState::setUniform(m_program, location, &value, sizeof(value)))
+            return *this;
+        ++m_stats.uniformUploads;
+        GLState::useProgram(m_program);
         glUniform1ui(location, value);
         GL_ERR_CHECK();
         return *this;
     }
 
-    static int s_textureSlots[32] = {
-        GL_TEXTURE0,
-        GL_TEXTURE1,
-        GL_TEXTURE2,
-        GL_TEXTURE3,
-        GL_TEXTURE4,
-        GL_TEXTURE5,
-        GL_TEXTURE6,
-        GL_TEXTURE7,
-        GL_TEXTURE8,
-        GL_TEXTURE9,
-        GL_TEXTURE10,
-        GL_TEXTURE11,
-        GL_TEXTURE12,
-        GL_TEXTURE13,
-        GL_TEXTURE14,
-        GL_TEXTURE15,
-        GL_TEXTURE16,
-        GL_TEXTURE17,
-        GL_TEXTURE18,
-        GL_TEXTURE19,
-        GL_TEXTURE20,
-        GL_TEXTURE21,
-        GL_TEXTURE22,
-        GL_TEXTURE23,
-        GL_TEXTURE24,
-        GL_TEXTURE25,
-        GL_TEXTURE26,
-        GL_TEXTURE27,
-        GL_TEXTURE28,
-        GL_TEXTURE29,
-        GL_TEXTURE30,
-        GL_TEXTURE31,
-    };
-
     Shader &Shader::setUniform(int location, const Texture2D &texture, int slot)
     {
         SDGL_ASSERT(slot >= 0 && slot < 32);
 
-        glActiveTexture(s_textureSlots[slot]); GL_ERR_CHECK();
-        glBindTexture(GL_TEXTURE_2D, texture.id()); GL_ERR_CHECK();
-        glUseProgram(m_program); GL_ERR_CHECK();
-        glUniform1i(location, slot); GL_ERR_CHECK();
-        return *this;
+        if (GLState::bindTexture(slot, texture.id()))
+            ++m_stats.textureBinds;
+        return setUniform(location, slot);
     }
 
     Shader &Shader::setUniformMatrix(int location, const float *value, bool transpose)
     {
-        glUseProgram(m_program); GL_ERR_CHECK();
-        glUniformMatrix4fv(location, 1, transpose, value); GL_ERR_CHECK();
-        return *this;
+        return setUniform(location, reinterpret_cast<const glm::mat4 *>(value), 1, transpose);
     }
 
     void Shader::use() const
     {
         SDGL_ASSERT(m_program);
-        glUseProgram(m_program); GL_ERR_CHECK();
+        GLState::useProgram(m_program);
     }
 
     void Shader::unuse() const
     {
-        glUseProgram(0); GL_ERR_CHECK();
+        GLState::useProgram(0);
     }
 
     void Shader::dispose()
     {
         if (m_program)
         {
-            glDeleteProgram(m_program);
+            GLState::deleteProgram(m_program);
             m_program = 0;
         }
     }
@@ -107,6 +107,17 @@ namespace sdgl {
 
         void unuse() const;
 
+        /// Uniform and texture counters, accumulated until `resetStats` is called
+        struct Stats
+        {
+            uint uniformUploads = 0; ///< number of setUniform calls, arrays count once
+            uint textureBinds = 0;   ///< number of textures bound to texture units
+        };
+
+        [[nodiscard]]
+        const Stats &stats() const { return m_stats; }
+        void resetStats() { m_stats = {}; }
+
         /**
          * Delete loaded shader program
          */
@@ -117,6 +128,7 @@ namespace sdgl {
         static bool linkProgram(uint program, uint vs, uint fs, bool deleteShaders = true);
 
         uint m_program;
+        Stats m_stats{};
 
     };
 }
@@ -122,6 +122,14 @@ namespace sdgl {
         [[nodiscard]]
         auto size() const { return m_attribs.size(); }
 
+        /// Advance all attributes once per `divisor` instances instead of once per vertex, so that each element in
+        /// the vertex buffer holds the data of an instance. Draw with `RenderProgram::renderInstanced`.
+        ShaderAttribs &instanced(const uint divisor = 1) { m_divisor = divisor; return *this; }
+
+        /// Number of instances each element in the vertex buffer spans, or 0 if attributes advance per vertex
+        [[nodiscard]]
+        auto divisor() const { return m_divisor; }
+
         /// The byte size of one vertex
         [[nodiscard]]
         auto sizeofVertex() const { return m_sizeofVertex; }
@@ -134,6 +142,7 @@ namespace sdgl {
         vector<Attribute> m_attribs{};
         size_t m_sizeofVertex{0};
         size_t m_vertexTypeHash{0};
+        uint m_divisor{0};
     };
 
 
@@ -1,10 +1,24 @@
 #include "SpriteBatch2D.h"
 
+#include <sdgl/math/mathf.h>
+
+#include <algorithm>
+#include <cmath>
+
 namespace sdgl {
-    void SpriteBatch2D::init()
+    /// Upper limit of segments per curve, however large it appears on screen
+    static constexpr int MaxShapeSegments = 512;
+
+    /// Source rectangle of the pixel texture
+    static constexpr Rectangle PixelSource = {0, 0, 1, 1};
+
+    SpriteBatch2D::SpriteBatch2D() : m_pixel(), m_shapeTolerance(.25f), m_shapePoints()
+    { }
+
+    void SpriteBatch2D::init(const SpritePath::Enum path, const int textureSlots, const VertexFormat::Enum format)
     {
         m_pixel.loadBytes({Color::White}, 1, 1, TextureFilter::Nearest);
-        SpriteBatchBase2D::init();
+        SpriteBatchBase2D::init(path, textureSlots, format);
     }
 
     void SpriteBatch2D::drawTexture(const Texture2D &texture, Rectangle source,
@@ -36,4 +50,123 @@ namespace sdgl {
         SpriteBatchBase2D::drawTexture(texture, {0, 0, texSize.x, texSize.y}, position, tint,
                     scale, anchor, angle, depth);
     }
-}
\ No newline at end of file
+
+    void SpriteBatch2D::drawRectangleOutline(const Rectangle rect, const Color tint, float thickness, const float depth)
+    {
+        const auto left = static_cast<float>(rect.x), top = static_cast<float>(rect.y);
+        const auto right = left + static_cast<float>(rect.w), bottom = top + static_cast<float>(rect.h);
+        thickness = std::min({thickness, (right - left) * .5f, (bottom - top) * .5f});
+        if (thickness <= 0)
+            return;
+
+        // top and bottom edges span the full width, left and right edges fit in between them
+        const auto edge = [this, tint, depth](const float l, const float t, const float r, const float b) {
+            drawQuad(m_pixel, PixelSource, {l, t}, {l, b}, {r, t}, {r, b}, tint, depth);
+        };
+        edge(left, top, right, top + thickness);
+        edge(left, bottom - thickness, right, bottom);
+        edge(left, top + thickness, left + thickness, bottom - thickness);
+        edge(right - thickness, top + thickness, right, bottom - thickness);
+    }
+
+    void SpriteBatch2D::drawLine(const Vector2 start, const Vector2 end, const Color tint, const float thickness,
+        const float depth)
+    {
+        const auto direction = (end - start).normal();
+        if (direction == Vector2::Zero)
+            return;
+
+        // offset both ends perpendicular to the line by half the thickness
+        const auto side = Vector2(-direction.y, direction.x) * (thickness * .5f);
+        drawQuad(m_pixel, PixelSource, start - side, start + side, end - side, end + side, tint, depth);
+    }
+
+    void SpriteBatch2D::drawTriangle(const Vector2 a, const Vector2 b, const Vector2 c, const Color tint,
+        const float depth)
+    {
+        drawQuad(m_pixel, PixelSource, a, b, c, c, tint, depth);
+    }
+
+    void SpriteBatch2D::drawCircle(const Vector2 center, const float radius, const Color tint, const float depth)
+    {
+        if (radius <= 0)
+            return;
+
+        const auto segments = segmentCount(radius, mathf::TwoPi, 3);
+        auto &points = m_shapePoints;
+        points.resize(segments + 1);
+        for (int i = 0; i < segments; ++i)
+        {
+            const auto angle = mathf::TwoPi * static_cast<float>(i) / static_cast<float>(segments);
+            points[i] = {center.x + std::cos(angle) * radius, center.y + std::sin(angle) * radius};
+        }
+        points[segments] = points[0]; // close the fan
+
+        drawFan(center, points.data(), points.size(), tint, depth);
+    }
+
+    void SpriteBatch2D::drawArc(const Vector2 center, const float radius, const float startAngle,
+        const float endAngle, const Color tint, const float thickness, const float depth)
+    {
+        const auto inner = std::max(radius - thickness * .5f, 0.f);
+        const auto outer = radius + thickness * .5f;
+        if (outer <= 0 || startAngle == endAngle)
+            return;
+
+        // one quad per segment, spanning from the inner to the outer edge
+        const auto angle = endAngle - startAngle;
+        const auto segments = segmentCount(outer, angle, 1);
+        auto lastCos = std::cos(startAngle), lastSin = std::sin(startAngle);
+        for (int i = 1; i <= segments; ++i)
+        {
+            const auto a = startAngle + angle * static_cast<float>(i) / static_cast<float>(segments);
+            const auto c = std::cos(a), s = std::sin(a);
+            drawQuad(m_pixel, PixelSource,
+                {center.x + lastCos * outer, center.y + lastSin * outer},
+                {center.x + lastCos * inner, center.y + lastSin * inner},
+                {center.x + c * outer, center.y + s * outer},
+                {center.x + c * inner, center.y + s * inner},
+                tint, depth);
+            lastCos = c;
+            lastSin = s;
+        }
+    }
+
+    void SpriteBatch2D::drawPolygon(const span<const Vector2> points, const Color tint, const float depth)
+    {
+        if (points.size() < 3)
+            return;
+
+        // a convex polygon is a fan around any of its corners
+        drawFan(points[0], points.data() + 1, points.size() - 1, tint, depth);
+    }
+
+    void SpriteBatch2D::setShapeTolerance(const float pixels)
+    {
+        SDGL_ASSERT(pixels > 0, "Shape tolerance must be positive");
+        m_shapeTolerance = pixels;
+    }
+
+    int SpriteBatch2D::segmentCount(const float radius, const float angle, const int minSegments) const
+    {
+        // a chord spanning `step` radians strays radius * (1 - cos(step / 2)) from the arc
+        const auto screenRadius = radius * m_pixelScale;
+        if (screenRadius <= m_shapeTolerance)
+            return minSegments;
+
+        const auto step = 2.f * std::acos(1.f - m_shapeTolerance / screenRadius);
+        const auto segments = static_cast<int>(std::ceil(std::abs(angle) / step));
+        return std::clamp(segments, minSegments, MaxShapeSegments);
+    }
+
+    void SpriteBatch2D::drawFan(const Vector2 center, const Vector2 *points, const size_t count, const Color tint,
+        const float depth)
+    {
+        // each quad holds the triangles (center, p[i], p[i + 1]) and (p[i + 1], p[i + 2], center)
+        for (size_t i = 0; i + 1 < count; i += 2)
+        {
+            const auto topright = i + 2 < count ? points[i + 2] : points[i + 1]; // odd triangle out
+            drawQuad(m_pixel, PixelSource, center, points[i], topright, points[i + 1], tint, depth);
+        }
+    }
+}
@@ -3,17 +3,54 @@
 #include "Texture2D.h"
 
 namespace sdgl {
-    /// Provides some convenience functions in addition to the base class
+    /// Provides some convenience functions in addition to the base class.
+    /// Shapes are drawn with a 1x1 white texture into the same vertex stream as sprites, so they sort and batch
+    /// along with them. Apart from `drawRectangle`, they require `SpritePath::PerVertex`, i.e. quads submitted as
+    /// `QuadMode::Vertices` or `QuadMode::Indexed`; on `SpritePath::Instanced` they are skipped (see `drawQuad`).
     class SpriteBatch2D : public SpriteBatchBase2D {
     public:
+        SpriteBatch2D();
         ~SpriteBatch2D() override = default;
 
-        void init() override;
+        void init(SpritePath::Enum path = SpritePath::PerVertex, int textureSlots = 1,
+            VertexFormat::Enum format = VertexFormat::Float) override;
 
         void drawRectangle(Rectangle rect, Color tint = Color::White,
             Vector2 scale = {1.f, 1.f}, Vector2 anchor = {0, 0},
             float angle = 0, float depth = 0);
 
+        /// Draw the outline of a rectangle, e.g. for UI borders
+        /// @param thickness line width in pixels, drawn inside of `rect`
+        void drawRectangleOutline(Rectangle rect, Color tint = Color::White, float thickness = 1.f, float depth = 0);
+
+        /// Draw a line from `start` to `end`
+        /// @param thickness line width in pixels, centered on the line
+        void drawLine(Vector2 start, Vector2 end, Color tint = Color::White, float thickness = 1.f, float depth = 0);
+
+        /// Draw a filled triangle
+        void drawTriangle(Vector2 a, Vector2 b, Vector2 c, Color tint = Color::White, float depth = 0);
+
+        /// Draw a filled circle, tessellated according to its size on screen (see `setShapeTolerance`)
+        void drawCircle(Vector2 center, float radius, Color tint = Color::White, float depth = 0);
+
+        /// Draw a circular arc as a line, tessellated according to its size on screen (see `setShapeTolerance`).
+        /// Pass 0 and `mathf::TwoPi` as angles to draw the outline of a circle.
+        /// @param startAngle angle in radians to start the arc at, 0 points right and angles increase clockwise
+        /// @param endAngle   angle in radians to end the arc at
+        /// @param thickness  line width in pixels, centered on `radius`
+        void drawArc(Vector2 center, float radius, float startAngle, float endAngle, Color tint = Color::White,
+            float thickness = 1.f, float depth = 0);
+
+        /// Draw a filled convex polygon; concave polygons are not filled correctly
+        /// @param points corners of the polygon in winding order, at least 3
+        void drawPolygon(span<const Vector2> points, Color tint = Color::White, float depth = 0);
+
+        /// Set the max distance in screen pixels that a tessellated curve may stray from the true curve.
+        /// Smaller values use more triangles. The screen size of curves is taken from the camera passed to `begin`.
+        void setShapeTolerance(float pixels);
+        [[nodiscard]]
+        float getShapeTolerance() const { return m_shapeTolerance; }
+
         /// Draw entire texture
         void drawTexture(
             const Texture2D &texture,     ///< texture to draw
@@ -31,6 +68,15 @@ namespace sdgl {
                             Vector2 anchor = {0, 0}, float angle = 0,
                             float depth = 0);
     private:
+        /// Number of segments to tessellate an arc of `radius` spanning `angle` radians with
+        [[nodiscard]]
+        int segmentCount(float radius, float angle, int minSegments) const;
+
+        /// Draw triangles (center, points[i], points[i + 1]), two per quad
+        void drawFan(Vector2 center, const Vector2 *points, size_t count, Color tint, float depth);
+
         Texture2D m_pixel;
+        float m_shapeTolerance;
+        vector<Vector2> m_shapePoints; ///< scratch buffer for tessellated shapes
     };
 }
@@ -1,6 +1,9 @@
 #include "SpriteBatchBase2D.h"
+#include "RenderThread.h"
 #include "spriteBatch2DShader.inl"
 
+#include <sdgl/angles.h>
+#include <sdgl/Camera2D.h>
 #include <sdgl/math/geometry.h>
 
 #include <sdgl/graphics/font/Glyph.h>
@@ -8,29 +11,129 @@
 
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__AVX2__)
+#   include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#   include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#   include <arm_neon.h>
+#endif
+
 namespace sdgl {
     static constexpr int VertsPerQuad = 6;
 
-    SpriteBatchBase2D::SpriteBatchBase2D() :
-        m_glyphs(), m_batches(),
-        m_sortOrder(SortOrder::BackToFront),
-        m_program(), m_batchStarted(false), u_texture(),
-        u_projMtx(), u_texSize(), m_matrix()
+    /// Initial size of the vertex ring buffer, it grows if a single batch needs more room
+    static constexpr size_t DefaultStreamBufferSize = 4 * 1024 * 1024;
+
+    using Clock = std::chrono::steady_clock;
+
+    /// Projection used when `begin` was passed no matrix
+    static const glm::mat4 IdentityMatrix{1.f};
+
+    static double toMilliseconds(const Clock::duration duration)
     {
+        return std::chrono::duration<double, std::milli>(duration).count();
     }
 
-    void SpriteBatchBase2D::init()
+    SpriteBatchBase2D::SpriteBatchBase2D() : m_retained(false), m_pixelScale(1.f),
+        m_glyphs(), m_quads(), m_instances(), m_sortKeys(), m_sortScratch(), m_batches(), m_batchTextures(),
+        m_sortOrder(SortOrder::BackToFront), m_quadMode(QuadMode::Vertices), m_path(SpritePath::PerVertex),
+        m_vertexFormat(VertexFormat::Float), m_textureSlots(1), m_program(), m_renderThread(), m_stats(),
+        m_clusterTextures(false), m_clusterDepthTolerance(0), m_clusterRuns(), m_cull(false), m_cullBounds(),
+        m_visibleSprites(), m_reportedInstancedQuads(false), m_batchStarted(false), u_texture(), u_projMtx(),
+        u_texSize(), m_matrix()
     {
+    }
+
+    // Layouts only upload a texture slot when batching across several; with one, the shaders sample slot 0
+
+    template <typename V>
+    static ShaderAttribs floatVertexAttribs()
+    {
+        auto attribs = ShaderAttribs()
+            .attrib(&V::position, GLType::Float, 2)
+            .attrib(&V::texcoord, GLType::Float, 2)
+            .attrib(&V::color, GLType::Ubyte, 4, true);
+        if constexpr (requires { &V::slot; })
+            attribs.attrib(&V::slot);
+        return attribs;
+    }
+
+    template <typename V>
+    static ShaderAttribs packedVertexAttribs()
+    {
+        auto attribs = ShaderAttribs()
+            .attrib(&V::position)
+            .attrib(&V::texcoord)
+            .attrib(&V::color, GLType::Ubyte, 4, true);
+        if constexpr (requires { &V::slot; })
+            attribs.attrib(&V::slot);
+        return attribs;
+    }
+
+    template <typename I>
+    static ShaderAttribs instanceAttribs()
+    {
+        auto attribs = ShaderAttribs()
+            .attrib(&I::position, GLType::Float, 2)
+            .attrib(&I::scale, GLType::Float, 2)
+            .attrib(&I::anchor, GLType::Float, 2)
+            .attrib(&I::angle)
+            .attrib(&I::source)
+            .attrib(&I::color, GLType::Ubyte, 4, true);
+        if constexpr (requires { &I::slot; })
+            attribs.attrib(&I::slot);
+        return attribs.instanced();
+    }
+
+    void SpriteBatchBase2D::init(const SpritePath::Enum path, int textureSlots, const VertexFormat::Enum format)
+    {
+        // clamp texture slots to what the fragment shader can sample from
+        int maxTextureUnits = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxTextureUnits); GL_ERR_CHECK();
+        textureSlots = std::clamp(textureSlots, 1, std::max(std::min(maxTextureUnits, MaxTextureSlots), 1));
+
         // initialize program
-        m_program.init({
-            .vertShader = detail::spriteBatch2dVertShader,
-            .fragShader = detail::spriteBatch2dFragShader,
-            .attributes = ShaderAttribs()
-                .attrib(&Vertex::position, GLType::Float, 2)
-                .attrib(&Vertex::texcoord, GLType::Float, 2)
-                .attrib(&Vertex::color, GLType::Ubyte, 4, true),
-            .openFiles = false,
-        });
+        if (path == SpritePath::Instanced)
+        {
+            m_program.init({
+                .vertShader = detail::spriteBatch2dShader(detail::spriteBatch2dInstancedVertShader, textureSlots),
+                .fragShader = detail::spriteBatch2dShader(detail::spriteBatch2dFragShader, textureSlots),
+                .attributes = textureSlots > 1 ? instanceAttribs<SlotInstance>() : instanceAttribs<Instance>(),
+                .openFiles = false,
+                .streamBufferSize = m_retained ? 0 : DefaultStreamBufferSize,
+            });
+        }
+        else if (format == VertexFormat::Packed)
+        {
+            m_program.init({
+                .vertShader = detail::spriteBatch2dShader(detail::spriteBatch2dPackedVertShader, textureSlots),
+                .fragShader = detail::spriteBatch2dShader(detail::spriteBatch2dFragShader, textureSlots),
+                .attributes = textureSlots > 1 ?
+                    packedVertexAttribs<SlotPackedVertex>() : packedVertexAttribs<PackedVertex>(),
+                .openFiles = false,
+                .streamBufferSize = m_retained ? 0 : DefaultStreamBufferSize,
+            });
+        }
+        else
+        {
+            m_program.init({
+                .vertShader = detail::spriteBatch2dShader(detail::spriteBatch2dVertShader, textureSlots),
+                .fragShader = detail::spriteBatch2dShader(detail::spriteBatch2dFragShader, textureSlots),
+                .attributes = textureSlots > 1 ? floatVertexAttribs<SlotVertex>() : floatVertexAttribs<Vertex>(),
+                .openFiles = false,
+                .streamBufferSize = m_retained ? 0 : DefaultStreamBufferSize,
+            });
+        }
+        m_path = path;
+        m_vertexFormat = format;
+        m_textureSlots = textureSlots;
 
         // locate shader uniforms
         u_texture = m_program.shader()->locateUniform("u_Texture");
@@ -52,6 +155,29 @@ namespace sdgl {
         // Texture checks
         SDGL_ASSERT(texture.id(), "Texture must be initialized and loaded to the graphics card");
 
+        if (m_cull && isCulled(source, position, scale, anchor, angle))
+        {
+            ++m_stats.culledSprites;
+            return;
+        }
+
+        m_glyphs.emplace_back(Glyph{texture, depth});
+
+        if (m_path == SpritePath::Instanced) // corners are computed in the vertex shader
+        {
+            m_instances.emplace_back(Instance{
+                .position = position,
+                .scale = scale,
+                .anchor = anchor,
+                .angle = angle,
+                .source = {
+                    static_cast<int16>(source.x), static_cast<int16>(source.y),
+                    static_cast<int16>(source.w), static_cast<int16>(source.h)},
+                .color = color,
+            });
+            return;
+        }
+
         const auto texCoords = static_cast<FRectangle>(source);
 
         // Scale anchor point
@@ -71,11 +197,8 @@ namespace sdgl {
         auto offsetTopRight    = mathf::rotate(Vector2(dest.w - anchor.x, -anchor.y), angle);
         auto offsetBottomRight = mathf::rotate(Vector2(dest.w - anchor.x, dest.h - anchor.y), angle);
 
-        // Create and append glyph/quad image
-        Glyph glyph;
-        glyph.texture = texture;
-        glyph.depth = depth;
-
+        // Create and append quad image
+        Quad glyph;
         glyph.topleft.color = color;
         glyph.topleft.position = Vector2(dest.x + offsetTopLeft.x, dest.y + offsetTopLeft.y);;
         glyph.topleft.texcoord = texCoords.topleft();
@@ -92,49 +215,373 @@ namespace sdgl {
         glyph.topright.position = Vector2(dest.x + offsetTopRight.x, dest.y + offsetTopRight.y);
         glyph.topright.texcoord = texCoords.topright();
 
-        m_glyphs.emplace_back(glyph);
+        m_quads.emplace_back(glyph);
     }
 
-    void SpriteBatchBase2D::drawText(const FontText &text, const Vector2 position, const Color color, float depth)
+    // ===== Quad expansion kernel =====
+    // Each backend packs one sprite per lane; `round` must match std::round (half away from zero) so that bulk
+    // submission snaps to the same pixels as `drawTexture`.
+
+    /// Fallback: one sprite at a time, also used for the tail of every batch
+    struct ScalarLanes
+    {
+        using V = float;
+        static constexpr int Width = 1;
+        static V load(const float *p) { return *p; }
+        static void store(float *p, const V v) { *p = v; }
+        static V add(const V a, const V b) { return a + b; }
+        static V sub(const V a, const V b) { return a - b; }
+        static V mul(const V a, const V b) { return a * b; }
+        static V round(const V v) { return std::round(v); }
+    };
+
+#if defined(__AVX2__)
+    struct SimdLanes
+    {
+        using V = __m256;
+        static constexpr int Width = 8;
+        static V load(const float *p) { return _mm256_loadu_ps(p); }
+        static void store(float *p, const V v) { _mm256_storeu_ps(p, v); }
+        static V add(const V a, const V b) { return _mm256_add_ps(a, b); }
+        static V sub(const V a, const V b) { return _mm256_sub_ps(a, b); }
+        static V mul(const V a, const V b) { return _mm256_mul_ps(a, b); }
+        static V round(const V v)
+        {
+            const auto signMask = _mm256_set1_ps(-0.f);
+            const auto truncated = _mm256_round_ps(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+            const auto absFrac = _mm256_andnot_ps(signMask, _mm256_sub_ps(v, truncated));
+            const auto roundAway = _mm256_cmp_ps(absFrac, _mm256_set1_ps(.5f), _CMP_GE_OQ);
+            const auto step = _mm256_or_ps(_mm256_set1_ps(1.f), _mm256_and_ps(v, signMask)); // +-1
+            return _mm256_add_ps(truncated, _mm256_and_ps(roundAway, step));
+        }
+    };
+#elif defined(__SSE2__) || defined(_M_X64)
+    struct SimdLanes
     {
-        for (size_t i = 0; const auto &glyph : text.glyphs())
+        using V = __m128;
+        static constexpr int Width = 4;
+        static V load(const float *p) { return _mm_loadu_ps(p); }
+        static void store(float *p, const V v) { _mm_storeu_ps(p, v); }
+        static V add(const V a, const V b) { return _mm_add_ps(a, b); }
+        static V sub(const V a, const V b) { return _mm_sub_ps(a, b); }
+        static V mul(const V a, const V b) { return _mm_mul_ps(a, b); }
+        static V round(const V v)
         {
-            if (i > text.textProgress())
-                break;
+            const auto signMask = _mm_set1_ps(-0.f);
+            const auto absV = _mm_andnot_ps(signMask, v);
 
-            Rectangle source;
-            float rotation = 0;
-            Vector2 anchor;
+            // SSE2 has no float truncation; round-trip through int32, keeping values >= 2^23 (already integral)
+            const auto isIntegral = _mm_cmpge_ps(absV, _mm_set1_ps(8388608.f));
+            const auto truncated = _mm_or_ps(_mm_and_ps(isIntegral, v),
+                _mm_andnot_ps(isIntegral, _mm_cvtepi32_ps(_mm_cvttps_epi32(v))));
 
-            auto &texFrame = glyph.frame;
+            const auto absFrac = _mm_andnot_ps(signMask, _mm_sub_ps(v, truncated));
+            const auto roundAway = _mm_cmpge_ps(absFrac, _mm_set1_ps(.5f));
+            const auto step = _mm_or_ps(_mm_set1_ps(1.f), _mm_and_ps(v, signMask)); // +-1
+            return _mm_add_ps(truncated, _mm_and_ps(roundAway, step));
+        }
+    };
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    struct SimdLanes
+    {
+        using V = float32x4_t;
+        static constexpr int Width = 4;
+        static V load(const float *p) { return vld1q_f32(p); }
+        static void store(float *p, const V v) { vst1q_f32(p, v); }
+        static V add(const V a, const V b) { return vaddq_f32(a, b); }
+        static V sub(const V a, const V b) { return vsubq_f32(a, b); }
+        static V mul(const V a, const V b) { return vmulq_f32(a, b); }
+        static V round(const V v) { return vrndaq_f32(v); } // ties away from zero, same as std::round
+    };
+#else
+    using SimdLanes = ScalarLanes;
+#endif
+
+    /// Expand `Lanes::Width` sprites starting at `sprites` into quad corner positions.
+    /// @param corners [out] per corner (top-left, bottom-left, top-right, bottom-right): x lanes, then y lanes
+    template <typename Lanes>
+    static void expandCorners(const SpriteInstance *sprites, float (&corners)[8][Lanes::Width])
+    {
+        static constexpr auto W = Lanes::Width;
+
+        // Transpose sprite fields into lanes, computing sincos once per sprite
+        float px[W], py[W], w[W], h[W], ax[W], ay[W], sine[W], cosine[W];
+        for (int i = 0; i < W; ++i)
+        {
+            const auto &sprite = sprites[i];
+            px[i] = sprite.position.x;
+            py[i] = sprite.position.y;
+            w[i] = static_cast<float>(sprite.source.w) * sprite.scale.x;
+            h[i] = static_cast<float>(sprite.source.h) * sprite.scale.y;
+            ax[i] = sprite.anchor.x * sprite.scale.x;
+            ay[i] = sprite.anchor.y * sprite.scale.y;
 
-            // transpose glyph source within font to position in the wider atlas
-            if (texFrame.rotated)
+            if (sprite.angle == 0)
             {
-                source = {
-                    static_cast<int16>((int16)texFrame.frame.w + texFrame.offset.y  + texFrame.frame.x - glyph.source.y - glyph.source.h),
-                    static_cast<int16>(glyph.source.x + texFrame.frame.y + texFrame.offset.x),
-                    glyph.source.h,
-                    glyph.source.w
-                };
-                anchor = Vector2{(float)glyph.source.h - (float)texFrame.offset.y, (float)texFrame.offset.x};
-                rotation = -mathf::HalfPi;
+                sine[i] = 0;
+                cosine[i] = 1.f;
             }
             else
             {
-                source = {
-                    static_cast<int16>(glyph.source.x + texFrame.frame.x),
-                    static_cast<int16>(glyph.source.y + texFrame.frame.y),
-                    glyph.source.w,
-                    glyph.source.h
+                sine[i] = std::sin(sprite.angle);
+                cosine[i] = std::cos(sprite.angle);
+            }
+        }
+
+        // Snap destination to pixel grid
+        const auto destX = Lanes::round(Lanes::load(px));
+        const auto destY = Lanes::round(Lanes::load(py));
+        const auto destW = Lanes::round(Lanes::load(w));
+        const auto destH = Lanes::round(Lanes::load(h));
+
+        const auto anchorX = Lanes::load(ax);
+        const auto anchorY = Lanes::load(ay);
+        const auto s = Lanes::load(sine);
+        const auto c = Lanes::load(cosine);
+
+        // Corner offsets from the anchor point
+        const auto zero = Lanes::sub(anchorX, anchorX);
+        const auto left = Lanes::sub(zero, anchorX);
+        const auto right = Lanes::sub(destW, anchorX);
+        const auto top = Lanes::sub(zero, anchorY);
+        const auto bottom = Lanes::sub(destH, anchorY);
+
+        // Rotate each offset and add the destination
+        const auto corner = [&](const int index, const typename Lanes::V x, const typename Lanes::V y) {
+            Lanes::store(corners[index * 2],
+                Lanes::add(destX, Lanes::sub(Lanes::mul(x, c), Lanes::mul(y, s))));
+            Lanes::store(corners[index * 2 + 1],
+                Lanes::add(destY, Lanes::add(Lanes::mul(x, s), Lanes::mul(y, c))));
+        };
+
+        corner(0, left, top);
+        corner(1, left, bottom);
+        corner(2, right, top);
+        corner(3, right, bottom);
+    }
+
+    template <typename Lanes>
+    static size_t expandQuadsImpl(const SpriteInstance *sprites, const size_t count, auto writeGlyph)
+    {
+        static constexpr auto W = Lanes::Width;
+
+        size_t i = 0;
+        for (float corners[8][W]; i + W <= count; i += W)
+        {
+            expandCorners<Lanes>(sprites + i, corners);
+            for (int lane = 0; lane < W; ++lane)
+                writeGlyph(i + lane, corners, lane);
+        }
+
+        return i;
+    }
+
+    void SpriteBatchBase2D::expandQuads(const span<const SpriteInstance> sprites, Quad *out)
+    {
+        const auto writeGlyph = [&sprites, out](const size_t index, const auto &corners, const int lane) {
+            const auto &sprite = sprites[index];
+            const auto texCoords = static_cast<FRectangle>(sprite.source);
+            auto &glyph = out[index];
+
+            glyph.topleft.color = sprite.tint;
+            glyph.topleft.position = Vector2(corners[0][lane], corners[1][lane]);
+            glyph.topleft.texcoord = texCoords.topleft();
+
+            glyph.bottomleft.color = sprite.tint;
+            glyph.bottomleft.position = Vector2(corners[2][lane], corners[3][lane]);
+            glyph.bottomleft.texcoord = texCoords.bottomleft();
+
+            glyph.topright.color = sprite.tint;
+            glyph.topright.position = Vector2(corners[4][lane], corners[5][lane]);
+            glyph.topright.texcoord = texCoords.topright();
+
+            glyph.bottomright.color = sprite.tint;
+            glyph.bottomright.position = Vector2(corners[6][lane], corners[7][lane]);
+            glyph.bottomright.texcoord = texCoords.bottomright();
+        };
+
+        const auto done = expandQuadsImpl<SimdLanes>(sprites.data(), sprites.size(), writeGlyph);
+        expandQuadsImpl<ScalarLanes>(sprites.data() + done, sprites.size() - done,
+            [&writeGlyph, done](const size_t index, const auto &corners, const int lane) {
+                writeGlyph(done + index, corners, lane);
+            });
+    }
+
+    void SpriteBatchBase2D::drawTextures(span<const SpriteInstance> sprites)
+    {
+        SDGL_ASSERT(m_batchStarted, "SpriteBatchBase2D::begin must be called before drawing");
+
+        if (sprites.empty())
+            return;
+
+#if SDGL_DEBUG
+        for (const auto &sprite : sprites)
+        {
+            SDGL_ASSERT(sprite.texture && sprite.texture->id(),
+                "Texture must be initialized and loaded to the graphics card");
+        }
+#endif
+
+        // Drop sprites outside the view before they reach batch storage
+        if (m_cull)
+        {
+            auto &visible = m_visibleSprites;
+            visible.clear();
+            for (const auto &sprite : sprites)
+            {
+                if (isCulled(sprite.source, sprite.position, sprite.scale, sprite.anchor, sprite.angle))
+                    ++m_stats.culledSprites;
+                else
+                    visible.emplace_back(sprite);
+            }
+
+            if (visible.empty())
+                return;
+            sprites = visible;
+        }
+
+        // Write straight into batch storage
+        const auto offset = m_glyphs.size();
+        m_glyphs.resize(offset + sprites.size());
+        for (auto glyph = m_glyphs.data() + offset; const auto &sprite : sprites)
+        {
+            glyph->texture = *sprite.texture;
+            glyph->depth = sprite.depth;
+            ++glyph;
+        }
+
+        if (m_path == SpritePath::Instanced)
+        {
+            m_instances.resize(offset + sprites.size());
+            for (auto instance = m_instances.data() + offset; const auto &sprite : sprites)
+            {
+                *instance = Instance{
+                    .position = sprite.position,
+                    .scale = sprite.scale,
+                    .anchor = sprite.anchor,
+                    .angle = sprite.angle,
+                    .source = {
+                        static_cast<int16>(sprite.source.x), static_cast<int16>(sprite.source.y),
+                        static_cast<int16>(sprite.source.w), static_cast<int16>(sprite.source.h)},
+                    .color = sprite.tint,
                 };
+                ++instance;
+            }
+        }
+        else
+        {
+            m_quads.resize(offset + sprites.size());
+            expandQuads(sprites, m_quads.data() + offset);
+        }
+    }
+
+    void SpriteBatchBase2D::drawText(const FontText &text, const Vector2 position, const Color color, float depth)
+    {
+        SDGL_ASSERT(m_batchStarted, "SpriteBatchBase2D::begin must be called before drawing");
+
+        const auto count = std::min(static_cast<size_t>(text.textProgress()), text.glyphs().size());
+        if (count == 0)
+            return;
+
+        if (m_path == SpritePath::Instanced) // corners are computed in the vertex shader, submit each glyph
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const auto &quad = text.quads()[i];
+                const auto &glyph = text.glyphs()[i];
+                const auto rotated = glyph.frame.rotated;
+
+                // recover the atlas source rectangle and rotation the quad was built with
+                const auto &tl = quad.texcoords[0], &br = quad.texcoords[3];
+                const Rectangle source = {
+                    static_cast<int16>(tl.x), static_cast<int16>(tl.y),
+                    static_cast<int16>(br.x - tl.x), static_cast<int16>(br.y - tl.y)};
+                const auto anchor = rotated ?
+                    Vector2{(float)glyph.source.h - (float)glyph.frame.offset.y, (float)glyph.frame.offset.x} :
+                    Vector2{(float)glyph.frame.offset.x, (float)glyph.frame.offset.y};
+
+                drawTexture(quad.texture, source, position + glyph.destination, color, {1.f, 1.f}, anchor,
+                    rotated ? -mathf::HalfPi : 0, depth);
+            }
+            return;
+        }
+
+        // Snap the text as a whole to the pixel grid; glyph offsets within it are already whole pixels
+        const auto origin = Vector2(std::round(position.x), std::round(position.y));
+
+        if (m_cull)
+        {
+            const auto &bounds = text.quadBounds();
+            if (origin.x + bounds.right() < m_cullBounds.left() || origin.x + bounds.left() > m_cullBounds.right() ||
+                origin.y + bounds.bottom() < m_cullBounds.top() || origin.y + bounds.top() > m_cullBounds.bottom())
+            {
+                m_stats.culledSprites += static_cast<uint>(count);
+                return;
+            }
+        }
+
+        // Copy the cached quads straight into batch storage
+        const auto &quads = text.quads();
+        const auto offset = m_glyphs.size();
+        m_glyphs.resize(offset + count);
+        m_quads.resize(offset + count);
+
+        auto glyph = m_glyphs.data() + offset;
+        auto out = m_quads.data() + offset;
+        for (size_t i = 0; i < count; ++i, ++glyph, ++out)
+        {
+            const auto &quad = quads[i];
+            glyph->texture = quad.texture;
+            glyph->depth = depth;
+
+            out->topleft = Vertex(origin + quad.corners[0], color, quad.texcoords[0]);
+            out->bottomleft = Vertex(origin + quad.corners[1], color, quad.texcoords[1]);
+            out->topright = Vertex(origin + quad.corners[2], color, quad.texcoords[2]);
+            out->bottomright = Vertex(origin + quad.corners[3], color, quad.texcoords[3]);
+        }
+    }
 
-                anchor += texFrame.offset;
+    void SpriteBatchBase2D::drawQuad(const Texture2D &texture, const Rectangle source, const Vector2 topleft,
+        const Vector2 bottomleft, const Vector2 topright, const Vector2 bottomright, const Color tint, const float depth)
+    {
+        SDGL_ASSERT(texture.id(), "Texture must be initialized and loaded to the graphics card");
+
+        SDGL_ASSERT(m_path != SpritePath::Instanced, "SpriteBatchBase2D::drawQuad is only supported on "
+            "SpritePath::PerVertex");
+        if (m_path == SpritePath::Instanced)
+        {
+            // shapes draw many quads per frame, report it once rather than flooding the log
+            if (!m_reportedInstancedQuads)
+            {
+                SDGL_ERROR("SpriteBatchBase2D::drawQuad is only supported on SpritePath::PerVertex, "
+                    "quads and shapes are skipped");
+                m_reportedInstancedQuads = true;
             }
+            return;
+        }
 
-            drawTexture(glyph.frame.texture, source, position + glyph.destination, color, {1.f, 1.f}, anchor, rotation, depth);
-            ++i;
+        if (m_cull)
+        {
+            const auto left = std::min({topleft.x, bottomleft.x, topright.x, bottomright.x});
+            const auto right = std::max({topleft.x, bottomleft.x, topright.x, bottomright.x});
+            const auto top = std::min({topleft.y, bottomleft.y, topright.y, bottomright.y});
+            const auto bottom = std::max({topleft.y, bottomleft.y, topright.y, bottomright.y});
+            if (right < m_cullBounds.left() || left > m_cullBounds.right() ||
+                bottom < m_cullBounds.top() || top > m_cullBounds.bottom())
+            {
+                ++m_stats.culledSprites;
+                return;
+            }
         }
+
+        const auto texCoords = static_cast<FRectangle>(source);
+        m_glyphs.emplace_back(Glyph{texture, depth});
+        m_quads.emplace_back(Quad{
+            .topleft = Vertex(topleft, tint, texCoords.topleft()),
+            .bottomleft = Vertex(bottomleft, tint, texCoords.bottomleft()),
+            .topright = Vertex(topright, tint, texCoords.topright()),
+            .bottomright = Vertex(bottomright, tint, texCoords.bottomright()),
+        });
     }
 
     void SpriteBatchBase2D::drawFrame(const Frame &frame, Vector2 position, Color color, Vector2 scale,
@@ -159,166 +606,721 @@ namespace sdgl {
             "Mismatched SpriteBatchBase2D::begin call. Did you remember to call end?");
         m_matrix = transformMatrix;
         m_batches.clear();
+        m_batchTextures.clear();
         m_glyphs.clear();
+        m_quads.clear();
+        m_instances.clear();
         m_sortOrder = sortOrder;
+        m_stats = {};
+        if (!m_renderThread) // owned by the render thread otherwise
+        {
+            m_program.resetStreamStats();
+            m_program.resetDrawStats();
+            m_program.shader()->resetStats();
+        }
+        m_cull = false;
+        m_pixelScale = 1.f;
 
         m_batchStarted = true;
     }
 
+    void SpriteBatchBase2D::begin(const float *transformMatrix, const FRectangle &cullBounds,
+        const SortOrder::Enum sortOrder)
+    {
+        begin(transformMatrix, sortOrder);
+
+        // retained sprites are drawn from later views too, so none may be dropped for lying outside this one
+        m_cull = !m_retained;
+        m_cullBounds = cullBounds;
+    }
+
+    void SpriteBatchBase2D::begin(const Camera2D &camera, const SortOrder::Enum sortOrder)
+    {
+        begin(camera.getMatrix(), camera.getWorldBounds(), sortOrder);
+
+        const auto scale = camera.getScale();
+        m_pixelScale = std::max(std::abs(scale.x), std::abs(scale.y));
+    }
+
+    bool SpriteBatchBase2D::isCulled(const Rectangle &source, const Vector2 position, const Vector2 scale,
+        const Vector2 anchor, const float angle) const
+    {
+        // Center and half extents of the quad relative to `position`, matching the corner math in `drawTexture`
+        auto extentX = std::abs(static_cast<float>(source.w) * scale.x) * .5f;
+        auto extentY = std::abs(static_cast<float>(source.h) * scale.y) * .5f;
+        auto center = Vector2(static_cast<float>(source.w) * scale.x * .5f - anchor.x * scale.x,
+            static_cast<float>(source.h) * scale.y * .5f - anchor.y * scale.y);
+
+        if (angle != 0)
+        {
+            // axis-aligned extents of the rotated quad
+            const auto c = std::abs(std::cos(angle)), s = std::abs(std::sin(angle));
+            center = mathf::rotate(center, angle);
+            const auto rotatedX = extentX * c + extentY * s;
+            extentY = extentX * s + extentY * c;
+            extentX = rotatedX;
+        }
+
+        // pad by a pixel for the snapping done when the quad is built
+        center += position;
+        extentX += 1.f;
+        extentY += 1.f;
+
+        return center.x + extentX < m_cullBounds.left() || center.x - extentX > m_cullBounds.right() ||
+            center.y + extentY < m_cullBounds.top() || center.y - extentY > m_cullBounds.bottom();
+    }
+
     void SpriteBatchBase2D::end()
     {
         SDGL_ASSERT(m_batchStarted,
             "Mismatched SpriteBatchBase2D::end call. Did you remember to call begin?");
 
+        const auto sortStart = Clock::now();
         sortGlyphs();
+        const auto batchStart = Clock::now();
         createBatches();
-        renderBatches();
+        m_stats.sortTime = toMilliseconds(batchStart - sortStart);
+        m_stats.batchTime = toMilliseconds(Clock::now() - batchStart);
+        if (!m_renderThread) // counted while recording otherwise
+            m_stats.bytesUploaded = m_program.streamStats().bytesUploaded;
+
+        if (!m_retained)
+            renderBatches();
+
+        // Collect stats
+        m_stats.sprites = static_cast<uint>(m_glyphs.size());
+        m_stats.batches = static_cast<uint>(m_batches.size());
+        m_stats.baselineBatches = 0;
+        for (uint lastTexId = UINT32_MAX; const auto &glyph : m_glyphs)
+        {
+            if (glyph.texture.id() != lastTexId)
+            {
+                ++m_stats.baselineBatches;
+                lastTexId = glyph.texture.id();
+            }
+        }
+
+        if (m_retained) // geometry lives on the GPU now, only the batches are needed to draw it
+        {
+            m_glyphs = {};
+            m_quads = {};
+            m_instances = {};
+            m_sortKeys = {};
+            m_sortScratch = {};
+            m_clusterRuns = {};
+        }
 
         m_batchStarted = false;
     }
 
+    void SpriteBatchBase2D::renderRetained(const float *transformMatrix)
+    {
+        SDGL_ASSERT(m_retained, "SpriteBatchBase2D must be retained to render its batches again");
+        SDGL_ASSERT(!m_batchStarted, "Cannot render retained sprites while recording. Did you remember to call end?");
+
+        m_matrix = transformMatrix;
+        if (!m_renderThread)
+        {
+            m_program.resetDrawStats();
+            m_program.shader()->resetStats();
+        }
 
-    void SpriteBatchBase2D::createBatches()
+        renderBatches();
+    }
+
+    void SpriteBatchBase2D::retainedTextureChanged(const uint previousId, const Texture2D &texture)
     {
-        if (m_glyphs.empty())
+        if (!m_retained || !previousId)
             return;
 
-        // FUTURE: Some research should be done to see when index vs vertex rendering is optimal.
-        if (false) // ----- Index Mode: draw using vertex indices -----
+        for (auto &batchTexture : m_batchTextures)
         {
-            vector<uint> indices;
-            vector<Vertex> vertices;
-            auto &batches = m_batches;
-            batches.clear();
+            if (batchTexture.id() != previousId)
+                continue;
+
+            if (!texture.id())
+            {
+                SDGL_ERROR("Retained sprites draw a texture that was unloaded, they must be built again");
+                m_batches.clear();
+                m_batchTextures.clear();
+                return;
+            }
+
+            batchTexture = texture; // a reload keeps the id, but may change the size
+        }
+    }
 
-            vertices.reserve(m_glyphs.size() * 4);
-            indices.reserve(m_glyphs.size() * VertsPerQuad);
 
-            for (uint indexOffset = 0, vertOffset = 0, lastTexId = UINT32_MAX;
-                const auto &[topleft, bottomleft, topright, bottomright, texture, depth] : m_glyphs)
+    ubyte SpriteBatchBase2D::addToBatch(const Texture2D &texture, const uint offset, const uint count)
+    {
+        if (!m_batches.empty())
+        {
+            auto &batch = m_batches.back();
+            const auto textures = m_batchTextures.data() + batch.firstTexture;
+            for (uint slot = 0; slot < batch.textureCount; ++slot)
             {
-                // Each texture swap requires a new batch
-                if (const auto texId = texture.id();
-                    lastTexId != texId)
-                {
-                    batches.emplace_back(indexOffset, VertsPerQuad, texture);
-                    lastTexId = texId;
-                }
-                else
+                if (textures[slot].id() == texture.id())
                 {
-                    // same texture - stay on same batch - add num indices for this glyph
-                    batches.back().count += VertsPerQuad;
+                    batch.count += count;
+                    return static_cast<ubyte>(slot);
                 }
+            }
+
+            // new texture - take a free slot if there is one
+            if (batch.textureCount < static_cast<uint>(m_textureSlots))
+            {
+                m_batchTextures.emplace_back(texture);
+                batch.count += count;
+                return static_cast<ubyte>(batch.textureCount++);
+            }
+        }
+
+        // out of slots, a new batch is needed
+        m_batches.emplace_back(offset, count, static_cast<uint>(m_batchTextures.size()));
+        m_batchTextures.emplace_back(texture);
+        return 0;
+    }
+
+    void SpriteBatchBase2D::createBatches()
+    {
+        if (m_glyphs.empty())
+            return;
 
-                // add quad vertices (only 4 needed, since we're pointing to them via indices)
-                vertices.emplace_back(topleft);
-                vertices.emplace_back(bottomleft);
-                vertices.emplace_back(bottomright);
-                vertices.emplace_back(topright);
-
-
-                // add quad vertex indices
-                indices.emplace_back(vertOffset);
-                indices.emplace_back(vertOffset + 1);
-                indices.emplace_back(vertOffset + 2);
-                indices.emplace_back(vertOffset + 2);
-                indices.emplace_back(vertOffset + 3);
-                indices.emplace_back(vertOffset);
-                indexOffset += VertsPerQuad;
-                vertOffset += 4;
+        auto &batches = m_batches;
+        batches.clear();
+        m_batchTextures.clear();
+
+        if (m_path == SpritePath::Instanced) // ----- Instanced: one record per sprite, expanded by the shader -----
+        {
+            const auto instances = mapVertices(static_cast<int>(m_glyphs.size()));
+            if (!instances)
+            {
+                SDGL_ERROR("SpriteBatchBase2D failed to map instance buffer");
+                return;
             }
 
-            // send vertices to the graphics card
-            m_program.setIndices(indices, true);
-            m_program.setVertices(vertices, true);
+            if (m_textureSlots > 1)
+                writeInstances(static_cast<SlotInstance *>(instances));
+            else
+                writeInstances(static_cast<Instance *>(instances));
+
+            // commit instances, then shift batches to where they landed in the ring buffer
+            const auto baseInstance = unmapVertices();
+            if (baseInstance < 0)
+            {
+                batches.clear(); // the driver lost the vertices, skip drawing this frame
+                m_batchTextures.clear();
+                return;
+            }
+
+            for (auto &batch : batches)
+                batch.offset += static_cast<uint>(baseInstance);
+            return;
         }
-        else                         // ----- Vertex Mode: draw individual vertices -----
+
+        // Both modes draw 6 vertices / indices per quad; see benchmarks/SpriteBatchModes for a comparison.
+        // Index mode writes only 4 vertices per quad and draws them via the static quad index buffer.
+        const auto verticesPerQuad = m_quadMode == QuadMode::Indexed ? 4 : VertsPerQuad;
+
+        // write vertices straight into the program's streaming ring buffer
+        const auto vertices = mapVertices(static_cast<int>(m_glyphs.size() * verticesPerQuad));
+        if (!vertices)
         {
-            vector<Vertex> vertices;
-            auto &batches = m_batches;
-            batches.clear();
+            SDGL_ERROR("SpriteBatchBase2D failed to map vertex buffer");
+            return;
+        }
 
-            vertices.reserve(m_glyphs.size() * VertsPerQuad);
+        if (m_vertexFormat == VertexFormat::Packed)
+        {
+            if (m_textureSlots > 1)
+                writeQuads(static_cast<SlotPackedVertex *>(vertices));
+            else
+                writeQuads(static_cast<PackedVertex *>(vertices));
+        }
+        else
+        {
+            if (m_textureSlots > 1)
+                writeQuads(static_cast<SlotVertex *>(vertices));
+            else
+                writeQuads(static_cast<Vertex *>(vertices));
+        }
 
-            for (uint offset = 0, lastTexId = UINT32_MAX;
-                const auto &[topleft, bottomleft, topright, bottomright, texture, depth] : m_glyphs)
+        if (m_quadMode == QuadMode::Indexed) // ----- Index Mode: draw using the static quad index buffer -----
+        {
+            // commit vertices; indices are relative to where they landed in the ring buffer
+            const auto baseVertex = unmapVertices();
+            if (baseVertex < 0)
             {
-                // Each texture swap requires a new batch
-                if (const auto texId = texture.id(); lastTexId != texId)
-                {
-                    batches.emplace_back(offset, VertsPerQuad, texture);
-                    lastTexId = texId;
-                }
-                else
-                {
-                    // same texture - stay on same batch - add num vertices to batch for this glyph
-                    batches.back().count += VertsPerQuad;
-                }
+                batches.clear(); // the driver lost the vertices, skip drawing this frame
+                m_batchTextures.clear();
+                return;
+            }
+
+            if (const auto commands = recorder())
+            {
+                commands->setBaseVertex(&m_program, baseVertex, true);
+                commands->setQuadIndices(&m_program, static_cast<int>(m_glyphs.size()));
+            }
+            else
+            {
+                m_program.setBaseVertex(baseVertex);
+                m_program.setQuadIndices(static_cast<int>(m_glyphs.size()));
+            }
+        }
+        else                                 // ----- Vertex Mode: draw individual vertices -----
+        {
+            // commit vertices, then shift batches to where they landed in the ring buffer
+            const auto baseVertex = unmapVertices();
+            if (baseVertex < 0)
+            {
+                batches.clear(); // the driver lost the vertices, skip drawing this frame
+                m_batchTextures.clear();
+                return;
+            }
+
+            for (auto &batch : batches)
+                batch.offset += static_cast<uint>(baseVertex);
+
+            // turn off index mode, in case it was on previously
+            if (const auto commands = recorder())
+            {
+                commands->setBaseVertex(&m_program, 0, false);
+                commands->clearIndices(&m_program);
+            }
+            else
+            {
+                m_program.setBaseVertex(0);
+                m_program.clearIndices();
+            }
+        }
+    }
+
+    template <typename V>
+    void SpriteBatchBase2D::writeQuads(V *out)
+    {
+        auto v = out;
+        for (uint offset = 0; const auto key : m_sortKeys)
+        {
+            // gather glyphs in sorted order
+            const auto index = keyIndex(key);
+            const auto &[topleft, bottomleft, topright, bottomright] = m_quads[index];
+
+            // Texture swaps beyond the available texture slots require a new batch
+            const auto slot = addToBatch(m_glyphs[index].texture, offset, VertsPerQuad);
 
+            if (m_quadMode == QuadMode::Indexed)
+            {
+                // add quad vertices in the order the quad index pattern {0, 1, 2, 2, 3, 0} expects
+                storeVertex(v[0], topleft, slot);
+                storeVertex(v[1], bottomleft, slot);
+                storeVertex(v[2], bottomright, slot);
+                storeVertex(v[3], topright, slot);
+                v += 4;
+            }
+            else
+            {
                 // add vertices for this quad
-                vertices.emplace_back(topleft);
-                vertices.emplace_back(bottomleft);
-                vertices.emplace_back(bottomright);
-                vertices.emplace_back(bottomright);
-                vertices.emplace_back(topright);
-                vertices.emplace_back(topleft);
-
-                offset += VertsPerQuad;
+                storeVertex(v[0], topleft, slot);
+                storeVertex(v[1], bottomleft, slot);
+                storeVertex(v[2], bottomright, slot);
+                storeVertex(v[3], bottomright, slot);
+                storeVertex(v[4], topright, slot);
+                storeVertex(v[5], topleft, slot);
+                v += VertsPerQuad;
             }
 
-            // send vertices to graphics card
-            m_program.setVertices(vertices, true);
-            m_program.clearIndices(); // turn off index mode, in case it was on previously
+            offset += VertsPerQuad;
         }
     }
 
+    template <typename I>
+    void SpriteBatchBase2D::writeInstances(I *out)
+    {
+        for (uint offset = 0; const auto key : m_sortKeys)
+        {
+            const auto index = keyIndex(key);
+            storeInstance(*out, m_instances[index], addToBatch(m_glyphs[index].texture, offset, 1));
+            ++out;
+            ++offset;
+        }
+    }
+
+    void SpriteBatchBase2D::storeVertex(Vertex &out, const Vertex &vertex, ubyte)
+    {
+        out = vertex;
+    }
+
+    void SpriteBatchBase2D::storeVertex(SlotVertex &out, const Vertex &vertex, const ubyte slot)
+    {
+        out.position = vertex.position;
+        out.texcoord = vertex.texcoord;
+        out.color = vertex.color;
+        out.slot = slot;
+    }
+
+    /// Convert to a 16-bit integer, clamping values out of its range
+    template <typename T>
+    static T toInt16(const float value)
+    {
+        return static_cast<T>(std::clamp(std::round(value),
+            static_cast<float>(std::numeric_limits<T>::min()), static_cast<float>(std::numeric_limits<T>::max())));
+    }
+
+    void SpriteBatchBase2D::storeVertex(PackedVertex &out, const Vertex &vertex, ubyte)
+    {
+        out.position[0] = toInt16<int16>(vertex.position.x * PackedPositionScale);
+        out.position[1] = toInt16<int16>(vertex.position.y * PackedPositionScale);
+        out.texcoord[0] = toInt16<uint16>(vertex.texcoord.x);
+        out.texcoord[1] = toInt16<uint16>(vertex.texcoord.y);
+        out.color = vertex.color;
+    }
+
+    void SpriteBatchBase2D::storeVertex(SlotPackedVertex &out, const Vertex &vertex, const ubyte slot)
+    {
+        out.position[0] = toInt16<int16>(vertex.position.x * PackedPositionScale);
+        out.position[1] = toInt16<int16>(vertex.position.y * PackedPositionScale);
+        out.texcoord[0] = toInt16<uint16>(vertex.texcoord.x);
+        out.texcoord[1] = toInt16<uint16>(vertex.texcoord.y);
+        out.color = vertex.color;
+        out.slot = slot;
+    }
+
+    void SpriteBatchBase2D::storeInstance(Instance &out, const Instance &instance, ubyte)
+    {
+        out = instance;
+    }
+
+    void SpriteBatchBase2D::storeInstance(SlotInstance &out, const Instance &instance, const ubyte slot)
+    {
+        out.position = instance.position;
+        out.scale = instance.scale;
+        out.anchor = instance.anchor;
+        out.angle = instance.angle;
+        std::copy(std::begin(instance.source), std::end(instance.source), out.source);
+        out.color = instance.color;
+        out.slot = slot;
+    }
+
+    /// Map a float to an unsigned int whose unsigned ordering matches the float's ordering
+    static uint floatToSortable(float value)
+    {
+        value += 0.f; // -0 => +0, so that both compare equal as with float comparison
+
+        uint bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+    }
+
+    /// Stable LSD radix sort on the upper 32 bits of each key, 8 bits per pass. Passes where every key shares the
+    /// same digit are skipped.
+    static void radixSortUpper32(vector<uint64> &keys, vector<uint64> &scratch)
+    {
+        static constexpr int Passes = 4;
+        static constexpr int Radix = 256;
+
+        // Build the histograms of all passes in a single read over the keys
+        uint counts[Passes][Radix] = {};
+        for (const auto key : keys)
+        {
+            for (int pass = 0; pass < Passes; ++pass)
+                ++counts[pass][(key >> (32 + pass * 8)) & 0xFFu];
+        }
+
+        scratch.resize(keys.size());
+        auto src = &keys, dest = &scratch;
+        for (int pass = 0; pass < Passes; ++pass)
+        {
+            const auto shift = 32 + pass * 8;
+            auto &count = counts[pass];
+
+            if (count[((*src)[0] >> shift) & 0xFFu] == src->size())
+                continue; // all keys fall in one bucket, order wouldn't change
+
+            // counts => starting offsets
+            uint offsets[Radix];
+            for (uint i = 0, total = 0; i < Radix; ++i)
+            {
+                offsets[i] = total;
+                total += count[i];
+            }
+
+            for (const auto key : *src)
+                (*dest)[offsets[(key >> shift) & 0xFFu]++] = key;
+
+            std::swap(src, dest);
+        }
+
+        if (src != &keys)
+            keys.swap(scratch);
+    }
+
     void SpriteBatchBase2D::sortGlyphs()
     {
+        // Sort compact keys instead of moving whole glyphs: the primary sort value goes in the upper 32 bits and the
+        // submission index in the lower 32 bits. Sorting only the upper bits with a stable sort keeps submission
+        // order between glyphs that compare equal.
+        auto &keys = m_sortKeys;
+        keys.resize(m_glyphs.size());
+
         switch(m_sortOrder)
         {
             case SortOrder::BackToFront:
-                std::ranges::stable_sort(m_glyphs, [](const Glyph &a, const Glyph &b) {
-                    return a.depth > b.depth;
-                });
+                for (uint i = 0; const auto &glyph : m_glyphs)
+                {
+                    keys[i] = static_cast<uint64>(~floatToSortable(glyph.depth)) << 32 | i;
+                    ++i;
+                }
             break;
 
             case SortOrder::FrontToBack:
-                std::ranges::stable_sort(m_glyphs, [](const Glyph &a, const Glyph &b) {
-                    return a.depth < b.depth;
-                });
+                for (uint i = 0; const auto &glyph : m_glyphs)
+                {
+                    keys[i] = static_cast<uint64>(floatToSortable(glyph.depth)) << 32 | i;
+                    ++i;
+                }
             break;
 
             case SortOrder::Texture:
-                std::ranges::stable_sort(m_glyphs, [](const Glyph &a, const Glyph &b) {
-                    return a.texture.id() < b.texture.id();
-                });
+                for (uint i = 0; const auto &glyph : m_glyphs)
+                {
+                    keys[i] = static_cast<uint64>(glyph.texture.id()) << 32 | i;
+                    ++i;
+                }
             break;
 
-            case SortOrder::None:
+            case SortOrder::DepthThenTexture:
+                // LSD order: sort by the secondary value first, then stable-sort by the primary value
+                for (uint i = 0; const auto &glyph : m_glyphs)
+                {
+                    keys[i] = static_cast<uint64>(glyph.texture.id()) << 32 | i;
+                    ++i;
+                }
+
+                if (keys.size() > 1)
+                    radixSortUpper32(keys, m_sortScratch);
+
+                for (auto &key : keys)
+                {
+                    const auto index = keyIndex(key);
+                    key = static_cast<uint64>(floatToSortable(m_glyphs[index].depth)) << 32 | index;
+                }
             break;
+
+            case SortOrder::None:
+                for (uint i = 0, size = static_cast<uint>(keys.size()); i < size; ++i)
+                    keys[i] = i;
+            return;
+        }
+
+        if (keys.size() > 1)
+            radixSortUpper32(keys, m_sortScratch);
+
+        if (m_clusterTextures && m_sortOrder != SortOrder::Texture)
+            clusterTextures();
+    }
+
+    /// Axis-aligned bounds of a glyph's quad
+    static FRectangle glyphBounds(const Vector2 a, const Vector2 b, const Vector2 c, const Vector2 d)
+    {
+        const auto left = std::min({a.x, b.x, c.x, d.x});
+        const auto top = std::min({a.y, b.y, c.y, d.y});
+        return {left, top,
+            std::max({a.x, b.x, c.x, d.x}) - left,
+            std::max({a.y, b.y, c.y, d.y}) - top};
+    }
+
+    FRectangle SpriteBatchBase2D::spriteBounds(const uint index) const
+    {
+        if (m_path == SpritePath::Instanced)
+        {
+            // same corner math as the instanced vertex shader
+            const auto &[position, scale, anchor, angle, source, color] = m_instances[index];
+            const auto dest = Vector2(std::round(position.x), std::round(position.y));
+            const auto w = std::round(static_cast<float>(source[2]) * scale.x);
+            const auto h = std::round(static_cast<float>(source[3]) * scale.y);
+            const auto scaledAnchor = anchor * scale;
+
+            return glyphBounds(
+                dest + mathf::rotate(Vector2(-scaledAnchor.x, -scaledAnchor.y), angle),
+                dest + mathf::rotate(Vector2(-scaledAnchor.x, h - scaledAnchor.y), angle),
+                dest + mathf::rotate(Vector2(w - scaledAnchor.x, -scaledAnchor.y), angle),
+                dest + mathf::rotate(Vector2(w - scaledAnchor.x, h - scaledAnchor.y), angle));
         }
+
+        const auto &quad = m_quads[index];
+        return glyphBounds(quad.topleft.position, quad.bottomleft.position,
+            quad.topright.position, quad.bottomright.position);
+    }
+
+    /// Whether two rectangles share any area; touching edges don't count
+    static bool overlaps(const FRectangle &a, const FRectangle &b)
+    {
+        return a.left() < b.right() && b.left() < a.right() &&
+            a.top() < b.bottom() && b.top() < a.bottom();
+    }
+
+    /// Max number of batches a sprite may jump back over to join one of the same texture
+    static constexpr size_t ClusterSearchWindow = 16;
+
+    void SpriteBatchBase2D::clusterTextures()
+    {
+        auto &runs = m_clusterRuns;
+        runs.clear();
+        auto &keys = m_sortKeys;
+
+        // Greedily assign each sprite (in sorted order) to a run. A sprite may join an earlier run of the same
+        // texture if it doesn't overlap anything it would be drawn in front of by doing so.
+        for (auto &key : keys)
+        {
+            const auto &glyph = m_glyphs[keyIndex(key)];
+            const auto textureId = glyph.texture.id();
+            const auto bounds = spriteBounds(keyIndex(key));
+
+            auto runIndex = runs.size();
+            for (auto r = runs.size(); r > 0 && runs.size() - r < ClusterSearchWindow; --r)
+            {
+                auto &run = runs[r - 1];
+                if (run.textureId == textureId && std::abs(run.depth - glyph.depth) <= m_clusterDepthTolerance)
+                {
+                    runIndex = r - 1;
+                    break;
+                }
+
+                if (overlaps(run.bounds, bounds))
+                    break; // this sprite must stay in front of this run
+            }
+
+            if (runIndex == runs.size())
+            {
+                runs.emplace_back(ClusterRun{textureId, glyph.depth, bounds});
+            }
+            else
+            {
+                auto &run = runs[runIndex];
+                const auto right = std::max(run.bounds.right(), bounds.right());
+                const auto bottom = std::max(run.bounds.bottom(), bounds.bottom());
+                run.bounds.x = std::min(run.bounds.x, bounds.x);
+                run.bounds.y = std::min(run.bounds.y, bounds.y);
+                run.bounds.w = right - run.bounds.x;
+                run.bounds.h = bottom - run.bounds.y;
+
+                if (runIndex + 1 != runs.size())
+                    ++m_stats.clusteredSprites;
+            }
+
+            key = static_cast<uint64>(runIndex) << 32 | keyIndex(key);
+        }
+
+        // Stable sort by run keeps the sorted order within each run
+        if (keys.size() > 1 && m_stats.clusteredSprites > 0)
+            radixSortUpper32(keys, m_sortScratch);
+    }
+
+    void SpriteBatchBase2D::setTextureClustering(const bool enabled, const float depthTolerance)
+    {
+        m_clusterTextures = enabled;
+        m_clusterDepthTolerance = depthTolerance;
+    }
+
+    RenderCommandBuffer *SpriteBatchBase2D::recorder() const
+    {
+        return m_renderThread ? &m_renderThread->commands() : nullptr;
+    }
+
+    void *SpriteBatchBase2D::mapVertices(const int count)
+    {
+        if (const auto commands = recorder())
+        {
+            m_stats.bytesUploaded += m_program.attributes().sizeofVertex() * count;
+            return commands->uploadVertices(&m_program, count);
+        }
+
+        return m_program.mapVertices(count);
+    }
+
+    int SpriteBatchBase2D::unmapVertices()
+    {
+        return recorder() ? 0 : m_program.unmapVertices();
     }
 
     void SpriteBatchBase2D::renderBatches()
     {
-        static glm::mat4 defaultMatrix{1.f};
+        if (const auto commands = recorder())
+        {
+            recordBatches(*commands);
+            return;
+        }
+
+        const auto renderStart = Clock::now();
 
         // Set projection matrix
-        m_program.shader()->setUniformMatrix(u_projMtx, m_matrix ? m_matrix : &defaultMatrix[0][0]);
+        m_program.shader()->setUniformMatrix(u_projMtx, m_matrix ? m_matrix : &IdentityMatrix[0][0]);
 
         // Render each batch
         for (const auto &batch : m_batches)
         {
-            // Set texture data
-            const auto texSize = Vector2(batch.texture.size());
-            m_program.shader()->setUniform(u_texSize, texSize);
-            m_program.shader()->setUniform(u_texture, batch.texture);
+            // Bind each texture to its slot
+            const auto textures = m_batchTextures.data() + batch.firstTexture;
+            glm::vec2 texSizes[MaxTextureSlots];
+            for (uint i = 0; i < batch.textureCount; ++i)
+            {
+                const auto size = textures[i].size();
+                texSizes[i] = {static_cast<float>(size.x), static_cast<float>(size.y)};
+            }
+
+            m_program.shader()->setUniform(u_texSize, texSizes, static_cast<int>(batch.textureCount));
+            m_program.shader()->setUniform(u_texture, textures, static_cast<int>(batch.textureCount));
 
             // Draw batch
-            m_program.render(PrimitiveType::Triangles,
-              static_cast<int>(batch.offset),
-              static_cast<int>(batch.count));
+            if (m_path == SpritePath::Instanced)
+            {
+                m_program.setBaseVertex(static_cast<int>(batch.offset));
+                m_program.renderInstanced(PrimitiveType::TriangleStrip, 4, static_cast<int>(batch.count));
+            }
+            else
+            {
+                m_program.render(PrimitiveType::Triangles,
+                  static_cast<int>(batch.offset),
+                  static_cast<int>(batch.count));
+            }
+        }
+
+        // Collect GL counters
+        const auto &shaderStats = m_program.shader()->stats();
+        m_stats.drawCalls = m_program.drawStats().drawCalls;
+        m_stats.textureBinds = shaderStats.textureBinds;
+        m_stats.uniformUploads = shaderStats.uniformUploads;
+        m_stats.renderTime = toMilliseconds(Clock::now() - renderStart);
+    }
+
+    void SpriteBatchBase2D::recordBatches(RenderCommandBuffer &commands)
+    {
+        const auto renderStart = Clock::now();
+
+        commands.setMatrix(&m_program, u_projMtx, m_matrix ? m_matrix : &IdentityMatrix[0][0]);
+
+        // Draws in vertex mode start where the vertices land in the ring buffer, other modes offset via base vertex
+        const auto relativeDraws = m_path == SpritePath::PerVertex && m_quadMode == QuadMode::Vertices;
+        for (const auto &batch : m_batches)
+        {
+            commands.setTextures(&m_program, u_texture, u_texSize, m_batchTextures.data() + batch.firstTexture,
+                static_cast<int>(batch.textureCount));
+
+            if (m_path == SpritePath::Instanced)
+            {
+                commands.setBaseVertex(&m_program, static_cast<int>(batch.offset), true);
+                commands.drawInstanced(&m_program, PrimitiveType::TriangleStrip, 4, static_cast<int>(batch.count));
+            }
+            else
+            {
+                commands.draw(&m_program, PrimitiveType::Triangles, static_cast<int>(batch.offset),
+                    static_cast<int>(batch.count), relativeDraws);
+            }
         }
+
+        // GL counters are only known on the render thread
+        m_stats.drawCalls = static_cast<uint>(m_batches.size());
+        m_stats.renderTime = toMilliseconds(Clock::now() - renderStart);
     }
 
 } // namespace sdgl
@@ -1,6 +1,5 @@
 ///
 /// Future features:
-/// - Basic primitives (shader-based or from triangles?)
 /// - Inject shader code for fx
 ///
 #pragma once
@@ -15,6 +14,8 @@ namespace sdgl {
     class Camera2D;
     class FontText;
     class Frame;
+    class RenderCommandBuffer;
+    class RenderThread;
     class Shader;
 
     struct SortOrder {
@@ -23,45 +24,199 @@ namespace sdgl {
             None,
             FrontToBack,
             BackToFront,
-            Texture
+            Texture,
+            DepthThenTexture, ///< front to back, sprites of equal depth are grouped by texture
         };
     };
 
+    /// How quads are submitted to the graphics card. `Indexed` uploads a third less vertex data, but whether that
+    /// pays off depends on the driver, so it is opt-in: compare both on target hardware with
+    /// `sdgl_bench_spritebatch_modes` before switching.
+    struct QuadMode {
+        enum Enum
+        {
+            Vertices, ///< 6 vertices per quad, drawn directly (default)
+            Indexed,  ///< 4 vertices per quad, drawn via a static index buffer
+        };
+    };
+
+    /// Where sprite quads are expanded into vertices, chosen when the batch is initialized
+    struct SpritePath {
+        enum Enum
+        {
+            PerVertex, ///< corners are computed on the CPU and uploaded as vertices (default)
+            Instanced, ///< one compact record is uploaded per sprite, corners are computed in the vertex shader
+        };
+    };
+
+    /// Layout of the vertices that the per-vertex path uploads, chosen when the batch is initialized. Batching across
+    /// several texture slots adds a slot index to each vertex, making them 24 and 14 bytes.
+    struct VertexFormat {
+        enum Enum
+        {
+            Float,  ///< float positions and texture coordinates, 20 bytes per vertex (default)
+            Packed, ///< fixed point positions with 1/4 pixel precision and 16-bit texture coordinates, 12 bytes per
+                    ///< vertex. Positions must lie within +-8191 pixels; keep `Float` for larger worlds.
+        };
+    };
+
+    /// Sprite data for bulk submission via `SpriteBatchBase2D::drawTextures`. Parameters match `drawTexture`.
+    struct SpriteInstance
+    {
+        const Texture2D *texture = nullptr; ///< texture to draw, must not be null
+        Rectangle source{};                 ///< source rectangle within the texture in pixels
+        Vector2 position{};                 ///< position in pixels at which to project image
+        Color tint = Color::White;          ///< color to tint the image
+        Vector2 scale = {1.f, 1.f};         ///< normalized texture xy scale
+        Vector2 anchor = {0, 0};            ///< origin within the texture to rotate / scale from (in pixels)
+        float angle = 0;                    ///< rotation in radians
+        float depth = 0;                    ///< depth sorting value
+    };
+
+    /// Batching and rendering counters for the last call to `SpriteBatchBase2D::end`
+    struct SpriteBatchStats
+    {
+        uint sprites = 0;          ///< number of sprites submitted that passed culling
+        uint culledSprites = 0;    ///< number of sprites rejected for lying outside the cull bounds
+        uint batches = 0;          ///< number of batches (one draw call each) that were rendered
+        uint baselineBatches = 0;  ///< number of batches the sprites would need if drawn in submission order
+        uint clusteredSprites = 0; ///< number of sprites moved into an earlier batch by texture clustering
+
+        uint drawCalls = 0;        ///< number of draw calls issued
+        uint textureBinds = 0;     ///< number of textures bound to texture units
+        uint uniformUploads = 0;   ///< number of shader uniforms set
+        size_t bytesUploaded = 0;  ///< number of vertex bytes written to the graphics card
+
+        double sortTime = 0;       ///< milliseconds spent sorting sprites
+        double batchTime = 0;      ///< milliseconds spent building batches and writing vertices
+        double renderTime = 0;     ///< milliseconds spent submitting batches to the graphics card
+    };
+
     /// Basic sprite batch for rendering texture quads.
     /// Intended for use with a texture atlas for efficient rendering.
     class SpriteBatchBase2D {
+        /// Vertex of a quad, also the `VertexFormat::Float` layout uploaded with a single texture slot
         struct Vertex
         {
-            Vertex() : position{}, color{}, texcoord{} { }
+            Vertex() : position{}, texcoord{}, color{} { }
             Vertex(const Vector2 position, const Color color, const Vector2 uv) :
-                position{position}, color{color}, texcoord{uv} {}
+                position{position}, texcoord{uv}, color{color} {}
 
             Vector2  position;
             Vector2  texcoord;
             Color    color;
         };
 
-        struct Glyph
+        /// `VertexFormat::Float` layout uploaded when batching across several texture slots
+        struct SlotVertex
+        {
+            Vector2  position;
+            Vector2  texcoord;
+            Color    color;
+            ubyte    slot;     ///< texture slot to sample from, assigned when batching
+        };
+
+        /// Fixed point units per pixel of `PackedVertex::position`, must match `spriteBatch2dPackedVertShader`
+        static constexpr float PackedPositionScale = 4.f;
+
+        /// Compact vertex for `VertexFormat::Packed`, the layout `spriteBatch2dPackedVertShader` reads with a single
+        /// texture slot
+        struct PackedVertex
+        {
+            int16   position[2]; ///< fixed point, `PackedPositionScale` units per pixel
+            uint16  texcoord[2]; ///< in pixels
+            Color   color;
+        };
+
+        /// `VertexFormat::Packed` layout uploaded when batching across several texture slots
+        struct SlotPackedVertex
+        {
+            int16   position[2]; ///< fixed point, `PackedPositionScale` units per pixel
+            uint16  texcoord[2]; ///< in pixels
+            Color   color;
+            ubyte   slot;        ///< texture slot to sample from, assigned when batching
+        };
+
+        struct Quad
         {
             Vertex topleft, bottomleft, topright, bottomright;
+        };
+
+        /// Per-sprite record for the instanced path, the layout `spriteBatch2dInstancedVertShader` reads with a
+        /// single texture slot
+        struct Instance
+        {
+            Vector2 position;
+            Vector2 scale;
+            Vector2 anchor;  ///< unscaled, in pixels
+            float   angle;
+            int16   source[4]; ///< x, y, w, h in pixels
+            Color   color;
+        };
+
+        /// Instanced layout uploaded when batching across several texture slots
+        struct SlotInstance
+        {
+            Vector2 position;
+            Vector2 scale;
+            Vector2 anchor;  ///< unscaled, in pixels
+            float   angle;
+            int16   source[4]; ///< x, y, w, h in pixels
+            Color   color;
+            ubyte   slot;      ///< texture slot to sample from, assigned when batching
+        };
+
+        /// Sort and batch data of a sprite; its geometry lives at the same index in `m_quads` or `m_instances`
+        struct Glyph
+        {
             Texture2D texture{};
             float depth{};
         };
 
         struct RenderBatch
         {
-            RenderBatch(const uint offset, const uint vertexCount, const Texture2D &texture)
-                    : offset(offset), count(vertexCount), texture(texture)
+            RenderBatch(const uint offset, const uint vertexCount, const uint firstTexture)
+                    : offset(offset), count(vertexCount), firstTexture(firstTexture), textureCount(1)
             {}
-            uint offset;        ///< starting index in the vertex array
+            uint offset;        ///< starting index in the vertex array (instance array on the instanced path)
             uint count;         ///< number of objects in this batch
-            Texture2D texture;  ///< texture to render for this batch
+            uint firstTexture;  ///< index of this batch's first texture in `m_batchTextures`
+            uint textureCount;  ///< number of textures to bind for this batch, one per texture slot
+        };
+
+        /// Sprites that `clusterTextures` draws together with one texture
+        struct ClusterRun
+        {
+            uint textureId;
+            float depth;       ///< depth of the first sprite in this run
+            FRectangle bounds; ///< union of the bounds of every sprite in this run
         };
     public:
+        /// Upper limit of textures bound per draw call, further capped by GL_MAX_TEXTURE_IMAGE_UNITS
+        static constexpr int MaxTextureSlots = 16;
+
         SpriteBatchBase2D();
         virtual ~SpriteBatchBase2D() = default;
 
-        virtual void init();
+        /// Initialize graphics resources; must be called before drawing
+        /// @param path         whether to expand sprites on the CPU or in the vertex shader
+        /// @param textureSlots number of textures bound per draw call. Sprites of up to this many different
+        ///                     textures share a batch, so interleaved textures don't break it up.
+        /// @param format       layout of uploaded vertices, only applies to `SpritePath::PerVertex`
+        virtual void init(SpritePath::Enum path = SpritePath::PerVertex, int textureSlots = 1,
+            VertexFormat::Enum format = VertexFormat::Float);
+
+        /// How sprites are expanded into vertices, set in `init`
+        [[nodiscard]]
+        SpritePath::Enum getPath() const { return m_path; }
+
+        /// Number of textures bound per draw call, set in `init`
+        [[nodiscard]]
+        int getTextureSlots() const { return m_textureSlots; }
+
+        /// Layout of uploaded vertices, set in `init`
+        [[nodiscard]]
+        VertexFormat::Enum getVertexFormat() const { return m_vertexFormat; }
 
         /// Draw a subimage of a texture
         void drawTexture(
@@ -75,26 +230,115 @@ namespace sdgl {
             float depth = 0               ///< depth sorting value (set sortOrder in `SpriteBatch::begin` to set behavior)
         );
 
+        /// Draw many subimages at once. Equivalent to calling `drawTexture` for each sprite, but corner expansion
+        /// runs in a vectorized kernel and quads are written straight into batch storage.
+        void drawTextures(span<const SpriteInstance> sprites);
 
-        /// FIXME: perhaps cache rendered texture inside of FontText component? This would allow for ease of
-        /// transformations using drawTexture
+        /// Draw the first `textProgress` glyphs of a text. The glyph quads cached by `FontText::quads` are copied with
+        /// a translation and tint; the text is culled as a whole and snapped to the pixel grid as a whole.
         void drawText(const FontText &text, Vector2 position, Color color = Color::White, float depth = 0);
 
+        /// Draw a quad with arbitrary corners, e.g. to build shapes from. It is rendered as the triangles
+        /// (topleft, bottomleft, bottomright) and (bottomright, topright, topleft), so passing `bottomright` as
+        /// `topright` draws a single triangle. Only supported on `SpritePath::PerVertex`; on the instanced path it
+        /// asserts, and in release builds logs once and draws nothing.
+        /// @param texture texture to draw
+        /// @param source  source rectangle within the texture in pixels, its corners map to the quad's corners
+        void drawQuad(const Texture2D &texture, Rectangle source, Vector2 topleft, Vector2 bottomleft,
+            Vector2 topright, Vector2 bottomright, Color tint = Color::White, float depth = 0);
+
         void drawFrame(const Frame &frame, Vector2 position, Color color, Vector2 scale, Vector2 anchor, float angle, float depth);
 
         void begin(const float *transformMatrix, SortOrder::Enum sortOrder = SortOrder::FrontToBack);
 
+        /// Begin drawing, discarding sprites that lie fully outside of `cullBounds` before they are batched.
+        /// Retained batches keep every sprite, as they are drawn again from other views.
+        /// @param transformMatrix matrix to project sprites with
+        /// @param cullBounds      area in world units that sprites must touch to be drawn
+        /// @param sortOrder       order to draw sprites in
+        void begin(const float *transformMatrix, const FRectangle &cullBounds,
+            SortOrder::Enum sortOrder = SortOrder::FrontToBack);
+
+        /// Begin drawing from the view of `camera`, discarding sprites that it can't see before they are batched,
+        /// unless retained
+        void begin(const Camera2D &camera, SortOrder::Enum sortOrder = SortOrder::FrontToBack);
+
         /// End sprite batch drawing; must be paired with begin()
         void end();
 
+        /// Set how quads are submitted to the graphics card; takes effect on the next call to `end`.
+        /// Only applies to `SpritePath::PerVertex`.
+        void setQuadMode(QuadMode::Enum mode) { m_quadMode = mode; }
+        [[nodiscard]]
+        QuadMode::Enum getQuadMode() const { return m_quadMode; }
+
+        /// Let sprites join an earlier batch of the same texture when they don't overlap any sprite drawn in between.
+        /// Only applies to depth sort orders: `FrontToBack`, `BackToFront` and `DepthThenTexture`.
+        /// @param enabled        whether to cluster sprites by texture
+        /// @param depthTolerance max depth difference between a sprite and the first sprite of the batch it may join
+        void setTextureClustering(bool enabled, float depthTolerance = 0);
+
+        /// Record GL work into `thread`'s current frame instead of issuing it from `end`, or pass nullptr to draw
+        /// right away (default). While recording, `stats` only has GL counters for draw calls and uploaded bytes,
+        /// and `streamStats` is owned by the render thread.
+        void setRenderThread(RenderThread *thread) { m_renderThread = thread; }
+        [[nodiscard]]
+        RenderThread *getRenderThread() const { return m_renderThread; }
+
+        /// Batching and rendering counters for the last call to `end` (or `renderRetained`)
+        [[nodiscard]]
+        const SpriteBatchStats &stats() const { return m_stats; }
+
+        /// Vertex streaming counters since the last call to `begin`
+        [[nodiscard]]
+        const RenderProgram::StreamStats &streamStats() const { return m_program.streamStats(); }
+
+    protected:
+        /// Draw the batches built by the last call to `end`; only valid when `m_retained` is set. The batches keep
+        /// copies of their textures, updated via `retainedTextureChanged`.
+        void renderRetained(const float *transformMatrix);
+
+        /// Update the retained batches' copies of a texture that was reloaded or unloaded, see
+        /// `ContentManager::onTextureChanged`. A reload may resize the texture; if it was unloaded, the batches are
+        /// dropped and must be built again.
+        /// @param previousId GL id the texture had before the change
+        void retainedTextureChanged(uint previousId, const Texture2D &texture);
+
+        /// When set before `init`, vertices go into a static buffer and `end` keeps the sorted vertices and batches
+        /// on the GPU instead of drawing them, to be drawn via `renderRetained`
+        bool m_retained;
+
+        /// Screen pixels per world unit, taken from the camera passed to `begin`; 1 when a matrix was passed
+        float m_pixelScale;
+
     private:
 
 
         vector<Glyph> m_glyphs;
+        vector<Quad> m_quads;         ///< per-vertex path geometry, parallel to `m_glyphs`
+        vector<Instance> m_instances; ///< instanced path geometry, parallel to `m_glyphs`
+        vector<uint64> m_sortKeys;    ///< glyph order to render in, from `sortGlyphs`
+        vector<uint64> m_sortScratch; ///< scratch buffer for sorting keys
         vector<RenderBatch> m_batches;
+        vector<Texture2D> m_batchTextures; ///< textures of each batch, in slot order
 
         SortOrder::Enum m_sortOrder;
+        QuadMode::Enum m_quadMode;
+        SpritePath::Enum m_path;
+        VertexFormat::Enum m_vertexFormat;
+        int m_textureSlots;
         RenderProgram m_program;
+        RenderThread *m_renderThread;
+        SpriteBatchStats m_stats;
+
+        bool m_clusterTextures;
+        float m_clusterDepthTolerance;
+        vector<ClusterRun> m_clusterRuns;           ///< scratch buffer for `clusterTextures`
+
+        bool m_cull;                                ///< whether to discard sprites outside of `m_cullBounds`
+        FRectangle m_cullBounds;
+        vector<SpriteInstance> m_visibleSprites;    ///< scratch buffer for culling in `drawTextures`
+        bool m_reportedInstancedQuads;              ///< whether `drawQuad` already logged that it's unsupported
 
         bool m_batchStarted;
 
@@ -102,8 +346,60 @@ namespace sdgl {
 
         const float *m_matrix;
 
+        /// Get the index into `m_glyphs` that a sort key refers to
+        static uint keyIndex(uint64 key) { return static_cast<uint>(key); }
+
+        /// Convert a vertex into the layout of the batch's vertex format, assigning its texture slot if the layout
+        /// has one
+        static void storeVertex(Vertex &out, const Vertex &vertex, ubyte slot);
+        static void storeVertex(SlotVertex &out, const Vertex &vertex, ubyte slot);
+        static void storeVertex(PackedVertex &out, const Vertex &vertex, ubyte slot);
+        static void storeVertex(SlotPackedVertex &out, const Vertex &vertex, ubyte slot);
+        static void storeInstance(Instance &out, const Instance &instance, ubyte slot);
+        static void storeInstance(SlotInstance &out, const Instance &instance, ubyte slot);
+
+        /// Write the quads of the sorted glyphs into `out` in the current quad mode, building batches along the way
+        template <typename V>
+        void writeQuads(V *out);
+        /// Write the instances of the sorted glyphs into `out`, building batches along the way
+        template <typename I>
+        void writeInstances(I *out);
+
+        /// Compute quads for `sprites` into `out`, which must have room for `sprites.size()` quads
+        static void expandQuads(span<const SpriteInstance> sprites, Quad *out);
+
+        /// Whether a sprite with the given `drawTexture` parameters lies fully outside of the cull bounds.
+        /// Rotated sprites are tested by the axis-aligned bounds of their rotated quad.
+        [[nodiscard]]
+        bool isCulled(const Rectangle &source, Vector2 position, Vector2 scale, Vector2 anchor, float angle) const;
+
+        /// Axis-aligned bounds of the sprite at `index` in `m_glyphs`
+        [[nodiscard]]
+        FRectangle spriteBounds(uint index) const;
+
+        /// Add a sprite drawn with `texture` to the last batch, or start a new batch at `offset` if the texture
+        /// doesn't fit in its slots.
+        /// @param texture texture the sprite is drawn with
+        /// @param offset  index of the sprite's first vertex / instance
+        /// @param count   number of vertices / instances the sprite takes up
+        /// @returns texture slot the sprite samples from
+        ubyte addToBatch(const Texture2D &texture, uint offset, uint count);
+
+        /// Commands to record GL work into, or nullptr to issue it right away
+        [[nodiscard]]
+        RenderCommandBuffer *recorder() const;
+
+        /// Reserve room for vertices in the program, or in the recorded frame when drawing via a render thread
+        void *mapVertices(int count);
+        /// Commit mapped vertices
+        /// @returns index of the first vertex in the program, or 0 when recording: recorded draws are made relative
+        ///          to where the vertices land instead; -1 if the driver lost them
+        int unmapVertices();
+
         void createBatches();
         void sortGlyphs();
+        void clusterTextures();
         void renderBatches();
+        void recordBatches(RenderCommandBuffer &commands);
     };
 }
@@ -0,0 +1,18 @@
+#include "StaticSpriteBatch2D.h"
+
+namespace sdgl {
+    StaticSpriteBatch2D::StaticSpriteBatch2D()
+    {
+        m_retained = true;
+    }
+
+    void StaticSpriteBatch2D::render(const float *transformMatrix)
+    {
+        renderRetained(transformMatrix);
+    }
+
+    void StaticSpriteBatch2D::textureChanged(const uint previousId, const Texture2D &texture)
+    {
+        retainedTextureChanged(previousId, texture);
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "SpriteBatch2D.h"
+
+namespace sdgl {
+    /// Sprite batch for geometry that doesn't change between frames, e.g. background layers, tilemaps and decor.
+    /// Sprites drawn between `begin` and `end` are sorted, batched and uploaded to a static vertex buffer once,
+    /// then drawn each frame via `render` with only a new transform matrix. Record again with `begin` to change them.
+    class StaticSpriteBatch2D : public SpriteBatch2D {
+    public:
+        StaticSpriteBatch2D();
+        ~StaticSpriteBatch2D() override = default;
+
+        /// Draw the sprites recorded by the last `begin` / `end` pair
+        /// @param transformMatrix matrix to project the sprites with, e.g. from `Camera2D::getMatrix`
+        void render(const float *transformMatrix);
+
+        /// Keep the recorded sprites drawing a texture that was reloaded, or drop them if it was unloaded. Subscribe
+        /// it to the textures' manager:
+        /// `content.onTextureChanged += Callback(&batch, &StaticSpriteBatch2D::textureChanged);`
+        void textureChanged(uint previousId, const Texture2D &texture);
+    };
+}
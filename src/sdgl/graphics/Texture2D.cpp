@@ -1,26 +1,39 @@
 #include "Texture2D.h"
+#include "GLState.h"
 
 #include <sdgl/angles.h>
 #include <sdgl/assert.h>
 #include <sdgl/logging.h>
-#include <sdgl/io/io.h>
+#include <sdgl/io/MappedFile.h>
+#include <sdgl/io/SbcReader.h>
 
 #include <stb_image.h>
 
+#include <algorithm>
+
 
 namespace sdgl {
+    /// Initial value of GL_TEXTURE_MAX_LEVEL, letting the sampler use every level
+    static constexpr GLint DefaultMaxLevel = 1000;
+
     TextureFilter::Enum Texture2D::s_defaultFilter = TextureFilter::Nearest;
 
     bool Texture2D::loadFile(const string &filepath, const TextureFilter::Enum filter)
     {
-        string buffer;
-        if (!io::readFile(filepath, &buffer))
+        // decode straight from the mapped file
+        io::MappedFile file;
+        if (!file.open(filepath))
             return false;
 
-        return loadMem(buffer, filter);
+        return loadMem(file.data(), filter);
     }
 
     bool Texture2D::loadMem(const string &buffer, const TextureFilter::Enum filter)
+    {
+        return loadMem(span(reinterpret_cast<const ubyte *>(buffer.data()), buffer.size()), filter);
+    }
+
+    bool Texture2D::loadMem(const span<const ubyte> buffer, const TextureFilter::Enum filter)
     {
         //stbi_set_flip_vertically_on_load(true);
 
@@ -46,24 +59,113 @@ namespace sdgl {
     {
         SDGL_ASSERT(width * height * 4 == length, "Ensure texture dimensions match buffer size");
 
-        // Generate the GL texture object
-        GLuint textureId;
-        glGenTextures(1, &textureId);
-        if (glGetError() != GL_NO_ERROR)
+        const MipLevel level{data, width, height};
+        return upload({&level, 1}, filter);
+    }
+
+    bool Texture2D::loadSbc(const string &filepath, const TextureFilter::Enum filter)
+    {
+        // upload straight from the mapped file
+        io::MappedFile file;
+        if (!file.open(filepath))
+            return false;
+
+        return loadSbcMem(file.data(), filter);
+    }
+
+    bool Texture2D::loadSbcMem(const span<const ubyte> buffer, const TextureFilter::Enum filter)
+    {
+        io::SbcReader reader;
+        if (!reader.open(buffer, io::sbc::ImageFormat, io::sbc::ImageVersion))
+            return false;
+
+        const auto header = reader.record<io::sbc::ImageHeader>("HEAD");
+        const auto pixels = reader.chunk("DATA");
+        span<const io::sbc::ImageLevel> levels;
+        if (!header || !reader.records("MIPS", &levels) || levels.empty() || levels.size() > MaxMipLevels)
+        {
+            SDGL_ERROR("Failed to load Texture2D from SBC: malformed image header");
+            return false;
+        }
+
+        if (header->format != io::sbc::PixelFormat::RGBA8888)
+        {
+            SDGL_ERROR("Failed to load Texture2D from SBC: unsupported pixel format {}",
+                static_cast<uint>(header->format));
+            return false;
+        }
+
+        if (header->levelCount != levels.size() || header->width == 0 || header->height == 0 ||
+            levels[0].width != header->width || levels[0].height != header->height)
         {
-            SDGL_ERROR("Failed to load Texture2D from bytes: GL failed to generate texture. Error code: {}",
-                glGetError());
+            SDGL_ERROR("Failed to load Texture2D from SBC: mip levels don't match the image header");
             return false;
         }
 
+        // pixels are uploaded straight from the buffer, so the chain is checked before anything is uploaded
+        MipLevel uploads[MaxMipLevels];
+        for (size_t i = 0; i < levels.size(); ++i)
+        {
+            const auto &level = levels[i];
+            if (i > 0 && (level.width != std::max(levels[i - 1].width / 2, 1u) ||
+                level.height != std::max(levels[i - 1].height / 2, 1u)))
+            {
+                SDGL_ERROR("Failed to load Texture2D from SBC: mip level {} is {}x{}, expected half of level {}", i,
+                    level.width, level.height, i - 1);
+                return false;
+            }
+
+            if (level.offset > pixels.size() || level.size > pixels.size() - level.offset ||
+                static_cast<size_t>(level.width) * level.height * 4 != level.size)
+            {
+                SDGL_ERROR("Failed to load Texture2D from SBC: mip level {} is out of range", i);
+                return false;
+            }
+
+            uploads[i] = {pixels.data() + level.offset,
+                static_cast<int>(level.width), static_cast<int>(level.height)};
+        }
+
+        return upload({uploads, levels.size()}, filter);
+    }
+
+    bool Texture2D::upload(const span<const MipLevel> levels, const TextureFilter::Enum filter)
+    {
+        // Reloads respecify the existing GL texture object, so its id, and copies of this texture, stay valid
+        auto textureId = static_cast<GLuint>(m_id);
+        if (!textureId)
+        {
+            glGenTextures(1, &textureId);
+            if (glGetError() != GL_NO_ERROR)
+            {
+                SDGL_ERROR("Failed to load Texture2D from bytes: GL failed to generate texture. Error code: {}",
+                    glGetError());
+                return false;
+            }
+        }
+
         try
         {
             // Pass image data to the texture object
-            glBindTexture(GL_TEXTURE_2D, textureId); GL_ERR_CHECK();
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA,
-                static_cast<GLsizei>(width),
-                static_cast<GLsizei>(height), 0, GL_RGBA,
-                GL_UNSIGNED_BYTE, data); GL_ERR_CHECK();
+            GLState::bindTexture(0, textureId);
+            if (m_id && levels.size() == 1 && m_size == Point(levels[0].width, levels[0].height))
+            {
+                // same size as before: overwrite the storage instead of reallocating it
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
+                    static_cast<GLsizei>(levels[0].width),
+                    static_cast<GLsizei>(levels[0].height), GL_RGBA,
+                    GL_UNSIGNED_BYTE, levels[0].pixels); GL_ERR_CHECK();
+            }
+            else
+            {
+                for (size_t i = 0; i < levels.size(); ++i)
+                {
+                    glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i), GL_RGBA,
+                        static_cast<GLsizei>(levels[i].width),
+                        static_cast<GLsizei>(levels[i].height), 0, GL_RGBA,
+                        GL_UNSIGNED_BYTE, levels[i].pixels); GL_ERR_CHECK();
+                }
+            }
 
             // Set texture parameters
             int texFilter = filter == TextureFilter::Bilinear ? GL_LINEAR : GL_NEAREST;
@@ -72,32 +174,35 @@ namespace sdgl {
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE); GL_ERR_CHECK();
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, texFilter); GL_ERR_CHECK();
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, texFilter); GL_ERR_CHECK();
-            glGenerateMipmap(GL_TEXTURE_2D); GL_ERR_CHECK();
-
-            // Done, unbind texture
-            glBindTexture(GL_TEXTURE_2D, 0); GL_ERR_CHECK(); // unbind
-
-            // Clean up pre-existing texture, if any
-            if (m_id)
+            if (levels.size() > 1) // precomputed chain
             {
-                glDeleteTextures(1, &m_id); GL_ERR_CHECK();
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL,
+                    static_cast<GLint>(levels.size() - 1)); GL_ERR_CHECK();
+            }
+            else
+            {
+                // a reloaded texture may have been limited to a shorter precomputed chain
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, DefaultMaxLevel); GL_ERR_CHECK();
+                glGenerateMipmap(GL_TEXTURE_2D); GL_ERR_CHECK();
             }
 
             // Commit data
             m_id = textureId;
-            m_size = {width, height};
+            m_size = {levels[0].width, levels[0].height};
             return true;
         }
         catch(const std::exception &_)
         {
             // GL_ERR_CHECK handles error reporting
-            glDeleteTextures(1, &textureId);
+            if (textureId != m_id)
+                GLState::deleteTexture(textureId);
             return false;
         }
         catch(...)
         {
             SDGL_ERROR("Failed to load Texture2D from pixel data: unknown error");
-            glDeleteTextures(1, &textureId);
+            if (textureId != m_id)
+                GLState::deleteTexture(textureId);
             return false;
         }
     }
@@ -114,11 +219,80 @@ namespace sdgl {
         return loadBytes(&pixels[0].r, pixels.size() * sizeof(Color), width, height, filter);
     }
 
+    bool Texture2D::updateBytes(const void *data, size_t length, const Rectangle &area)
+    {
+        SDGL_ASSERT(static_cast<size_t>(area.w) * area.h * 4 == length, "Ensure region dimensions match buffer size");
+
+        if (!m_id)
+        {
+            SDGL_ERROR("Failed to update Texture2D: texture is not loaded");
+            return false;
+        }
+
+        if (area.x < 0 || area.y < 0 || area.w < 0 || area.h < 0 ||
+            area.x + area.w > m_size.x || area.y + area.h > m_size.y)
+        {
+            SDGL_ERROR("Failed to update Texture2D: region is out of bounds");
+            return false;
+        }
+
+        try
+        {
+            GLState::bindTexture(0, m_id);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, area.x, area.y, area.w, area.h, GL_RGBA, GL_UNSIGNED_BYTE,
+                data); GL_ERR_CHECK();
+            return true;
+        }
+        catch(const std::exception &_)
+        {
+            // GL_ERR_CHECK handles error reporting
+            return false;
+        }
+    }
+
+    bool Texture2D::generateMipmaps()
+    {
+        if (!m_id)
+        {
+            SDGL_ERROR("Failed to generate Texture2D mipmaps: texture is not loaded");
+            return false;
+        }
+
+        try
+        {
+            GLState::bindTexture(0, m_id);
+            glGenerateMipmap(GL_TEXTURE_2D); GL_ERR_CHECK();
+            return true;
+        }
+        catch(const std::exception &_)
+        {
+            // GL_ERR_CHECK handles error reporting
+            return false;
+        }
+    }
+
+    size_t Texture2D::byteSize() const
+    {
+        if (!m_id)
+            return 0;
+
+        size_t bytes = 0;
+        for (size_t width = m_size.x, height = m_size.y; ; width = std::max<size_t>(width / 2, 1),
+             height = std::max<size_t>(height / 2, 1))
+        {
+            bytes += width * height * 4;
+            if (width == 1 && height == 1)
+                break;
+        }
+
+        return bytes;
+    }
+
     void Texture2D::unload()
     {
         if (m_id)
         {
-            glDeleteTextures(1, &m_id);
+            GLState::deleteTexture(m_id);
             m_id = 0;
             m_size = {};
         }
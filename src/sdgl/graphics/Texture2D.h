@@ -1,6 +1,7 @@
 #pragma once
 #include <sdgl/Asset.h>
 #include <sdgl/sdglib.h>
+#include <sdgl/math/Rectangle.h>
 #include <sdgl/math/Vector2.h>
 
 #include "Color.h"
@@ -18,6 +19,8 @@ namespace sdgl {
     /// Container for a 2D hardware texture
     /// @note non-RAII, make sure to call free once you are done using texture;
     /// @note loads images with uv coords where {0, 0} is on the top-left corner
+    /// @note loading into a loaded texture replaces its image in place, keeping its id, so copies show the new image;
+    /// if the load fails partway, the image may be left incomplete
     class Texture2D final : public Asset
     {
     public:
@@ -35,12 +38,31 @@ namespace sdgl {
 
         bool loadFile(const string &filepath, TextureFilter::Enum filter = getDefaultFilter());
         bool loadMem(const string &buffer, TextureFilter::Enum filter = getDefaultFilter());
+        /// Decode an image file from a view of it, e.g. a `io::MappedFile`, without copying it
+        bool loadMem(span<const ubyte> buffer, TextureFilter::Enum filter = getDefaultFilter());
 
         /// Load texture data from format RGBA8888
         bool loadBytes(const void *data, size_t length, int width, int height, TextureFilter::Enum filter);
         bool loadBytes(string_view buffer, int width, int height, TextureFilter::Enum filter);
         bool loadBytes(const vector<Color> &pixels, int width, int height, TextureFilter::Enum filter);
 
+        /// Overwrite part of a loaded texture with RGBA8888 pixels. Only the full-size level is updated: the filters
+        /// of `TextureFilter` don't sample the mip chain, so call `generateMipmaps` once after a batch of updates if
+        /// the chain must match.
+        /// @param data   pixels of the region, rows tightly packed
+        /// @param length byte size of `data`, `area.w * area.h * 4`
+        /// @param area   region of the texture to overwrite, must be within its bounds
+        bool updateBytes(const void *data, size_t length, const Rectangle &area);
+
+        /// Regenerate the mip chain of a loaded texture from its full-size level
+        bool generateMipmaps();
+
+        /// Load an SBC IMG file, uploading its precomputed mip chain as-is
+        bool loadSbc(const string &filepath, TextureFilter::Enum filter = getDefaultFilter());
+        /// Load SBC IMG data in place
+        /// @param buffer file contents, must be 4-byte aligned
+        bool loadSbcMem(span<const ubyte> buffer, TextureFilter::Enum filter = getDefaultFilter());
+
         /// Graphics library texture id, castable to ImGui image type
         [[nodiscard]]
         auto id() const { return m_id; }
@@ -49,12 +71,30 @@ namespace sdgl {
         [[nodiscard]]
         auto size() const { return m_size; }
 
+        /// Estimated GPU memory used by the texture: RGBA8888 with a full mip chain, as every load creates
+        [[nodiscard]]
+        size_t byteSize() const;
+
         /// This should be manually called, as the destructor will not call it
         void unload() override;
 
         static void setDefaultFilter(TextureFilter::Enum filterType) { s_defaultFilter = filterType; }
         static TextureFilter::Enum getDefaultFilter() { return s_defaultFilter; }
     private:
+        /// Enough levels to reduce the largest GL texture to 1x1
+        static constexpr size_t MaxMipLevels = 32;
+
+        struct MipLevel
+        {
+            const void *pixels;
+            int width;
+            int height;
+        };
+
+        /// Create the GL texture, or respecify the loaded one, from one or more mip levels; with a single level, the
+        /// chain is generated
+        bool upload(span<const MipLevel> levels, TextureFilter::Enum filter);
+
         static TextureFilter::Enum s_defaultFilter;
 
         uint m_id;
@@ -0,0 +1,446 @@
+#include "TileMap.h"
+#include "SpriteBatchBase2D.h"
+#include "spriteBatch2DShader.inl"
+
+#include <sdgl/angles.h>
+#include <sdgl/Camera2D.h>
+#include <sdgl/graphics/atlas/TextureAtlas.h>
+#include <sdgl/math/geometry.h>
+
+#include <glm/vec2.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace sdgl {
+    static constexpr int MaxTextureSlots = SpriteBatchBase2D::MaxTextureSlots;
+
+    TileMap::TileMap() : m_program(), u_texture(), u_projMtx(), u_texSize(), m_textureSlots(1), m_width(0),
+        m_height(0), m_tileWidth(0), m_tileHeight(0), m_chunkSize(0), m_chunksX(0), m_chunksY(0), m_chunks(),
+        m_tileQuads(), m_textures(), m_tileExtents(), m_tint(Color::White), m_slotCapacity(0), m_slotCount(0),
+        m_freeSlots(), m_vertices(), m_stats()
+    {
+    }
+
+    TileMap::~TileMap()
+    {
+        dispose();
+    }
+
+    bool TileMap::init(const int width, const int height, const int tileWidth, const int tileHeight,
+        int chunkSize, int textureSlots)
+    {
+        SDGL_ASSERT(width >= 0 && height >= 0);
+        SDGL_ASSERT(tileWidth > 0 && tileHeight > 0);
+
+        dispose();
+
+        // clamp texture slots to what the fragment shader can sample from
+        int maxTextureUnits = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxTextureUnits); GL_ERR_CHECK();
+        textureSlots = std::clamp(textureSlots, 1, std::max(std::min(maxTextureUnits, MaxTextureSlots), 1));
+        chunkSize = std::clamp(chunkSize, 1, MaxChunkSize);
+
+        const auto loaded = m_program.init({
+            .vertShader = detail::spriteBatch2dShader(detail::spriteBatch2dVertShader, textureSlots),
+            .fragShader = detail::spriteBatch2dShader(detail::spriteBatch2dFragShader, textureSlots),
+            .attributes = ShaderAttribs()
+                .attrib(&Vertex::position, GLType::Float, 2)
+                .attrib(&Vertex::texcoord, GLType::Float, 2)
+                .attrib(&Vertex::color, GLType::Ubyte, 4, true)
+                .attrib(&Vertex::slot),
+            .openFiles = false,
+        });
+
+        if (!loaded)
+        {
+            SDGL_ERROR("TileMap failed to initialize its render program");
+            return false;
+        }
+
+        u_texture = m_program.shader()->locateUniform("u_Texture");
+        u_projMtx = m_program.shader()->locateUniform("u_ProjMtx");
+        u_texSize = m_program.shader()->locateUniform("u_TexSize");
+        m_program.setQuadIndices(chunkSize * chunkSize);
+        m_textureSlots = textureSlots;
+
+        m_width = width;
+        m_height = height;
+        m_tileWidth = tileWidth;
+        m_tileHeight = tileHeight;
+        m_chunkSize = chunkSize;
+        m_chunksX = (width + chunkSize - 1) / chunkSize;
+        m_chunksY = (height + chunkSize - 1) / chunkSize;
+        m_chunks.assign(static_cast<size_t>(m_chunksX) * m_chunksY, Chunk{
+            .tiles = vector<uint16>(static_cast<size_t>(chunkSize) * chunkSize, EmptyTile),
+            .batches = {},
+            .textures = {},
+            .bounds = {},
+            .quadCount = 0,
+            .slot = -1,
+            .dirty = false,
+        });
+
+        return true;
+    }
+
+    void TileMap::dispose()
+    {
+        m_program.dispose();
+        m_chunks.clear();
+        m_freeSlots.clear();
+        m_vertices.clear();
+        m_slotCapacity = 0;
+        m_slotCount = 0;
+        m_width = 0;
+        m_height = 0;
+        m_chunksX = 0;
+        m_chunksY = 0;
+    }
+
+    void TileMap::setTileset(const span<const Frame> frames)
+    {
+        m_tileQuads.clear();
+        m_textures.clear();
+
+        auto left = std::numeric_limits<float>::max(), top = std::numeric_limits<float>::max();
+        auto right = std::numeric_limits<float>::lowest(), bottom = std::numeric_limits<float>::lowest();
+        for (const auto &frame : frames)
+        {
+            SDGL_ASSERT(frame.texture.id(), "Tileset frame textures must be loaded");
+
+            auto texture = std::find_if(m_textures.begin(), m_textures.end(),
+                [&frame](const Texture2D &other) { return other.id() == frame.texture.id(); });
+            if (texture == m_textures.end())
+                texture = m_textures.insert(m_textures.end(), frame.texture);
+
+            // same placement as `SpriteBatchBase2D::drawFrame` with no anchor
+            Vector2 anchor;
+            float angle = 0;
+            if (frame.rotated)
+            {
+                anchor = Vector2{(float)frame.frame.w - (float)frame.offset.y, (float)frame.offset.x};
+                angle = -mathf::HalfPi;
+            }
+            else
+            {
+                anchor = Vector2{(float)frame.offset.x, (float)frame.offset.y};
+            }
+
+            const auto texCoords = static_cast<FRectangle>(frame.frame);
+
+            TileQuad quad;
+            quad.texture = static_cast<uint16>(texture - m_textures.begin());
+            quad.corners[0] = mathf::rotate(-anchor, angle);
+            quad.corners[1] = mathf::rotate(Vector2(-anchor.x, texCoords.h - anchor.y), angle);
+            quad.corners[2] = mathf::rotate(Vector2(texCoords.w - anchor.x, -anchor.y), angle);
+            quad.corners[3] = mathf::rotate(Vector2(texCoords.w - anchor.x, texCoords.h - anchor.y), angle);
+            quad.texcoords[0] = texCoords.topleft();
+            quad.texcoords[1] = texCoords.bottomleft();
+            quad.texcoords[2] = texCoords.topright();
+            quad.texcoords[3] = texCoords.bottomright();
+
+            for (const auto &corner : quad.corners)
+            {
+                left = std::min(left, corner.x);
+                top = std::min(top, corner.y);
+                right = std::max(right, corner.x);
+                bottom = std::max(bottom, corner.y);
+            }
+
+            m_tileQuads.emplace_back(quad);
+        }
+
+        m_tileExtents = m_tileQuads.empty() ? FRectangle{} : FRectangle(left, top, right - left, bottom - top);
+        markAllDirty();
+    }
+
+    void TileMap::setTileset(const TextureAtlas &atlas, const span<const string> frameNames)
+    {
+        vector<Frame> frames;
+        frames.reserve(frameNames.size());
+        for (const auto &name : frameNames)
+            frames.emplace_back(atlas.at(name));
+
+        setTileset(frames);
+    }
+
+    void TileMap::setTile(const int x, const int y, const uint16 tile)
+    {
+        if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+            return;
+
+        writeTile(x, y, tile);
+    }
+
+    void TileMap::setTiles(const Rectangle &region, const span<const uint16> tiles)
+    {
+        SDGL_ASSERT(region.w >= 0 && region.h >= 0);
+        SDGL_ASSERT(tiles.size() >= static_cast<size_t>(region.w) * region.h);
+
+        const auto left = std::max(region.left(), 0), right = std::min(region.right(), m_width);
+        const auto top = std::max(region.top(), 0), bottom = std::min(region.bottom(), m_height);
+        for (int y = top; y < bottom; ++y)
+        {
+            const auto row = tiles.data() + static_cast<size_t>(y - region.y) * region.w;
+            for (int x = left; x < right; ++x)
+                writeTile(x, y, row[x - region.x]);
+        }
+    }
+
+    void TileMap::fill(const Rectangle &region, const uint16 tile)
+    {
+        const auto left = std::max(region.left(), 0), right = std::min(region.right(), m_width);
+        const auto top = std::max(region.top(), 0), bottom = std::min(region.bottom(), m_height);
+        for (int y = top; y < bottom; ++y)
+        {
+            for (int x = left; x < right; ++x)
+                writeTile(x, y, tile);
+        }
+    }
+
+    uint16 TileMap::getTile(const int x, const int y) const
+    {
+        if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+            return EmptyTile;
+
+        const auto &chunk = m_chunks[(y / m_chunkSize) * m_chunksX + x / m_chunkSize];
+        return chunk.tiles[(y % m_chunkSize) * m_chunkSize + x % m_chunkSize];
+    }
+
+    void TileMap::writeTile(const int x, const int y, const uint16 tile)
+    {
+        auto &chunk = m_chunks[(y / m_chunkSize) * m_chunksX + x / m_chunkSize];
+        auto &value = chunk.tiles[(y % m_chunkSize) * m_chunkSize + x % m_chunkSize];
+        if (value != tile)
+        {
+            value = tile;
+            chunk.dirty = true;
+        }
+    }
+
+    TileMap &TileMap::setTint(const Color tint)
+    {
+        if (tint.toRGBA() != m_tint.toRGBA())
+        {
+            m_tint = tint;
+            markAllDirty();
+        }
+
+        return *this;
+    }
+
+    void TileMap::render(const Camera2D &camera)
+    {
+        render(camera.getMatrix(), camera.getWorldBounds());
+    }
+
+    void TileMap::render(const float *transformMatrix, const FRectangle &viewBounds)
+    {
+        m_stats = {};
+        if (m_chunks.empty() || m_tileQuads.empty())
+            return;
+
+        SDGL_ASSERT(m_program.isLoaded(), "TileMap must be initialized before rendering");
+
+        // range of chunks with cells whose quads may reach into the view, as quads may overhang their cell
+        const auto chunkWidth = static_cast<float>(m_tileWidth * m_chunkSize);
+        const auto chunkHeight = static_cast<float>(m_tileHeight * m_chunkSize);
+        const auto toChunk = [](const float position, const float chunkSize, const int chunkCount) {
+            return static_cast<int>(std::clamp(std::floor(position / chunkSize), -1.f, (float)chunkCount));
+        };
+
+        const auto left = std::max(toChunk(viewBounds.left() - m_tileExtents.right(), chunkWidth, m_chunksX), 0);
+        const auto right = std::min(toChunk(viewBounds.right() - m_tileExtents.left(), chunkWidth, m_chunksX),
+            m_chunksX - 1);
+        const auto top = std::max(toChunk(viewBounds.top() - m_tileExtents.bottom(), chunkHeight, m_chunksY), 0);
+        const auto bottom = std::min(toChunk(viewBounds.bottom() - m_tileExtents.top(), chunkHeight, m_chunksY),
+            m_chunksY - 1);
+
+        if (left > right || top > bottom)
+            return;
+
+        // bake before drawing; growing the vertex buffer discards all baked regions, so bake again if it grew
+        int capacity;
+        do {
+            capacity = m_slotCapacity;
+            for (int y = top; y <= bottom; ++y)
+            {
+                for (int x = left; x <= right; ++x)
+                {
+                    auto &chunk = m_chunks[y * m_chunksX + x];
+                    if (chunk.dirty)
+                        bakeChunk(chunk, x, y);
+                }
+            }
+        } while (capacity != m_slotCapacity);
+
+        m_program.resetDrawStats();
+        m_program.shader()->setUniformMatrix(u_projMtx, transformMatrix);
+
+        const auto quadsPerChunk = m_chunkSize * m_chunkSize;
+        for (int y = top; y <= bottom; ++y)
+        {
+            for (int x = left; x <= right; ++x)
+            {
+                const auto &chunk = m_chunks[y * m_chunksX + x];
+                if (chunk.quadCount == 0)
+                    continue;
+
+                if (!mathf::intersects(chunk.bounds, viewBounds))
+                {
+                    ++m_stats.chunksCulled;
+                    continue;
+                }
+
+                for (const auto &batch : chunk.batches)
+                {
+                    const auto textures = chunk.textures.data() + batch.firstTexture;
+                    glm::vec2 texSizes[MaxTextureSlots];
+                    for (int i = 0; i < batch.textureCount; ++i)
+                    {
+                        const auto size = textures[i].size();
+                        texSizes[i] = {static_cast<float>(size.x), static_cast<float>(size.y)};
+                    }
+
+                    m_program.shader()->setUniform(u_texSize, texSizes, batch.textureCount);
+                    m_program.shader()->setUniform(u_texture, textures, batch.textureCount);
+
+                    // GLES3 lacks glDrawElementsBaseVertex: point the attributes at the batch's first vertex
+                    m_program.setBaseVertex((chunk.slot * quadsPerChunk + batch.firstQuad) * 4);
+                    m_program.render(PrimitiveType::Triangles, 0, batch.quadCount * 6);
+                }
+
+                ++m_stats.chunksDrawn;
+                m_stats.tilesDrawn += static_cast<uint>(chunk.quadCount);
+            }
+        }
+
+        m_stats.drawCalls = m_program.drawStats().drawCalls;
+    }
+
+    void TileMap::bakeChunk(Chunk &chunk, const int chunkX, const int chunkY)
+    {
+        chunk.dirty = false;
+        chunk.batches.clear();
+        chunk.textures.clear();
+        m_vertices.clear();
+
+        auto left = std::numeric_limits<float>::max(), top = std::numeric_limits<float>::max();
+        auto right = std::numeric_limits<float>::lowest(), bottom = std::numeric_limits<float>::lowest();
+        const auto originX = chunkX * m_chunkSize, originY = chunkY * m_chunkSize;
+        for (int y = 0; y < m_chunkSize; ++y)
+        {
+            const auto row = chunk.tiles.data() + static_cast<size_t>(y) * m_chunkSize;
+            for (int x = 0; x < m_chunkSize; ++x)
+            {
+                const auto tile = row[x];
+                if (tile == EmptyTile || tile > m_tileQuads.size())
+                    continue;
+
+                const auto &quad = m_tileQuads[tile - 1];
+                const auto &texture = m_textures[quad.texture];
+
+                // find the texture's slot in the current batch, starting a new batch once all slots are taken
+                auto batch = chunk.batches.empty() ? nullptr : &chunk.batches.back();
+                int slot = -1;
+                for (int i = 0; batch && i < batch->textureCount; ++i)
+                {
+                    if (chunk.textures[batch->firstTexture + i].id() == texture.id())
+                    {
+                        slot = i;
+                        break;
+                    }
+                }
+
+                if (slot < 0)
+                {
+                    if (!batch || batch->textureCount == m_textureSlots)
+                    {
+                        batch = &chunk.batches.emplace_back(ChunkBatch{
+                            static_cast<int>(m_vertices.size() / 4), 0, static_cast<int>(chunk.textures.size()), 0
+                        });
+                    }
+
+                    chunk.textures.emplace_back(texture);
+                    slot = batch->textureCount++;
+                }
+                ++batch->quadCount;
+
+                const auto position = Vector2{
+                    static_cast<float>((originX + x) * m_tileWidth),
+                    static_cast<float>((originY + y) * m_tileHeight)
+                };
+                for (int i = 0; i < 4; ++i)
+                {
+                    const auto corner = position + quad.corners[i];
+                    m_vertices.push_back({corner, quad.texcoords[i], m_tint, static_cast<ubyte>(slot)});
+
+                    left = std::min(left, corner.x);
+                    top = std::min(top, corner.y);
+                    right = std::max(right, corner.x);
+                    bottom = std::max(bottom, corner.y);
+                }
+            }
+        }
+
+        chunk.quadCount = static_cast<int>(m_vertices.size() / 4);
+        if (chunk.quadCount == 0)
+        {
+            if (chunk.slot >= 0)
+            {
+                m_freeSlots.emplace_back(chunk.slot);
+                chunk.slot = -1;
+            }
+
+            chunk.bounds = {};
+            return;
+        }
+
+        chunk.bounds = FRectangle(left, top, right - left, bottom - top);
+
+        if (chunk.slot < 0)
+        {
+            if (!m_freeSlots.empty())
+            {
+                chunk.slot = m_freeSlots.back();
+                m_freeSlots.pop_back();
+            }
+            else
+            {
+                if (m_slotCount == m_slotCapacity)
+                    reserveSlots(m_slotCount + 1);
+                chunk.slot = m_slotCount++;
+            }
+        }
+
+        m_program.updateVertices(m_vertices.data(), chunk.slot * m_chunkSize * m_chunkSize * 4,
+            static_cast<int>(m_vertices.size()));
+
+        ++m_stats.chunksBaked;
+        m_stats.bytesUploaded += sizeof(Vertex) * m_vertices.size();
+    }
+
+    void TileMap::reserveSlots(const int slotCount)
+    {
+        // grow geometrically so that rebakes of everything are rare
+        const auto capacity = std::min(std::max(slotCount, m_slotCapacity * 2), static_cast<int>(m_chunks.size()));
+        m_program.setVertices(nullptr, capacity * m_chunkSize * m_chunkSize * 4);
+
+        // the new storage holds none of the baked regions
+        for (auto &chunk : m_chunks)
+        {
+            if (chunk.slot >= 0)
+                chunk.dirty = true;
+        }
+
+        m_slotCapacity = capacity;
+    }
+
+    void TileMap::markAllDirty()
+    {
+        for (auto &chunk : m_chunks)
+            chunk.dirty = true;
+    }
+}
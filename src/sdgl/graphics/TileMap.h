@@ -0,0 +1,178 @@
+#pragma once
+#include <sdgl/graphics/Color.h>
+#include <sdgl/graphics/Frame.h>
+#include <sdgl/math/Rectangle.h>
+#include <sdgl/math/Vector2.h>
+
+#include "RenderProgram.h"
+
+namespace sdgl {
+    class Camera2D;
+    class TextureAtlas;
+
+    /// Tile map counters, reset by each call to `TileMap::render`
+    struct TileMapStats
+    {
+        uint chunksDrawn = 0;      ///< number of chunks that intersected the view
+        uint chunksCulled = 0;     ///< number of baked chunks near the view that lay outside of it
+        uint chunksBaked = 0;      ///< number of chunks whose vertices were rebuilt
+        uint tilesDrawn = 0;       ///< number of tile quads in the drawn chunks
+        uint drawCalls = 0;        ///< number of draw calls issued
+        size_t bytesUploaded = 0;  ///< number of vertex bytes written to the graphics card
+    };
+
+    /// Grid of tiles drawn from texture atlas frames.
+    /// Tiles are stored in dense chunks of `chunkSize` x `chunkSize` tile values. Each chunk bakes its quads into its
+    /// own region of a static vertex buffer, which is redrawn with one draw call per frame (more only if a chunk
+    /// samples more textures than there are texture slots) for as long as its tiles don't change. Only chunks
+    /// intersecting the view are drawn; changing a tile rebakes its chunk the next time it's in view.
+    /// `render` makes GL calls right away; while a `RenderThread` is running, call it from a recorded `invoke`.
+    class TileMap {
+    public:
+        /// Tile value of an empty cell
+        static constexpr uint16 EmptyTile = 0;
+        static constexpr int DefaultChunkSize = 32;
+        /// Largest chunk size, keeping a chunk's quads addressable by 16-bit indices
+        static constexpr int MaxChunkSize = 64;
+
+        TileMap();
+        ~TileMap();
+
+        TileMap(const TileMap &) = delete;
+        TileMap &operator=(const TileMap &) = delete;
+
+        /// Initialize graphics resources and allocate an empty map; must be called before rendering
+        /// @param width        number of tile columns
+        /// @param height       number of tile rows
+        /// @param tileWidth    width of a cell in pixels
+        /// @param tileHeight   height of a cell in pixels
+        /// @param chunkSize    width and height of a chunk in tiles, 1 to `MaxChunkSize`
+        /// @param textureSlots number of textures bound per draw call, see `SpriteBatchBase2D::init`
+        /// @returns whether initialization succeeded
+        bool init(int width, int height, int tileWidth, int tileHeight, int chunkSize = DefaultChunkSize,
+            int textureSlots = 1);
+
+        /// Release graphics resources and tiles
+        void dispose();
+
+        /// Set the frames that tile values refer to: value `i` draws `frames[i - 1]`, `EmptyTile` draws nothing.
+        /// Each frame is resolved into a quad once, placed like `SpriteBatchBase2D::drawFrame` at the cell's
+        /// top-left corner. All chunks are rebaked.
+        void setTileset(span<const Frame> frames);
+
+        /// Set the tileset from frames of an atlas, value `i` drawing frame `frameNames[i - 1]`
+        /// @throws std::out_of_range if the atlas does not contain one of the frames
+        void setTileset(const TextureAtlas &atlas, span<const string> frameNames);
+
+        /// Set the value of a cell; out of range cells are ignored
+        void setTile(int x, int y, uint16 tile);
+
+        /// Set a region of cells at once, marking each affected chunk for rebaking only once
+        /// @param region cells to set, clipped to the map
+        /// @param tiles  `region.w * region.h` values in row-major order
+        void setTiles(const Rectangle &region, span<const uint16> tiles);
+
+        /// Set every cell of a region to the same value
+        void fill(const Rectangle &region, uint16 tile);
+
+        /// @returns value of a cell, or `EmptyTile` if out of range
+        [[nodiscard]]
+        uint16 getTile(int x, int y) const;
+
+        /// Color all tiles are tinted with. Changing it rebakes all chunks.
+        TileMap &setTint(Color tint);
+        [[nodiscard]]
+        Color getTint() const { return m_tint; }
+
+        /// Draw the chunks visible to a camera
+        void render(const Camera2D &camera);
+
+        /// Draw the chunks intersecting a rectangle
+        /// @param transformMatrix matrix to project tiles with
+        /// @param viewBounds      world-space rectangle that is visible through the matrix
+        void render(const float *transformMatrix, const FRectangle &viewBounds);
+
+        [[nodiscard]]
+        const TileMapStats &stats() const { return m_stats; }
+
+        [[nodiscard]]
+        int width() const { return m_width; }
+        [[nodiscard]]
+        int height() const { return m_height; }
+        [[nodiscard]]
+        Vec2<int> tileSize() const { return {m_tileWidth, m_tileHeight}; }
+        [[nodiscard]]
+        int chunkSize() const { return m_chunkSize; }
+
+    private:
+        struct Vertex
+        {
+            Vector2  position;
+            Vector2  texcoord;
+            Color    color;
+            ubyte    slot;     ///< texture slot to sample from within the chunk batch
+        };
+
+        /// Tileset frame resolved into a quad relative to its cell, corners ordered top-left, bottom-left,
+        /// top-right, bottom-right
+        struct TileQuad
+        {
+            uint16 texture;       ///< index into `m_textures`
+            Vector2 corners[4];
+            Vector2 texcoords[4];
+        };
+
+        /// Run of a chunk's quads drawn with one call
+        struct ChunkBatch
+        {
+            int firstQuad;
+            int quadCount;
+            int firstTexture;  ///< index of the first texture in `Chunk::textures`
+            int textureCount;
+        };
+
+        struct Chunk
+        {
+            vector<uint16> tiles;        ///< `chunkSize * chunkSize` values in row-major order
+            vector<ChunkBatch> batches;
+            vector<Texture2D> textures;  ///< textures bound to the batches' slots
+            FRectangle bounds;           ///< world-space bounds of the baked quads
+            int quadCount;
+            int slot;                    ///< region of the vertex buffer holding the quads, or -1
+            bool dirty;
+        };
+
+        /// Set a cell that is known to be in range, marking its chunk for rebaking if the value changed
+        void writeTile(int x, int y, uint16 tile);
+
+        /// Rebuild a chunk's vertices and upload them into its vertex buffer region
+        void bakeChunk(Chunk &chunk, int chunkX, int chunkY);
+
+        /// Grow the vertex buffer to hold at least `slotCount` chunk regions; regions lose their contents
+        void reserveSlots(int slotCount);
+
+        void markAllDirty();
+
+        RenderProgram m_program;
+        int u_texture, u_projMtx, u_texSize;
+        int m_textureSlots;
+
+        int m_width, m_height;
+        int m_tileWidth, m_tileHeight;
+        int m_chunkSize;
+        int m_chunksX, m_chunksY;
+        vector<Chunk> m_chunks;
+
+        vector<TileQuad> m_tileQuads;  ///< tileset, indexed by tile value - 1
+        vector<Texture2D> m_textures;  ///< distinct textures of the tileset
+        FRectangle m_tileExtents;      ///< union of tileset quads relative to their cell
+        Color m_tint;
+
+        int m_slotCapacity;            ///< number of chunk regions the vertex buffer can hold
+        int m_slotCount;               ///< number of chunk regions handed out
+        vector<int> m_freeSlots;
+        vector<Vertex> m_vertices;     ///< scratch for baking
+
+        TileMapStats m_stats;
+    };
+}
@@ -14,7 +14,14 @@
 
 namespace sdgl {
 
-    bool CrunchAtlasData::loadBinary(const string &buffer, bool trimEnabled, bool rotateEnabled,
+    bool CrunchAtlasData::loadBinary(const string &buffer, const bool trimEnabled, const bool rotateEnabled,
+        CrunchAtlasData *outData)
+    {
+        return loadBinary(span(reinterpret_cast<const ubyte *>(buffer.data()), buffer.size()),
+            trimEnabled, rotateEnabled, outData);
+    }
+
+    bool CrunchAtlasData::loadBinary(const span<const ubyte> buffer, bool trimEnabled, bool rotateEnabled,
         CrunchAtlasData *outData)
     {
        auto view = io::BufferView(buffer, io::Endian::Little);
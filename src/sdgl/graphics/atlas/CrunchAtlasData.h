@@ -12,6 +12,9 @@ namespace sdgl {
         ///
         /// @returns whether function was successful
         static bool loadBinary(const string &buffer, bool trimEnabled, bool rotateEnabled, CrunchAtlasData *outData);
+        /// Load crunch atlas data from a view of a binary file, e.g. a `io::MappedFile`, without copying it
+        static bool loadBinary(span<const ubyte> buffer, bool trimEnabled, bool rotateEnabled,
+            CrunchAtlasData *outData);
 
         struct Image
         {
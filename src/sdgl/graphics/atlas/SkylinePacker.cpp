@@ -0,0 +1,120 @@
+#include "SkylinePacker.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace sdgl {
+    SkylinePacker::SkylinePacker(const int width, const int height) :
+        m_width(), m_height(), m_skyline(), m_usedArea()
+    {
+        reset(width, height);
+    }
+
+    void SkylinePacker::reset(const int width, const int height)
+    {
+        m_width = std::max(width, 0);
+        m_height = std::max(height, 0);
+        m_usedArea = 0;
+
+        m_skyline.clear();
+        if (m_width > 0)
+            m_skyline.push_back({0, 0, m_width});
+    }
+
+    int SkylinePacker::fit(const size_t index, const int width, const int height) const
+    {
+        const auto x = m_skyline[index].x;
+        if (x + width > m_width)
+            return -1;
+
+        // segments cover the full width, so the rectangle can't run past the last one
+        auto y = 0;
+        for (size_t i = index, widthLeft = width; widthLeft > 0; ++i)
+        {
+            y = std::max(y, m_skyline[i].y);
+            if (y + height > m_height)
+                return -1;
+
+            widthLeft -= std::min<size_t>(widthLeft, m_skyline[i].width);
+        }
+
+        return y;
+    }
+
+    bool SkylinePacker::insert(const int width, const int height, Point *outPosition)
+    {
+        if (width <= 0 || height <= 0)
+            return false;
+
+        auto bestIndex = m_skyline.size();
+        auto bestBottom = std::numeric_limits<int>::max();
+        auto bestWidth = std::numeric_limits<int>::max();
+        auto bestY = 0;
+        for (size_t i = 0; i < m_skyline.size(); ++i)
+        {
+            const auto y = fit(i, width, height);
+            if (y < 0)
+                continue;
+
+            if (y + height < bestBottom || (y + height == bestBottom && m_skyline[i].width < bestWidth))
+            {
+                bestIndex = i;
+                bestBottom = y + height;
+                bestWidth = m_skyline[i].width;
+                bestY = y;
+            }
+        }
+
+        if (bestIndex == m_skyline.size())
+            return false;
+
+        // Raise the skyline over the rectangle
+        const Segment raised{m_skyline[bestIndex].x, bestY + height, width};
+        m_skyline.insert(m_skyline.begin() + static_cast<ptrdiff_t>(bestIndex), raised);
+
+        // Trim the segments it covers
+        const auto right = raised.x + raised.width;
+        for (auto i = bestIndex + 1; i < m_skyline.size(); )
+        {
+            auto &segment = m_skyline[i];
+            if (segment.x >= right)
+                break;
+
+            const auto overlap = right - segment.x;
+            if (overlap >= segment.width)
+            {
+                m_skyline.erase(m_skyline.begin() + static_cast<ptrdiff_t>(i));
+                continue;
+            }
+
+            segment.x += overlap;
+            segment.width -= overlap;
+            break;
+        }
+
+        // Merge neighbours of equal height
+        for (size_t i = 0; i + 1 < m_skyline.size(); )
+        {
+            if (m_skyline[i].y == m_skyline[i + 1].y)
+            {
+                m_skyline[i].width += m_skyline[i + 1].width;
+                m_skyline.erase(m_skyline.begin() + static_cast<ptrdiff_t>(i + 1));
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        m_usedArea += static_cast<uint64>(width) * height;
+        if (outPosition)
+            *outPosition = {raised.x, bestY};
+        return true;
+    }
+
+    float SkylinePacker::occupancy() const
+    {
+        const auto area = static_cast<uint64>(m_width) * m_height;
+        return area ? static_cast<float>(static_cast<double>(m_usedArea) / static_cast<double>(area)) : 0;
+    }
+}
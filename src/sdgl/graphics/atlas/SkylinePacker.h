@@ -0,0 +1,53 @@
+#pragma once
+#include <sdgl/sdglib.h>
+#include <sdgl/math/Vector2.h>
+
+namespace sdgl {
+    /// Packs rectangles into a fixed-size area one at a time, tracking the top edge of the packed rectangles as a
+    /// skyline of horizontal segments. Each rectangle goes where its bottom edge ends up lowest, preferring the
+    /// tightest segment, which keeps waste low without knowing later rectangles. Space under the skyline that was
+    /// skipped can't be reclaimed; `reset` and repack to compact.
+    class SkylinePacker {
+    public:
+        SkylinePacker() : m_width(), m_height(), m_skyline(), m_usedArea() { }
+        SkylinePacker(int width, int height);
+
+        /// Empty the area, resizing it
+        void reset(int width, int height);
+
+        /// Find room for a rectangle and claim it
+        /// @param width            width of the rectangle
+        /// @param height           height of the rectangle
+        /// @param outPosition [out] receives the top-left corner of the rectangle
+        /// @returns whether the rectangle fit
+        bool insert(int width, int height, Point *outPosition);
+
+        [[nodiscard]]
+        int width() const { return m_width; }
+
+        [[nodiscard]]
+        int height() const { return m_height; }
+
+        /// Fraction of the area claimed by inserted rectangles, from 0 to 1
+        [[nodiscard]]
+        float occupancy() const;
+
+    private:
+        struct Segment
+        {
+            int x;
+            int y;      ///< top of the space left above the segment
+            int width;
+        };
+
+        /// Top of a rectangle placed at the start of a segment, resting on the highest segment it spans
+        /// @returns the top, or -1 if the rectangle doesn't fit there
+        [[nodiscard]]
+        int fit(size_t index, int width, int height) const;
+
+        int m_width;
+        int m_height;
+        vector<Segment> m_skyline;  ///< sorted by x, covering the full width
+        uint64 m_usedArea;
+    };
+}
@@ -1,10 +1,17 @@
 #include "TextureAtlas.h"
 #include "CrunchAtlasData.h"
 
+#include <sdgl/assert.h>
 #include <sdgl/logging.h>
-#include <sdgl/io/io.h>
+#include <sdgl/io/MappedFile.h>
+#include <sdgl/io/SbcReader.h>
 
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cstring>
 #include <filesystem>
+#include <limits>
 
 namespace sdgl {
 
@@ -15,17 +22,22 @@ namespace sdgl {
 
     bool TextureAtlas::loadCrunch(const string &filepath)
     {
-        // Load file
-        string fileBuffer;
-        if (!io::readFile(filepath, &fileBuffer))
+        // Map file, it's parsed in place
+        io::MappedFile file;
+        if (!file.open(filepath))
         {
             return false;
         }
 
-        return loadCrunchMem(filepath, fileBuffer);
+        return loadCrunchMem(filepath, file.data());
     }
 
     bool TextureAtlas::loadCrunchMem(const string &filepath, const string &fileBuffer)
+    {
+        return loadCrunchMem(filepath, span(reinterpret_cast<const ubyte *>(fileBuffer.data()), fileBuffer.size()));
+    }
+
+    bool TextureAtlas::loadCrunchMem(const string &filepath, const span<const ubyte> fileBuffer)
     {
        // Load crunch map
         CrunchAtlasData data;
@@ -39,6 +51,8 @@ namespace sdgl {
             // Get data from crunch map
             vector<Texture2D> textures;              ///< texture 2D to collect
             textures.reserve(data.textures.size());
+            vector<string> pageFiles;                ///< file of each texture
+            pageFiles.reserve(data.textures.size());
             map<string, Frame> frames;               ///< frames for each texture to collect
 
             auto path = std::filesystem::path(filepath);
@@ -47,15 +61,16 @@ namespace sdgl {
             for (const auto &[texFileName, texImages] : data.textures)
             {
                 // Load texture for atlas page
-                Texture2D curTexture;
-                if (!curTexture.loadFile( (parentPath / texFileName).string() + ".png" ))
+                auto curTexture = reusePage(textures.size());
+                auto pageFile = (parentPath / texFileName).string() + ".png";
+                if (!curTexture.loadFile(pageFile))
                 {
-                    for (auto &t : textures)
-                        t.unload();
+                    discardPages(textures);
                     return false;
                 }
 
                 textures.emplace_back(curTexture);
+                pageFiles.emplace_back(std::move(pageFile));
 
                 // Get frames for this texture
                 for (const auto &curImage : texImages)
@@ -73,27 +88,445 @@ namespace sdgl {
             }
 
             // Done commit changes
-            // Clear any existing textures
-            if (!m_textures.empty())
+            clearPackedPages();
+            commitPages(textures, pageFiles);
+            replaceFrames(frames);
+            return true;
+        }
+        catch(const std::exception &e)
+        {
+            SDGL_ERROR("Failed to load crunch file: {}", e.what());
+            return false;
+        }
+        catch(...)
+        {
+            SDGL_ERROR("Failed to load crunch file: unknown error");
+            return false;
+        }
+    }
+
+    bool TextureAtlas::loadSbc(const string &filepath)
+    {
+        io::MappedFile file;
+        if (!file.open(filepath))
+        {
+            return false;
+        }
+
+        return loadSbcMem(filepath, file.data());
+    }
+
+    bool TextureAtlas::loadSbcMem(const string &filepath, const span<const ubyte> fileBuffer)
+    {
+        io::SbcReader reader;
+        if (!reader.open(fileBuffer, io::sbc::AtlasFormat, io::sbc::AtlasVersion))
+        {
+            return false;
+        }
+
+        span<const io::sbc::Page> pages;
+        span<const io::sbc::AtlasFrame> frameRecords;
+        if (!reader.records("PAGE", &pages) || !reader.records("FRMS", &frameRecords))
+        {
+            SDGL_ERROR("Failed to load SBC atlas: malformed tables");
+            return false;
+        }
+
+        try
+        {
+            vector<Texture2D> textures;
+            textures.reserve(pages.size());
+            vector<string> pageFiles;
+            pageFiles.reserve(pages.size());
+            map<string, Frame> frames;
+
+            const auto parentPath = std::filesystem::path(filepath).parent_path();
+            for (const auto &page : pages)
             {
-                for (auto &t : m_textures)
-                    t.unload();
+                auto curTexture = reusePage(textures.size());
+                auto pageFile = (parentPath / reader.getString(page.name)).string();
+                if (!curTexture.loadSbc(pageFile))
+                {
+                    discardPages(textures);
+                    return false;
+                }
+
+                textures.emplace_back(curTexture);
+                pageFiles.emplace_back(std::move(pageFile));
+            }
+
+            // records are sorted by name, so each insertion lands at the end
+            for (const auto &record : frameRecords)
+            {
+                if (record.page >= textures.size())
+                {
+                    SDGL_ERROR("Failed to load SBC atlas: frame refers to missing page {}", record.page);
+                    discardPages(textures);
+                    return false;
+                }
+
+                frames.emplace_hint(frames.end(), reader.getString(record.name), Frame {
+                    .frame = {record.x, record.y, record.width, record.height},
+                    .offset = {record.offsetX, record.offsetY},
+                    .size = {record.sourceWidth, record.sourceHeight},
+                    .rotated = record.rotated > 0,
+                    .texture = textures[record.page]
+                });
             }
 
-            m_textures.swap(textures);
-            m_frames.swap(frames);
+            // Done commit changes
+            clearPackedPages();
+            commitPages(textures, pageFiles);
+            replaceFrames(frames);
             return true;
         }
         catch(const std::exception &e)
         {
-            SDGL_ERROR("Failed to load crunch file: {}", e.what());
+            SDGL_ERROR("Failed to load SBC atlas: {}", e.what());
             return false;
         }
         catch(...)
         {
-            SDGL_ERROR("Failed to load crunch file: unknown error");
+            SDGL_ERROR("Failed to load SBC atlas: unknown error");
+            return false;
+        }
+    }
+
+    const Frame *TextureAtlas::insert(const string &name, const void *pixels, const int width, const int height)
+    {
+        SDGL_ASSERT(pixels, "Ensure image pixels are not null");
+
+        const auto packed = m_packedFrames.find(name);
+        if (packed == m_packedFrames.end() && m_frames.contains(name))
+        {
+            SDGL_ERROR("Failed to insert \"{}\" into TextureAtlas: a frame loaded from file has the name", name);
+            return nullptr;
+        }
+
+        size_t pageIndex;
+        Point position;
+        if (!packImage(width, height, &pageIndex, &position))
+        {
+            return nullptr;
+        }
+
+        auto &page = m_packedPages[pageIndex];
+        const Rectangle area(position.x + Padding, position.y + Padding, width, height);
+        copyImage(page, static_cast<const ubyte *>(pixels), width * 4, area);
+        ++page.frameCount;
+
+        // a replaced image's space stays claimed until compacted
+        if (packed != m_packedFrames.end())
+        {
+            --m_packedPages[packed->second].frameCount;
+            packed->second = pageIndex;
+            ++m_generation;
+        }
+        else
+        {
+            m_packedFrames.emplace(name, pageIndex);
+        }
+
+        auto &frame = m_frames[name];
+        frame = Frame {
+            .frame = {static_cast<int16>(area.x), static_cast<int16>(area.y),
+                static_cast<int16>(width), static_cast<int16>(height)},
+            .offset = {},
+            .size = {static_cast<int16>(width), static_cast<int16>(height)},
+            .rotated = false,
+            .texture = page.texture
+        };
+        return &frame;
+    }
+
+    const Frame *TextureAtlas::insertFile(const string &name, const string &filepath)
+    {
+        io::MappedFile file;
+        if (!file.open(filepath))
+        {
+            return nullptr;
+        }
+
+        int width, height, channels;
+        const auto pixels = stbi_load_from_memory(file.data().data(), static_cast<int>(file.size()),
+            &width, &height, &channels, STBI_rgb_alpha);
+        if (!pixels)
+        {
+            SDGL_ERROR("stb_image failed to load image \"{}\": {}", filepath, stbi_failure_reason());
+            return nullptr;
+        }
+
+        const auto frame = insert(name, pixels, width, height);
+        stbi_image_free(pixels);
+        return frame;
+    }
+
+    bool TextureAtlas::remove(const string &name)
+    {
+        const auto it = m_packedFrames.find(name);
+        if (it == m_packedFrames.end())
+        {
             return false;
         }
+
+        --m_packedPages[it->second].frameCount;
+        m_frames.erase(name);
+        m_packedFrames.erase(it);
+        ++m_generation;
+        return true;
+    }
+
+    void TextureAtlas::compact()
+    {
+        struct Image
+        {
+            Frame *frame;
+            size_t *page;
+        };
+
+        // tallest first packs a skyline tighter
+        vector<Image> images;
+        images.reserve(m_packedFrames.size());
+        for (auto &[name, page] : m_packedFrames)
+        {
+            images.push_back({&m_frames.at(name), &page});
+        }
+
+        std::sort(images.begin(), images.end(), [](const Image &a, const Image &b) {
+            return a.frame->frame.h > b.frame->frame.h ||
+                (a.frame->frame.h == b.frame->frame.h && a.frame->frame.w > b.frame->frame.w);
+        });
+
+        // images are copied out of the previous pixels, pages keep their textures
+        vector<vector<ubyte>> previous;
+        previous.reserve(m_packedPages.size());
+        for (auto &page : m_packedPages)
+        {
+            previous.emplace_back(std::move(page.pixels));
+            page.pixels.assign(previous.back().size(), 0);
+            page.packer.reset(page.packer.width(), page.packer.height());
+            page.frameCount = 0;
+            page.dirtyTop = 0;
+            page.dirtyBottom = page.packer.height();
+        }
+
+        for (const auto &image : images)
+        {
+            const auto source = image.frame->frame;
+            const auto sourceWidth = m_packedPages[*image.page].packer.width();
+            const auto sourcePixels = previous[*image.page].data() +
+                (static_cast<size_t>(source.y) * sourceWidth + source.x) * 4;
+
+            size_t pageIndex;
+            Point position;
+            if (!packImage(source.w, source.h, &pageIndex, &position))
+            {
+                // out of memory for a new page; drop the image rather than leave it pointing at overwritten pixels
+                SDGL_ERROR("Failed to repack an image while compacting TextureAtlas");
+                *image.page = std::numeric_limits<size_t>::max();
+                continue;
+            }
+
+            auto &page = m_packedPages[pageIndex];
+            const Rectangle area(position.x + Padding, position.y + Padding, source.w, source.h);
+            copyImage(page, sourcePixels, sourceWidth * 4, area);
+            ++page.frameCount;
+
+            image.frame->frame.x = static_cast<int16>(area.x);
+            image.frame->frame.y = static_cast<int16>(area.y);
+            image.frame->texture = page.texture;
+            *image.page = pageIndex;
+        }
+
+        for (auto it = m_packedFrames.begin(); it != m_packedFrames.end(); )
+        {
+            if (it->second == std::numeric_limits<size_t>::max())
+            {
+                m_frames.erase(it->first);
+                it = m_packedFrames.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        // Release empty pages, shifting the indices of the rest
+        vector<size_t> newIndices(m_packedPages.size());
+        size_t kept = 0;
+        for (size_t i = 0; i < m_packedPages.size(); ++i)
+        {
+            if (m_packedPages[i].frameCount == 0)
+            {
+                m_packedPages[i].texture.unload();
+                continue;
+            }
+
+            newIndices[i] = kept;
+            if (kept != i)
+            {
+                m_packedPages[kept] = std::move(m_packedPages[i]);
+            }
+            ++kept;
+        }
+
+        m_packedPages.resize(kept);
+        for (auto &[name, page] : m_packedFrames)
+        {
+            page = newIndices[page];
+        }
+
+        ++m_generation;
+        flush();
+
+        // every page was rewritten, so this is where their mip chains catch up
+        for (auto &page : m_packedPages)
+        {
+            page.texture.generateMipmaps();
+        }
+    }
+
+    bool TextureAtlas::flush()
+    {
+        bool result = true;
+        for (auto &page : m_packedPages)
+        {
+            if (page.dirtyTop >= page.dirtyBottom)
+            {
+                continue;
+            }
+
+            // whole rows are contiguous in the copy
+            const auto width = page.packer.width();
+            const Rectangle area(0, page.dirtyTop, width, page.dirtyBottom - page.dirtyTop);
+            result &= page.texture.updateBytes(page.pixels.data() + static_cast<size_t>(area.y) * width * 4,
+                static_cast<size_t>(area.w) * area.h * 4, area);
+
+            page.dirtyTop = page.packer.height();
+            page.dirtyBottom = 0;
+        }
+
+        return result;
+    }
+
+    void TextureAtlas::setPageSize(const int size)
+    {
+        m_pageSize = std::clamp<int>(size, 1, std::numeric_limits<int16>::max());
+    }
+
+    bool TextureAtlas::addPackedPage(const int width, const int height)
+    {
+        // a zeroed buffer, so padding is transparent
+        vector<ubyte> pixels(static_cast<size_t>(width) * height * 4);
+
+        Texture2D texture;
+        if (!texture.loadBytes(pixels.data(), pixels.size(), width, height, Texture2D::getDefaultFilter()))
+        {
+            return false;
+        }
+
+        m_packedPages.push_back({
+            .texture = texture,
+            .packer = SkylinePacker(width, height),
+            .pixels = std::move(pixels),
+            .dirtyTop = height,
+            .dirtyBottom = 0,
+            .frameCount = 0
+        });
+        return true;
+    }
+
+    bool TextureAtlas::packImage(const int width, const int height, size_t *outPage, Point *outPosition)
+    {
+        const auto paddedWidth = width + Padding * 2;
+        const auto paddedHeight = height + Padding * 2;
+        if (width <= 0 || height <= 0 ||
+            paddedWidth > std::numeric_limits<int16>::max() || paddedHeight > std::numeric_limits<int16>::max())
+        {
+            SDGL_ERROR("Failed to pack {}x{} image into TextureAtlas: invalid size", width, height);
+            return false;
+        }
+
+        for (size_t i = 0; i < m_packedPages.size(); ++i)
+        {
+            if (m_packedPages[i].packer.insert(paddedWidth, paddedHeight, outPosition))
+            {
+                *outPage = i;
+                return true;
+            }
+        }
+
+        if (!addPackedPage(std::max(m_pageSize, paddedWidth), std::max(m_pageSize, paddedHeight)))
+        {
+            return false;
+        }
+
+        *outPage = m_packedPages.size() - 1;
+        return m_packedPages.back().packer.insert(paddedWidth, paddedHeight, outPosition);
+    }
+
+    void TextureAtlas::copyImage(PackedPage &page, const ubyte *pixels, const int stride, const Rectangle &area)
+    {
+        const auto pageWidth = static_cast<size_t>(page.packer.width());
+        for (int row = 0; row < area.h; ++row)
+        {
+            std::memcpy(page.pixels.data() + ((area.y + row) * pageWidth + area.x) * 4,
+                pixels + static_cast<size_t>(row) * stride, static_cast<size_t>(area.w) * 4);
+        }
+
+        page.dirtyTop = std::min(page.dirtyTop, area.y);
+        page.dirtyBottom = std::max(page.dirtyBottom, area.y + area.h);
+    }
+
+    void TextureAtlas::replaceFrames(map<string, Frame> &frames)
+    {
+        for (auto it = m_frames.begin(); it != m_frames.end(); )
+        {
+            if (const auto frame = frames.find(it->first); frame != frames.end())
+            {
+                it->second = frame->second;
+                frames.erase(frame);
+                ++it;
+            }
+            else
+            {
+                it = m_frames.erase(it);
+            }
+        }
+
+        m_frames.merge(frames);
+        ++m_generation;
+    }
+
+    Texture2D TextureAtlas::reusePage(const size_t index) const
+    {
+        return index < m_textures.size() ? m_textures[index] : Texture2D();
+    }
+
+    void TextureAtlas::discardPages(vector<Texture2D> &pages) const
+    {
+        // pages reusing current ones were reloaded in place and stay in use
+        for (size_t i = m_textures.size(); i < pages.size(); ++i)
+            pages[i].unload();
+    }
+
+    void TextureAtlas::commitPages(vector<Texture2D> &pages, vector<string> &pageFiles)
+    {
+        for (size_t i = pages.size(); i < m_textures.size(); ++i)
+            m_textures[i].unload();
+        m_textures.swap(pages);
+        m_pageFiles.swap(pageFiles);
+    }
+
+    void TextureAtlas::clearPackedPages()
+    {
+        for (auto &page : m_packedPages)
+        {
+            page.texture.unload();
+        }
+
+        m_packedPages.clear();
+        m_packedFrames.clear();
     }
 
     void TextureAtlas::unload()
@@ -103,7 +536,10 @@ namespace sdgl {
             texture.unload();
         }
 
+        clearPackedPages();
         m_textures.clear();
+        m_pageFiles.clear();
         m_frames.clear();
+        ++m_generation;
     }
 }
@@ -3,9 +3,21 @@
 #include <sdgl/graphics/Frame.h>
 #include <sdgl/graphics/Texture2D.h>
 
+#include "SkylinePacker.h"
+
 namespace sdgl {
+    /// Frames of images packed into shared texture pages, so sprites drawn from it batch together. Pages are either
+    /// loaded from a prebuilt atlas file, or packed at runtime from loose images via `insert`. Loading a file again
+    /// replaces the atlas, updating frames that keep their name in place, so references to them stay valid.
     class TextureAtlas final : public Asset {
     public:
+        /// Width and height of pages created for inserted images, by default
+        static constexpr int DefaultPageSize = 1024;
+        /// Transparent pixels around each inserted image, so filtering doesn't bleed its neighbours in
+        static constexpr int Padding = 1;
+
+        TextureAtlas() : m_frames(), m_textures(), m_pageFiles(), m_packedPages(), m_packedFrames(),
+            m_pageSize(DefaultPageSize), m_generation() { }
         ~TextureAtlas() override;
 
         /// Load a crunch file (binary format)
@@ -17,6 +29,74 @@ namespace sdgl {
         /// @param filepath path to the original resource file e.g. "path/to/atlas.bin"
         /// @param fileBuffer in-memory data buffer containing file data
         bool loadCrunchMem(const string &filepath, const string &fileBuffer);
+        /// Load crunch data from a view of the file, e.g. a `io::MappedFile`, without copying it
+        /// @param filepath path to the original resource file e.g. "path/to/atlas.bin"
+        /// @param fileBuffer view of the file data
+        bool loadCrunchMem(const string &filepath, span<const ubyte> fileBuffer);
+
+        /// Load an SBC ATL file, whose pages are SBC IMG files next to it
+        /// @param filepath path to the .sbc atlas file
+        /// @returns whether this function succeeded
+        bool loadSbc(const string &filepath);
+
+        /// Load SBC ATL data already in memory. Filepath is required for relative paths to load page files.
+        /// @param filepath   path to the original resource file e.g. "path/to/atlas.sbc"
+        /// @param fileBuffer file contents, must be 4-byte aligned
+        bool loadSbcMem(const string &filepath, span<const ubyte> fileBuffer);
+
+        /// Pack an image into a page shared with other inserted images, creating a page if none has room. Pixels are
+        /// kept in memory to upload and repack them; changed pages are uploaded by `flush`.
+        /// @param name   frame name; a frame inserted under the same name is replaced in place
+        /// @param pixels RGBA8888 pixels, rows tightly packed
+        /// @param width  pixel width of the image
+        /// @param height pixel height of the image; images larger than the page size get a page of their own
+        /// @returns the frame, valid until it's removed or the atlas is unloaded or loaded again, or null on failure
+        const Frame *insert(const string &name, const void *pixels, int width, int height);
+
+        /// Decode an image file (.png, .jpg, .tga, .bmp, ...) and insert it. To share pages with a BMFont, insert its
+        /// page images named by their paths without extension, then load it via
+        /// `BitmapFont::loadBMFont(filepath, atlas, textureRoot)`.
+        /// @param name     frame name
+        /// @param filepath path to the image file
+        /// @returns the frame, or null on failure
+        const Frame *insertFile(const string &name, const string &filepath);
+
+        /// Remove an inserted frame. Its space is reclaimed on `compact`.
+        /// @returns whether an inserted frame had the name
+        bool remove(const string &name);
+
+        /// Repack inserted images from scratch, reclaiming space of removed and replaced ones and releasing pages
+        /// left empty, then upload the pages and regenerate their mip chains. References to frames stay valid, but
+        /// their rects and textures change, so copies of frames go stale.
+        void compact();
+
+        /// Upload rows of pages changed by insertions since the last flush. Call it after a batch of insertions,
+        /// before drawing their frames. Mip chains of the pages are left as they are until `compact`, as page
+        /// filters only sample the full-size level.
+        /// @returns whether every upload succeeded
+        bool flush();
+
+        /// Set the width and height of pages created for inserted images from now on
+        void setPageSize(int size);
+
+        [[nodiscard]]
+        int pageSize() const { return m_pageSize; }
+
+        /// Number of textures, loaded or packed at runtime
+        [[nodiscard]]
+        size_t pageCount() const { return m_textures.size() + m_packedPages.size(); }
+
+        /// Paths of the page files the atlas was last loaded from, as passed to load them
+        [[nodiscard]]
+        const vector<string> &pageFiles() const { return m_pageFiles; }
+
+        /// Incremented whenever frames move or go away: on loads, unloads, removals, replacing insertions and
+        /// compaction. Copies of frames taken before it changed may be stale.
+        [[nodiscard]]
+        uint generation() const { return m_generation; }
+
+        [[nodiscard]]
+        bool contains(const string &frameName) const { return m_frames.contains(frameName); }
 
         /// Get a frame from the atlas
         /// @returns frame for the index
@@ -39,8 +119,45 @@ namespace sdgl {
         void unload() override;
 
     private:
+        /// Page of images inserted at runtime, whose pixels are kept to upload changes and repack
+        struct PackedPage
+        {
+            Texture2D texture;
+            SkylinePacker packer;
+            vector<ubyte> pixels;       ///< RGBA8888 copy of the texture
+            int dirtyTop;               ///< first row changed since the last upload
+            int dirtyBottom;            ///< one past the last row changed since the last upload
+            uint frameCount;            ///< inserted frames on the page
+        };
+
+        /// Create an empty page for inserted images
+        bool addPackedPage(int width, int height);
+        /// Claim room on a page for an image with padding, creating a page if needed
+        /// @returns whether room was found
+        bool packImage(int width, int height, size_t *outPage, Point *outPosition);
+        /// Copy an image into a page, marking its rows for upload
+        static void copyImage(PackedPage &page, const ubyte *pixels, int stride, const Rectangle &area);
+        /// Replace the frames, updating those with the same name in place, so references to them stay valid when the
+        /// atlas is loaded again; consumes `frames`
+        void replaceFrames(map<string, Frame> &frames);
+        /// Texture to load page `index` into: the current page there, which loads in place keeping its id, so copies
+        /// of frames stay valid across loads, or an empty texture past the current pages
+        [[nodiscard]]
+        Texture2D reusePage(size_t index) const;
+        /// Unload pages of a failed load that don't reuse current pages
+        void discardPages(vector<Texture2D> &pages) const;
+        /// Unload current pages that `pages` didn't reuse, then take `pages` and the files they were loaded from
+        void commitPages(vector<Texture2D> &pages, vector<string> &pageFiles);
+        /// Unload runtime pages and forget which frames were inserted
+        void clearPackedPages();
+
         map<string, Frame> m_frames;
-        vector<Texture2D> m_textures;
+        vector<Texture2D> m_textures;               ///< pages loaded from file
+        vector<string> m_pageFiles;                 ///< file of each loaded page
+        vector<PackedPage> m_packedPages;
+        map<string, size_t> m_packedFrames;         ///< page index of each inserted frame
+        int m_pageSize;                             ///< of new packed pages
+        uint m_generation;
     };
 }
 
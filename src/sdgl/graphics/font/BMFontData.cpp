@@ -4,6 +4,7 @@
 #include <sdgl/logging.h>
 #include <sdgl/io/io.h>
 #include <sdgl/io/BufferView.h>
+#include <sdgl/io/MappedFile.h>
 
 /// Helper to read a field from a BufferView for BMFont read functions. Invokes a `return
 /// false` on error, so it should be called in a function with a bool return type.
@@ -17,13 +18,14 @@ namespace sdgl {
     {
         SDGL_ASSERT(data);
 
-        string buffer;
-        if (!io::readFile(filepath, &buffer))
+        // parse the mapped file in place
+        io::MappedFile file;
+        if (!file.open(filepath))
         {
             return false;
         }
 
-        return fromBuffer(buffer, data);
+        return fromBuffer(file.data(), data);
     }
 
     enum class BMFontType
@@ -35,7 +37,7 @@ namespace sdgl {
     };
 
     /// Check id bytes for BMFontType
-    static BMFontType getBMFontType(const string &buffer)
+    static BMFontType getBMFontType(const span<const ubyte> buffer)
     {
         if (buffer.size() < 6)
         {
@@ -79,7 +81,7 @@ namespace sdgl {
         return BMFontType::None;
     }
 
-    static bool parseBinaryV3(const string &buffer, BMFontData *outData)
+    static bool parseBinaryV3(const span<const ubyte> buffer, BMFontData *outData)
     {
         auto view = io::BufferView(buffer);
         view.move(4); // move past file identifier
@@ -269,6 +271,11 @@ namespace sdgl {
     }
 
     bool BMFontData::fromBuffer(const string &buffer, BMFontData *outData)
+    {
+        return fromBuffer(span(reinterpret_cast<const ubyte *>(buffer.data()), buffer.size()), outData);
+    }
+
+    bool BMFontData::fromBuffer(const span<const ubyte> buffer, BMFontData *outData)
     {
         SDGL_ASSERT(outData);
 
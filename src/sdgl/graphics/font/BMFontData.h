@@ -93,5 +93,11 @@ namespace sdgl {
         /// @param outData structure to receive the data
         /// @return whether operation succeeded
         static bool fromBuffer(const string &buffer, BMFontData *outData);
+
+        /// Read bmfont data from a view of the file, e.g. a `io::MappedFile`, without copying it
+        /// @param buffer view of the bmfont binary data
+        /// @param outData structure to receive the data
+        /// @return whether operation succeeded
+        static bool fromBuffer(span<const ubyte> buffer, BMFontData *outData);
     };
 }
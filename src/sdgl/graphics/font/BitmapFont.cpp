@@ -1,10 +1,13 @@
 #include "BitmapFont.h"
 
+#include <algorithm>
 #include <filesystem>
 
 #include "BMFontData.h"
 #include "Glyph.h"
 #include <sdgl/logging.h>
+#include <sdgl/io/MappedFile.h>
+#include <sdgl/io/SbcReader.h>
 
 namespace sdgl {
     struct BitmapFont::Char
@@ -26,6 +29,30 @@ namespace sdgl {
         map<uint, Char> chars;
         map<std::pair<uint, uint>, int> kernings;
         bool ownsFrames = false;
+        uint generation = 0;        ///< bumped on each load and unload, and when atlas pages change
+        vector<string> pageFiles;   ///< file of each page, if loaded from files
+
+        const TextureAtlas *atlas = nullptr; ///< atlas the pages were taken from, if any
+        vector<string> pageFrames;  ///< atlas frame name of each page
+        uint atlasGeneration = 0;   ///< of the atlas when the pages were copied
+
+        /// Copy pages from the atlas again if its frames changed since, e.g. it was reloaded or compacted
+        void syncAtlasPages()
+        {
+            if (!atlas || atlas->generation() == atlasGeneration)
+                return;
+
+            for (size_t i = 0; i < pages.size(); ++i)
+            {
+                if (atlas->contains(pageFrames[i]))
+                    pages[i] = atlas->at(pageFrames[i]);
+                else
+                    SDGL_WARN("Font page \"{}\" is missing from its atlas, keeping the previous frame", pageFrames[i]);
+            }
+
+            atlasGeneration = atlas->generation();
+            ++generation;
+        }
 
         void unload()
         {
@@ -41,10 +68,14 @@ namespace sdgl {
 
             chars.clear();
             pages.clear();
+            pageFiles.clear();
+            pageFrames.clear();
+            atlas = nullptr;
             kernings.clear();
             fontName.clear();
             fontSize = 0;
             base = 0;
+            ++generation;
         }
     };
 
@@ -102,6 +133,39 @@ namespace sdgl {
         return parseBMFontData(data, parentFolder, nullptr);
     }
 
+    bool BitmapFont::loadSbc(const string &filepath, const TextureAtlas &textureAtlas, string_view textureRoot)
+    {
+        io::MappedFile file;
+        if (!file.open(filepath))
+        {
+            return false;
+        }
+
+        return loadSbcMem(file.data(), textureAtlas, textureRoot);
+    }
+
+    bool BitmapFont::loadSbc(const string &filepath)
+    {
+        io::MappedFile file;
+        if (!file.open(filepath))
+        {
+            return false;
+        }
+
+        return loadSbcMem(file.data(), std::filesystem::path(filepath).parent_path().string());
+    }
+
+    bool BitmapFont::loadSbcMem(const span<const ubyte> fileBuffer, const TextureAtlas &textureAtlas,
+        string_view textureRoot)
+    {
+        return loadSbcFont(fileBuffer, textureRoot, &textureAtlas);
+    }
+
+    bool BitmapFont::loadSbcMem(const span<const ubyte> fileBuffer, const string &parentFolder)
+    {
+        return loadSbcFont(fileBuffer, parentFolder, nullptr);
+    }
+
     void BitmapFont::unload()
     {
         m->unload();
@@ -117,6 +181,17 @@ namespace sdgl {
         return m->fontName;
     }
 
+    uint BitmapFont::generation() const
+    {
+        m->syncAtlasPages();
+        return m->generation;
+    }
+
+    const vector<string> &BitmapFont::pageFiles() const
+    {
+        return m->pageFiles;
+    }
+
     Point BitmapFont::projectText(vector<Glyph> *glyphs, const string &text, const uint maxWidth, const int horSpaceOffset,
                                  const int lineHeightOffset, const bool withKerning) const
     {
@@ -127,6 +202,7 @@ namespace sdgl {
         }
 
         glyphs->clear();
+        m->syncAtlasPages();
         if (text.empty() || !isLoaded())
         {
             return {};
@@ -285,30 +361,106 @@ namespace sdgl {
     }
 
     bool BitmapFont::parseBMFontData(const BMFontData &data, string_view textureRoot, const TextureAtlas *atlas)
+    {
+        vector<string_view> pageNames;
+        pageNames.reserve(data.pages.size());
+        for (const auto &page : data.pages)
+        {
+            pageNames.emplace_back(page.file);
+        }
+
+        const auto metrics = Metrics {
+            .fontName = data.info.fontName,
+            .fontSize = static_cast<uint16>(data.info.fontSize),
+            .base = data.common.base,
+            .lineHeight = data.common.lineHeight,
+        };
+
+        return loadFont(metrics, span<const string_view>(pageNames), span<const BMFontData::Char>(data.chars),
+            span<const BMFontData::KerningPair>(data.kernings), textureRoot, atlas);
+    }
+
+    bool BitmapFont::loadSbcFont(const span<const ubyte> fileBuffer, string_view textureRoot,
+        const TextureAtlas *atlas)
+    {
+        io::SbcReader reader;
+        if (!reader.open(fileBuffer, io::sbc::FontFormat, io::sbc::FontVersion))
+        {
+            return false;
+        }
+
+        const auto info = reader.record<io::sbc::FontInfo>("INFO");
+        span<const io::sbc::Page> pages;
+        span<const io::sbc::FontChar> chars;
+        span<const io::sbc::FontKerning> kernings;
+        if (!info || !reader.records("PAGE", &pages) || !reader.records("CHRS", &chars) ||
+            !reader.records("KERN", &kernings))
+        {
+            SDGL_ERROR("Failed to load SBC font: malformed chunks");
+            return false;
+        }
+
+        // names are viewed in the string table, and chars and kernings read from their records in place
+        vector<string_view> pageNames;
+        pageNames.reserve(pages.size());
+        for (const auto &page : pages)
+        {
+            pageNames.emplace_back(reader.getString(page.name));
+        }
+
+        const auto metrics = Metrics {
+            .fontName = reader.getString(info->name),
+            .fontSize = static_cast<uint16>(info->fontSize),
+            .base = info->base,
+            .lineHeight = info->lineHeight,
+        };
+
+        return loadFont(metrics, span<const string_view>(pageNames), chars, kernings, textureRoot, atlas);
+    }
+
+    template <typename CharRecord, typename KerningRecord>
+    bool BitmapFont::loadFont(const Metrics &metrics, const span<const string_view> pageNames,
+        const span<const CharRecord> chars, const span<const KerningRecord> kernings, string_view textureRoot,
+        const TextureAtlas *atlas)
     {
         auto parentFolder = std::filesystem::path(textureRoot);
 
         vector<Frame> textureFrames;
-        textureFrames.reserve(data.pages.size());
+        textureFrames.reserve(pageNames.size());
+        vector<string> pageFiles, pageFrames;
+
+        // page textures of a previous load from files are loaded into in place, keeping their ids
+        const auto reusedPages = (!atlas && m->ownsFrames) ? m->pages.size() : 0;
+        const auto discardPages = [&textureFrames, reusedPages]() {
+            for (size_t i = reusedPages; i < textureFrames.size(); ++i)
+                textureFrames[i].texture.unload();
+        };
 
         // Get page textures
         if (atlas) // from atlas, if provided
         {
-            for (const auto &[id, file] : data.pages)
+            for (const auto &file : pageNames)
             {
-                textureFrames.emplace_back(atlas->at( (parentFolder / file).replace_extension() ));
+                auto frameName = (parentFolder / file).replace_extension().string();
+                textureFrames.emplace_back(atlas->at(frameName));
+                pageFrames.emplace_back(std::move(frameName));
             }
         }
         else      // from direct files, if atlas not provided
         {
-            for (const auto &[id, file] : data.pages)
+            for (const auto &file : pageNames)
             {
-                Texture2D texture;
-                if (!texture.loadFile(parentFolder / file))
+                // pages converted to SBC IMG are uploaded in place
+                const auto filepath = parentFolder / file;
+                auto texture = textureFrames.size() < reusedPages ? m->pages[textureFrames.size()].texture :
+                    Texture2D();
+                if (!(filepath.extension() == ".sbc" ? texture.loadSbc(filepath) : texture.loadFile(filepath)))
                 {
+                    discardPages();
                     return false;
                 }
 
+                pageFiles.emplace_back(filepath.string());
                 const auto textureSize = static_cast<Vec2<int16>>(texture.size());
                 textureFrames.emplace_back(Frame{
                     Rect<int16>{0, 0, textureSize.x , textureSize.y},
@@ -320,36 +472,62 @@ namespace sdgl {
             }
         }
 
+        for (const auto &c : chars)
+        {
+            if (c.page >= textureFrames.size())
+            {
+                SDGL_ERROR("Failed to load font: char {} refers to missing page {}", c.id, c.page);
+                discardPages();
+                return false;
+            }
+        }
 
-        // Parse chars
-        map<uint, Char> chars;
-        for (const auto &c : data.chars)
+        // Release owned page textures that weren't reloaded in place
+        if (m->ownsFrames)
+        {
+            for (auto i = reusedPages ? textureFrames.size() : 0; i < m->pages.size(); ++i)
+            {
+                m->pages[i].texture.unload();
+            }
+        }
+
+        // Pages are assigned in place, so references to them stay valid while the page count is unchanged
+        m->pages.resize(textureFrames.size());
+        std::copy(textureFrames.begin(), textureFrames.end(), m->pages.begin());
+
+        // Build chars; sorted records, as SBC files store them, each land at the end. Duplicates keep the first.
+        map<uint, Char> charMap;
+        for (const auto &c : chars)
         {
-            chars.try_emplace(c.id,
+            charMap.emplace_hint(charMap.end(), c.id,
                 Char {
                     Rect<uint16>{c.x, c.y, c.width, c.height},
                     Vec2<int16>(c.xoffset, c.yoffset),
                     c.xadvance,
-                    textureFrames[c.page]
+                    m->pages[c.page]
                 }
             );
         }
 
-        // Parse kernings
-        map<std::pair<uint, uint>, int> kernings;
-        for (const auto &k : data.kernings)
+        // Build kernings
+        map<std::pair<uint, uint>, int> kerningMap;
+        for (const auto &k : kernings)
         {
-            kernings.try_emplace(std::make_pair(k.first, k.second), k.amount);
+            kerningMap.emplace_hint(kerningMap.end(), std::make_pair(k.first, k.second), k.amount);
         }
 
-        m->pages.swap(textureFrames);
-        m->chars.swap(chars);
-        m->kernings.swap(kernings);
-        m->fontName = data.info.fontName;
-        m->fontSize = data.info.fontSize;
-        m->base = data.common.base;
-        m->lineHeight = data.common.lineHeight;
+        m->chars.swap(charMap);
+        m->kernings.swap(kerningMap);
+        m->fontName = metrics.fontName;
+        m->fontSize = metrics.fontSize;
+        m->base = metrics.base;
+        m->lineHeight = metrics.lineHeight;
         m->ownsFrames = !static_cast<bool>(atlas); // if we loaded from atlas, defer texture ownership, otherwise we will manage them
+        m->pageFiles.swap(pageFiles);
+        m->pageFrames.swap(pageFrames);
+        m->atlas = atlas;
+        m->atlasGeneration = atlas ? atlas->generation() : 0;
+        ++m->generation;
 
         return true;
     }
@@ -15,7 +15,8 @@ namespace sdgl {
         ~BitmapFont() override;
 
         /// Load BMFont file, retriving its image textures from an atlas.
-        /// Loading from an atlas enables efficient graphics card rendering with fewer textures.
+        /// Loading from an atlas enables efficient graphics card rendering with fewer textures. The atlas must outlive
+        /// the font, which follows its page frames when the atlas is loaded again or its frames move.
         /// @param filepath      filepath to the bmfont binary file
         /// @param textureAtlas  atlas where the textures for this font have been loaded
         /// @param textureRoot   parent path of where the textures in the atlas are located
@@ -40,6 +41,30 @@ namespace sdgl {
         /// @return whether load succeeded
         bool loadBMFontMem(const string &fileBuffer, const string &parentFolder);
 
+        /// Load SBC FNT file, retrieving its image textures from an atlas
+        /// @param filepath      filepath to the .sbc font file
+        /// @param textureAtlas  atlas where the textures for this font have been loaded
+        /// @param textureRoot   parent path of where the textures in the atlas are located
+        /// @return whether load succeeded
+        bool loadSbc(const string &filepath, const TextureAtlas &textureAtlas, string_view textureRoot);
+        /// Load SBC FNT file, retrieving its SBC IMG textures from files in the same directory
+        /// @param filepath path to the .sbc font file
+        /// @return whether load succeeded
+        bool loadSbc(const string &filepath);
+
+        /// Load from SBC FNT data already in memory - textures are received from a texture atlas
+        /// @param fileBuffer   file contents, must be 4-byte aligned
+        /// @param textureAtlas texture atlas to load textures from
+        /// @param textureRoot  parent path within the atlas where the texture keys are located
+        /// @return whether load succeeded
+        bool loadSbcMem(span<const ubyte> fileBuffer, const TextureAtlas &textureAtlas, string_view textureRoot);
+
+        /// Load from SBC FNT data already in memory
+        /// @param fileBuffer   file contents, must be 4-byte aligned
+        /// @param parentFolder parent folder where texture files exist
+        /// @return whether load succeeded
+        bool loadSbcMem(span<const ubyte> fileBuffer, const string &parentFolder);
+
         void unload() override;
 
         [[nodiscard]]
@@ -48,6 +73,15 @@ namespace sdgl {
         [[nodiscard]]
         const string &fontName() const;
 
+        /// Incremented each time the font loads or unloads, or its atlas pages change; glyphs projected before it
+        /// changed are stale
+        [[nodiscard]]
+        uint generation() const;
+
+        /// Paths of the page image files the font was last loaded from; empty if its pages came from an atlas
+        [[nodiscard]]
+        const vector<string> &pageFiles() const;
+
         /// Get projection rectangles for each character in a text string
         /// @param glyphs [out]  vector to receive glyph projection data; each position is relative to {0, 0}
         /// @param text         text string to project
@@ -64,6 +98,14 @@ namespace sdgl {
         Point projectText(vector<Glyph> *glyphs, const string &text, uint maxWidth = 0, int horSpaceOffset = 0,
             int lineHeightOffset = 0, bool withKerning = true) const;
     private:
+        /// Font-wide values, from the info and common blocks of a BMFont file or the "INFO" record of an SBC FNT file
+        struct Metrics
+        {
+            string_view fontName;
+            uint16 fontSize;
+            uint16 base;
+            uint16 lineHeight;
+        };
 
         /// Parse bmfont where font textures are retrieved from a texture atlas
         /// @param data successfully loaded bmfont data object
@@ -71,6 +113,18 @@ namespace sdgl {
         ///                    it indicates the parent path of where the texture keys are located
         /// @param atlas texture atlas to get textures from
         bool parseBMFontData(const BMFontData &data, string_view textureRoot, const TextureAtlas *atlas);
+
+        /// Load an SBC FNT file, building chars and kernings straight from its record tables
+        bool loadSbcFont(span<const ubyte> fileBuffer, string_view textureRoot, const TextureAtlas *atlas);
+
+        /// Load page textures, then build chars and kernings from the records of either file format
+        /// @param pageNames texture file of each page, relative to `textureRoot`
+        /// @param chars     char records, ideally sorted by id
+        /// @param kernings  kerning records, ideally sorted by first, then second char
+        template <typename CharRecord, typename KerningRecord>
+        bool loadFont(const Metrics &metrics, span<const string_view> pageNames, span<const CharRecord> chars,
+            span<const KerningRecord> kernings, string_view textureRoot, const TextureAtlas *atlas);
+
         struct Impl;
         struct Char;
         Impl *m;
@@ -1,22 +1,31 @@
 #include "FontText.h"
 
+#include <sdgl/math/geometry.h>
+#include <sdgl/math/mathf.h>
+
+#include <algorithm>
+#include <limits>
 
 namespace sdgl {
-    FontText::FontText() : m_glyphs(), m_font(nullptr), m_text(), m_maxWidth(0), m_textProgress(0), m_useKerning(true),
-                          m_horSpaceOffset(0), m_lineHeightOffset(0), m_shouldUpdateSize(false)
+    FontText::FontText() : m_glyphs(), m_font(nullptr), m_fontGeneration(), m_text(), m_maxWidth(0), m_textProgress(0),
+                          m_useKerning(true), m_horSpaceOffset(0), m_lineHeightOffset(0), m_shouldUpdateSize(false),
+                          m_quads(), m_quadBounds(), m_shouldUpdateQuads(false)
     {}
 
-    FontText::FontText(const Config &config, const string_view text) : m_glyphs(), m_font(config.font), m_text(text),
+    FontText::FontText(const Config &config, const string_view text) : m_glyphs(), m_font(config.font),
+        m_fontGeneration(), m_text(text),
         m_maxWidth(config.maxWidth), m_textProgress((uint)text.length()), m_useKerning(config.useKerning),
-        m_horSpaceOffset(config.horizSpaceOffset), m_lineHeightOffset(config.lineHeightOffset), m_shouldUpdateSize(false)
+        m_horSpaceOffset(config.horizSpaceOffset), m_lineHeightOffset(config.lineHeightOffset), m_shouldUpdateSize(false),
+        m_quads(), m_quadBounds(), m_shouldUpdateQuads(false)
     {
         updateGlyphs();
     }
 
     FontText::FontText(BitmapFont *font, const string_view text, const uint maxWidth, const bool useKerning,
                        const int horSpaceOffset, const int lineHeightOffset) :
-        m_glyphs(), m_font(font), m_text(text), m_maxWidth(maxWidth), m_textProgress(static_cast<uint>(text.length())),
-        m_useKerning(useKerning), m_horSpaceOffset(horSpaceOffset), m_lineHeightOffset(lineHeightOffset)
+        m_glyphs(), m_font(font), m_fontGeneration(), m_text(text), m_maxWidth(maxWidth), m_textProgress(static_cast<uint>(text.length())),
+        m_useKerning(useKerning), m_horSpaceOffset(horSpaceOffset), m_lineHeightOffset(lineHeightOffset),
+        m_shouldUpdateSize(false), m_quads(), m_quadBounds(), m_shouldUpdateQuads(false)
     {
         updateGlyphs();
     }
@@ -95,6 +104,7 @@ namespace sdgl {
 
     Point FontText::currentSize() const
     {
+        checkFont();
         if (m_shouldUpdateSize)
         {
             updateCurrentSize();
@@ -103,12 +113,13 @@ namespace sdgl {
         return m_curSize;
     }
 
-    void FontText::updateGlyphs()
+    void FontText::updateGlyphs() const
     {
         if (m_font)
         {
             m_font->projectText(&m_glyphs, m_text, m_maxWidth, m_horSpaceOffset, m_lineHeightOffset,
                                 m_useKerning);
+            m_fontGeneration = m_font->generation();
         }
         else
         {
@@ -116,6 +127,95 @@ namespace sdgl {
         }
 
         m_shouldUpdateSize = true;
+        m_shouldUpdateQuads = true;
+    }
+
+    const vector<FontText::GlyphQuad> &FontText::quads() const
+    {
+        checkFont();
+        if (m_shouldUpdateQuads)
+        {
+            updateQuads();
+            m_shouldUpdateQuads = false;
+        }
+        return m_quads;
+    }
+
+    const FRectangle &FontText::quadBounds() const
+    {
+        checkFont();
+        if (m_shouldUpdateQuads)
+        {
+            updateQuads();
+            m_shouldUpdateQuads = false;
+        }
+        return m_quadBounds;
+    }
+
+    void FontText::updateQuads() const
+    {
+        m_quads.clear();
+        m_quads.reserve(m_glyphs.size());
+
+        auto left = std::numeric_limits<float>::max(), top = std::numeric_limits<float>::max();
+        auto right = std::numeric_limits<float>::lowest(), bottom = std::numeric_limits<float>::lowest();
+        for (const auto &glyph : m_glyphs)
+        {
+            const auto &texFrame = glyph.frame;
+
+            // transpose glyph source within font to position in the wider atlas
+            Rectangle source;
+            Vector2 anchor;
+            float angle = 0;
+            if (texFrame.rotated)
+            {
+                source = {
+                    static_cast<int16>((int16)texFrame.frame.w + texFrame.offset.y  + texFrame.frame.x - glyph.source.y - glyph.source.h),
+                    static_cast<int16>(glyph.source.x + texFrame.frame.y + texFrame.offset.x),
+                    glyph.source.h,
+                    glyph.source.w
+                };
+                anchor = Vector2{(float)glyph.source.h - (float)texFrame.offset.y, (float)texFrame.offset.x};
+                angle = -mathf::HalfPi;
+            }
+            else
+            {
+                source = {
+                    static_cast<int16>(glyph.source.x + texFrame.frame.x),
+                    static_cast<int16>(glyph.source.y + texFrame.frame.y),
+                    glyph.source.w,
+                    glyph.source.h
+                };
+                anchor = Vector2{(float)texFrame.offset.x, (float)texFrame.offset.y};
+            }
+
+            // same corner math as `SpriteBatchBase2D::drawTexture` at a scale of 1
+            const auto texCoords = static_cast<FRectangle>(source);
+            const auto destination = Vector2{(float)glyph.destination.x, (float)glyph.destination.y};
+
+            GlyphQuad quad;
+            quad.texture = texFrame.texture;
+            quad.corners[0] = destination + mathf::rotate(-anchor, angle);
+            quad.corners[1] = destination + mathf::rotate(Vector2(-anchor.x, texCoords.h - anchor.y), angle);
+            quad.corners[2] = destination + mathf::rotate(Vector2(texCoords.w - anchor.x, -anchor.y), angle);
+            quad.corners[3] = destination + mathf::rotate(Vector2(texCoords.w - anchor.x, texCoords.h - anchor.y), angle);
+            quad.texcoords[0] = texCoords.topleft();
+            quad.texcoords[1] = texCoords.bottomleft();
+            quad.texcoords[2] = texCoords.topright();
+            quad.texcoords[3] = texCoords.bottomright();
+
+            for (const auto &corner : quad.corners)
+            {
+                left = std::min(left, corner.x);
+                top = std::min(top, corner.y);
+                right = std::max(right, corner.x);
+                bottom = std::max(bottom, corner.y);
+            }
+
+            m_quads.emplace_back(quad);
+        }
+
+        m_quadBounds = m_quads.empty() ? FRectangle{} : FRectangle{left, top, right - left, bottom - top};
     }
 
     void FontText::updateCurrentSize() const
@@ -2,6 +2,8 @@
 #include "BitmapFont.h"
 #include "Glyph.h"
 
+#include <sdgl/math/Vector2.h>
+
 namespace sdgl {
 
     /// Stores a piece of text to be rendered and caches a list of glyphs according to the set parameters
@@ -17,6 +19,14 @@ namespace sdgl {
             int lineHeightOffset = 0;
         };
 
+        /// Glyph quad ready to be copied into a sprite batch, with atlas rotation and trim offsets applied
+        struct GlyphQuad
+        {
+            Texture2D texture;
+            Vector2 corners[4];   ///< top-left, bottom-left, top-right, bottom-right; relative to the text's position
+            Vector2 texcoords[4]; ///< in pixels, same corner order
+        };
+
         FontText();
         explicit FontText(const Config &config, string_view text = "");
         explicit FontText(BitmapFont *font, string_view text = "", uint maxWidth = 0,
@@ -55,9 +65,17 @@ namespace sdgl {
         FontText &lineHeightOffset(int value);
 
         /// Get the current glyphs to be rendered, gets updated automatically when a font is available
-        /// and text is not empty.
+        /// and text is not empty, and when the font is reloaded.
+        [[nodiscard]]
+        const vector<Glyph> &glyphs() const { checkFont(); return m_glyphs; }
+
+        /// Get a quad for each of `glyphs()`; built on first access after the text, font or layout changes
         [[nodiscard]]
-        const vector<Glyph> &glyphs() const { return m_glyphs; }
+        const vector<GlyphQuad> &quads() const;
+
+        /// Get the bounds of all `quads()`, relative to the text's position
+        [[nodiscard]]
+        const FRectangle &quadBounds() const;
 
         /// Set the number of chars to show when SpriteBatch or some other system renders this object.
         /// This is useful for dialog that is revealed gradually.
@@ -77,11 +95,20 @@ namespace sdgl {
         Point currentSize() const;
 
     private:
-        void updateGlyphs();
+        /// Project the glyphs again if the font was reloaded since, as they refer to its previous pages
+        void checkFont() const
+        {
+            if (m_font && m_font->generation() != m_fontGeneration)
+                updateGlyphs();
+        }
+
+        void updateGlyphs() const;
         void updateCurrentSize() const;
+        void updateQuads() const;
 
-        vector<Glyph> m_glyphs;
+        mutable vector<Glyph> m_glyphs;
         BitmapFont *m_font;
+        mutable uint m_fontGeneration; ///< of the font when the glyphs were projected
         string m_text;
         uint m_maxWidth;
         uint m_textProgress;
@@ -91,6 +118,10 @@ namespace sdgl {
 
         mutable Point m_curSize;
         mutable bool m_shouldUpdateSize; // dirty-flag pattern
+
+        mutable vector<GlyphQuad> m_quads;
+        mutable FRectangle m_quadBounds;
+        mutable bool m_shouldUpdateQuads;
     };
 
 } // sdgl::graphics
@@ -1,23 +1,111 @@
 #pragma once
+#include <sdgl/sdglib.h>
 
 namespace sdgl::detail {
+    // Shaders are templates for `spriteBatch2dShader`, which fills in TEXTURE_SLOTS and SAMPLE_TEXTURE_SLOTS
 
     static const auto spriteBatch2dVertShader =
 R"glsl(#version 300 es
 layout (location = 0) in vec2 Position;
 layout (location = 1) in vec2 TexCoord;
 layout (location = 2) in vec4 Color;
+#if TEXTURE_SLOTS > 1
+layout (location = 3) in float TexSlot;
+#else
+const float TexSlot = 0.0; // single slot layouts don't upload it
+#endif
 
 out vec2 frag_TextureUV;
 out vec4 frag_Color;
+flat out int frag_TexSlot;
 
 uniform mat4 u_ProjMtx;
-uniform vec2 u_TexSize;
+uniform vec2 u_TexSize[TEXTURE_SLOTS];
 
 void main()
 {
     gl_Position = u_ProjMtx * vec4(Position.x, Position.y, 0, 1.0);
-    frag_TextureUV = TexCoord / u_TexSize;
+    frag_TexSlot = int(TexSlot);
+    frag_TextureUV = TexCoord / u_TexSize[frag_TexSlot];
+    frag_Color = Color;
+})glsl";
+
+    /// Reads `SpriteBatchBase2D::PackedVertex`: fixed point positions and texture coordinates in whole pixels
+    static const auto spriteBatch2dPackedVertShader =
+R"glsl(#version 300 es
+layout (location = 0) in vec2 Position;
+layout (location = 1) in vec2 TexCoord;
+layout (location = 2) in vec4 Color;
+#if TEXTURE_SLOTS > 1
+layout (location = 3) in float TexSlot;
+#else
+const float TexSlot = 0.0; // single slot layouts don't upload it
+#endif
+
+out vec2 frag_TextureUV;
+out vec4 frag_Color;
+flat out int frag_TexSlot;
+
+uniform mat4 u_ProjMtx;
+uniform vec2 u_TexSize[TEXTURE_SLOTS];
+
+const float PositionScale = 4.0; // SpriteBatchBase2D::PackedPositionScale
+
+void main()
+{
+    vec2 position = Position / PositionScale;
+    gl_Position = u_ProjMtx * vec4(position.x, position.y, 0, 1.0);
+    frag_TexSlot = int(TexSlot);
+    frag_TextureUV = TexCoord / u_TexSize[frag_TexSlot];
+    frag_Color = Color;
+})glsl";
+
+    /// Expands one sprite instance per 4 vertices, drawn as a triangle strip: top-left, bottom-left, top-right,
+    /// bottom-right. Mirrors the corner math in `SpriteBatchBase2D::drawTexture`.
+    static const auto spriteBatch2dInstancedVertShader =
+R"glsl(#version 300 es
+layout (location = 0) in vec2 Position;
+layout (location = 1) in vec2 Scale;
+layout (location = 2) in vec2 Anchor;
+layout (location = 3) in float Angle;
+layout (location = 4) in vec4 Source;
+layout (location = 5) in vec4 Color;
+#if TEXTURE_SLOTS > 1
+layout (location = 6) in float TexSlot;
+#else
+const float TexSlot = 0.0; // single slot layouts don't upload it
+#endif
+
+out vec2 frag_TextureUV;
+out vec4 frag_Color;
+flat out int frag_TexSlot;
+
+uniform mat4 u_ProjMtx;
+uniform vec2 u_TexSize[TEXTURE_SLOTS];
+
+// round half away from zero, same as std::round
+vec2 roundAway(vec2 v)
+{
+    return sign(v) * floor(abs(v) + 0.5);
+}
+
+void main()
+{
+    vec2 corner = vec2(float(gl_VertexID / 2), float(gl_VertexID % 2));
+
+    // snap destination to pixel grid
+    vec2 dest = roundAway(Position);
+    vec2 size = roundAway(Source.zw * Scale);
+
+    // rotate corner offset around the anchor point
+    vec2 offset = corner * size - Anchor * Scale;
+    float s = sin(Angle);
+    float c = cos(Angle);
+    vec2 position = dest + vec2(offset.x * c - offset.y * s, offset.x * s + offset.y * c);
+
+    gl_Position = u_ProjMtx * vec4(position.x, position.y, 0, 1.0);
+    frag_TexSlot = int(TexSlot);
+    frag_TextureUV = (Source.xy + corner * Source.zw) / u_TexSize[frag_TexSlot];
     frag_Color = Color;
 })glsl";
 
@@ -27,14 +115,43 @@ precision mediump float;
 
 in vec2 frag_TextureUV;
 in vec4 frag_Color;
+flat in int frag_TexSlot;
 
 out vec4 out_Color;
 
-uniform sampler2D u_Texture;
+uniform sampler2D u_Texture[TEXTURE_SLOTS];
+
+// samplers may only be indexed by constants, so each slot gets its own branch
+vec4 sampleTexture(vec2 uv)
+{
+SAMPLE_TEXTURE_SLOTS
+}
 
 void main()
 {
-    out_Color = texture(u_Texture, frag_TextureUV) * frag_Color;
+    out_Color = sampleTexture(frag_TextureUV) * frag_Color;
 })glsl";
 
+    /// Fill in the number of texture slots a sprite batch shader samples from
+    /// @param source       one of the shader templates above
+    /// @param textureSlots number of textures bound per draw call, at least 1
+    inline string spriteBatch2dShader(const string &source, const int textureSlots)
+    {
+        string sampler;
+        for (int i = 0; i < textureSlots - 1; ++i)
+        {
+            sampler += "    if (frag_TexSlot == " + std::to_string(i) + ") return texture(u_Texture[" +
+                std::to_string(i) + "], uv);\n";
+        }
+        sampler += "    return texture(u_Texture[" + std::to_string(textureSlots - 1) + "], uv);";
+
+        // defines must follow the #version line
+        auto result = source;
+        result.insert(result.find('\n') + 1, "#define TEXTURE_SLOTS " + std::to_string(textureSlots) + "\n");
+        if (const auto pos = result.find("SAMPLE_TEXTURE_SLOTS"); pos != string::npos)
+            result.replace(pos, std::size("SAMPLE_TEXTURE_SLOTS") - 1, sampler);
+
+        return result;
+    }
+
 }
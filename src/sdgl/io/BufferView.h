@@ -51,6 +51,13 @@ namespace sdgl::io {
             m_buf((ubyte *)buffer.data()), m_pos(0), m_size(buffer.size()), m_endian(endianness)
         {}
 
+        /// Create BufferView from a span of bytes, e.g. a `MappedFile`
+        /// @param buffer span of the memory to view
+        /// @param endianness expected endianness of numeric data types (strings are always handled in little-endian order)
+        explicit BufferView(const span<const ubyte> buffer, const Endian::Enum endianness = Endian::Little) :
+            m_buf((ubyte *)buffer.data()), m_pos(0), m_size(buffer.size()), m_endian(endianness)
+        {}
+
         /// Read data into a numeric value. Currently, this function only supports primitive numeric types.
         /// Use other overloads for strings.
         /// @tparam T primitive numberic type - please ensure this type's size is what you intend to read.
@@ -0,0 +1,172 @@
+#include "FileWatcher.h"
+
+#include <sdgl/logging.h>
+#include <sdgl/platform.h>
+
+#if defined(SDGL_PLATFORM_LINUX) || defined(SDGL_PLATFORM_ANDROID)
+#   define SDGL_FILE_WATCHER_INOTIFY
+#   include <sys/inotify.h>
+#   include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
+
+namespace sdgl::io {
+#ifdef SDGL_FILE_WATCHER_INOTIFY
+    /// Files finished being written or moved in, and directories created or moved in
+    static constexpr uint32_t WatchMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR;
+#endif
+
+    FileWatcher::~FileWatcher()
+    {
+        close();
+    }
+
+    bool FileWatcher::isSupported()
+    {
+#ifdef SDGL_FILE_WATCHER_INOTIFY
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool FileWatcher::open(const fs::path &directory, const double debounce)
+    {
+        close();
+
+#ifdef SDGL_FILE_WATCHER_INOTIFY
+        std::error_code ec;
+        if (!fs::is_directory(directory, ec))
+        {
+            SDGL_ERROR("Failed to watch \"{}\": not a directory", directory);
+            return false;
+        }
+
+        m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_fd < 0)
+        {
+            SDGL_ERROR("Failed to watch \"{}\": {}", directory, std::strerror(errno));
+            return false;
+        }
+
+        m_directory = fs::absolute(directory).lexically_normal();
+        m_debounce = debounce;
+        addWatch(m_directory, false);
+        return true;
+#else
+        SDGL_ERROR("Failed to watch \"{}\": file watching is not supported on this platform", directory);
+        return false;
+#endif
+    }
+
+    void FileWatcher::close()
+    {
+#ifdef SDGL_FILE_WATCHER_INOTIFY
+        if (m_fd >= 0)
+            ::close(m_fd); // removes its watches
+#endif
+        m_fd = -1;
+        m_directory.clear();
+        m_watches.clear();
+        m_pending.clear();
+    }
+
+    void FileWatcher::addWatch(const fs::path &directory, const bool markFiles)
+    {
+#ifdef SDGL_FILE_WATCHER_INOTIFY
+        const auto wd = inotify_add_watch(m_fd, directory.c_str(), WatchMask);
+        if (wd < 0)
+        {
+            SDGL_ERROR("Failed to watch directory \"{}\": {}", directory, std::strerror(errno));
+            return;
+        }
+        m_watches[wd] = directory;
+
+        // entries created before the watch was added have no events
+        std::error_code ec;
+        const auto now = std::chrono::steady_clock::now();
+        for (auto it = fs::directory_iterator(directory, ec); !ec && it != fs::directory_iterator(); it.increment(ec))
+        {
+            if (it->is_directory(ec))
+                addWatch(it->path(), markFiles);
+            else if (markFiles && it->is_regular_file(ec))
+                m_pending[it->path().lexically_normal().native()] = now;
+        }
+#else
+        static_cast<void>(directory);
+        static_cast<void>(markFiles);
+#endif
+    }
+
+    size_t FileWatcher::poll(vector<fs::path> *outChanged)
+    {
+        if (!isOpen())
+            return 0;
+
+#ifdef SDGL_FILE_WATCHER_INOTIFY
+        const auto now = std::chrono::steady_clock::now();
+
+        alignas(inotify_event) char buffer[4096];
+        while (true)
+        {
+            const auto length = read(m_fd, buffer, sizeof(buffer));
+            if (length <= 0)
+            {
+                if (length < 0 && errno != EAGAIN && errno != EINTR)
+                    SDGL_ERROR("Failed to read file events for \"{}\": {}", m_directory, std::strerror(errno));
+                break;
+            }
+
+            for (ssize_t offset = 0; offset < length; )
+            {
+                const auto event = reinterpret_cast<const inotify_event *>(buffer + offset);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+                if (event->mask & IN_Q_OVERFLOW)
+                {
+                    SDGL_WARN("File events for \"{}\" overflowed, some changes were missed", m_directory);
+                    continue;
+                }
+
+                if (event->mask & IN_IGNORED) // directory was removed
+                {
+                    m_watches.erase(event->wd);
+                    continue;
+                }
+
+                const auto watch = m_watches.find(event->wd);
+                if (watch == m_watches.end() || event->len == 0)
+                    continue;
+
+                const auto path = watch->second / event->name;
+                if (event->mask & IN_ISDIR)
+                    addWatch(path, true);
+                else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+                    m_pending[path.native()] = now;
+            }
+        }
+
+        // report files that went quiet
+        size_t count = 0;
+        for (auto it = m_pending.begin(); it != m_pending.end(); )
+        {
+            if (std::chrono::duration<double, std::milli>(now - it->second).count() < m_debounce)
+            {
+                ++it;
+                continue;
+            }
+
+            outChanged->emplace_back(it->first);
+            it = m_pending.erase(it);
+            ++count;
+        }
+
+        return count;
+#else
+        static_cast<void>(outChanged);
+        return 0;
+#endif
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <sdgl/sdglib.h>
+
+#include <chrono>
+#include <unordered_map>
+
+namespace sdgl::io {
+    /// Reports files written under a directory and its subdirectories, via inotify where available (Linux, Android).
+    /// Events are read without blocking when polled, so no thread is needed. A file is reported once it has been
+    /// quiet for the debounce time, so a burst of writes, e.g. an editor saving through a temporary file, is reported
+    /// once. Deleted files aren't reported.
+    class FileWatcher {
+    public:
+        /// Milliseconds a file must go without events before it's reported, by default
+        static constexpr double DefaultDebounce = 100.0;
+
+        FileWatcher() : m_fd(-1), m_directory(), m_debounce(DefaultDebounce), m_watches(), m_pending() { }
+        ~FileWatcher();
+
+        FileWatcher(const FileWatcher &) = delete;
+        FileWatcher &operator=(const FileWatcher &) = delete;
+
+        /// Start watching a directory, stopping any previous watch
+        /// @param directory directory to watch, including subdirectories created later
+        /// @param debounce  milliseconds a file must go without events before it's reported
+        /// @returns whether watching started; always fails where watching isn't supported
+        bool open(const fs::path &directory, double debounce = DefaultDebounce);
+
+        /// Stop watching, dropping changes not yet reported
+        void close();
+
+        [[nodiscard]]
+        bool isOpen() const { return m_fd >= 0; }
+
+        /// Absolute path of the watched directory
+        [[nodiscard]]
+        const fs::path &directory() const { return m_directory; }
+
+        /// Collect files that changed and have been quiet for the debounce time, measured from the poll that read
+        /// their last event. Cost is proportional to the number of events and files waiting to be reported.
+        /// @param outChanged [out] receives absolute, lexically normal paths of the files, appended to its contents
+        /// @returns number of paths appended
+        size_t poll(vector<fs::path> *outChanged);
+
+        /// Whether this platform supports watching files
+        [[nodiscard]]
+        static bool isSupported();
+
+    private:
+        /// Watch a directory and the directories under it, marking files already in them as changed
+        /// @param markFiles whether files found count as changed, for directories created or moved in
+        void addWatch(const fs::path &directory, bool markFiles);
+
+        int m_fd;
+        fs::path m_directory;
+        double m_debounce;
+        std::unordered_map<int, fs::path> m_watches;    ///< directory of each watch descriptor
+        std::unordered_map<fs::path::string_type, std::chrono::steady_clock::time_point> m_pending; ///< last event
+    };
+}
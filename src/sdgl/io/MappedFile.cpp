@@ -0,0 +1,124 @@
+#include "MappedFile.h"
+#include "io.h"
+
+#include <sdgl/logging.h>
+#include <sdgl/platform.h>
+
+#if defined(SDGL_PLATFORM_LINUX) || defined(SDGL_PLATFORM_APPLE) || defined(SDGL_PLATFORM_ANDROID)
+#   define SDGL_MAPPED_FILE_MMAP
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+#include <cstring>
+#include <utility>
+
+namespace sdgl::io {
+    /// Stands in for the contents of empty files, which can't be mapped
+    static const ubyte s_empty[1] = {};
+
+    MappedFile::~MappedFile()
+    {
+        close();
+    }
+
+    MappedFile::MappedFile(MappedFile &&other) noexcept :
+        m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)),
+        m_mapped(std::exchange(other.m_mapped, false)), m_buffer(std::move(other.m_buffer))
+    {
+    }
+
+    MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_mapped = std::exchange(other.m_mapped, false);
+            m_buffer = std::move(other.m_buffer);
+        }
+
+        return *this;
+    }
+
+    bool MappedFile::open(const fs::path &filepath)
+    {
+        close();
+
+        if (span<const ubyte> view; findMounted(filepath, &view))
+        {
+            m_data = view.empty() ? s_empty : view.data();
+            m_size = view.size();
+            return true;
+        }
+
+        const auto fullpath = (filepath.is_absolute()) ? filepath : (getResourcePath() / filepath);
+
+#ifdef SDGL_MAPPED_FILE_MMAP
+        const auto fd = ::open(fullpath.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            SDGL_ERROR("Failed to open file \"{}\": {}", fullpath, std::strerror(errno));
+            return false;
+        }
+
+        struct stat info{};
+        if (fstat(fd, &info) != 0)
+        {
+            SDGL_ERROR("Failed to get size of file \"{}\": {}", fullpath, std::strerror(errno));
+            ::close(fd);
+            return false;
+        }
+
+        if (info.st_size == 0)
+        {
+            ::close(fd);
+            m_data = s_empty;
+            m_size = 0;
+            return true;
+        }
+
+        const auto size = static_cast<size_t>(info.st_size);
+        const auto data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // the mapping keeps its own reference to the file
+        if (data == MAP_FAILED)
+        {
+            SDGL_ERROR("Failed to map file \"{}\": {}", fullpath, std::strerror(errno));
+            return false;
+        }
+
+        m_data = static_cast<const ubyte *>(data);
+        m_size = size;
+        m_mapped = true;
+        return true;
+#else
+        vector<ubyte> buffer;
+        if (!readFile(fullpath, &buffer))
+            return false;
+
+        m_buffer.swap(buffer);
+        m_data = m_buffer.empty() ? s_empty : m_buffer.data();
+        m_size = m_buffer.size();
+        return true;
+#endif
+    }
+
+    void MappedFile::close()
+    {
+        if (!m_data)
+            return;
+
+#ifdef SDGL_MAPPED_FILE_MMAP
+        if (m_mapped)
+            munmap(const_cast<ubyte *>(m_data), m_size);
+#endif
+        m_mapped = false;
+        m_buffer.clear();
+        m_buffer.shrink_to_fit();
+        m_data = nullptr;
+        m_size = 0;
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <sdgl/sdglib.h>
+
+namespace sdgl::io {
+    /// Read-only view of a whole file mapped into memory; pages are faulted in as they are touched instead of being
+    /// copied up front, so parsers can read it in place, e.g. via `BufferView`. Files in a mounted archive are viewed
+    /// in the archive's mapping. Platforms without mmap (Windows, Emscripten) read the file into an owned buffer
+    /// instead.
+    class MappedFile {
+    public:
+        MappedFile() : m_data(), m_size(), m_mapped(), m_buffer() { }
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        MappedFile(MappedFile &&other) noexcept;
+        MappedFile &operator=(MappedFile &&other) noexcept;
+
+        /// Map a file, closing any file already mapped
+        /// @param filepath path to the file, if it is a relative path, it stems from the resource directory; files
+        ///                 under the resource directory are viewed in mounted archives first
+        /// @returns whether the file was mapped
+        bool open(const fs::path &filepath);
+
+        /// Unmap the file; views of it become invalid. Views into a mounted archive stay valid until it's unmounted.
+        void close();
+
+        [[nodiscard]]
+        bool isOpen() const { return m_data != nullptr; }
+
+        /// Contents of the file, valid until the file is closed; page-aligned where mapped
+        [[nodiscard]]
+        span<const ubyte> data() const { return {m_data, m_size}; }
+
+        [[nodiscard]]
+        size_t size() const { return m_size; }
+
+    private:
+        const ubyte *m_data;
+        size_t m_size;
+        bool m_mapped;          ///< whether `m_data` is our own mapping, to be unmapped on close
+        vector<ubyte> m_buffer; ///< holds the file where it can't be mapped
+    };
+}
@@ -0,0 +1,297 @@
+#include "PakArchive.h"
+#include "endian.h"
+#include "FileWriter.h"
+
+#include <sdgl/logging.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace sdgl::io {
+    struct PakArchive::Entry
+    {
+        uint64 hash;
+        uint64 offset;      ///< byte offset of the file data from the start of the archive
+        uint64 size;        ///< byte size of the file data
+        uint path;          ///< byte offset of the path in the path table
+        uint pathLength;    ///< length of the path, not including the null terminator
+    };
+
+    static constexpr char Magic[4] = {'S', 'P', 'A', 'K'};
+    static constexpr size_t HeaderSize = 16;
+
+    static uint64 alignData(const uint64 position)
+    {
+        return (position + PakArchive::DataAlignment - 1) / PakArchive::DataAlignment * PakArchive::DataAlignment;
+    }
+
+    bool PakArchive::open(const fs::path &filepath)
+    {
+        static_assert(sizeof(Entry) == 32);
+        close();
+
+        if constexpr (SystemEndian != Endian::Little)
+        {
+            SDGL_ERROR("Pak archives can only be read on little-endian systems");
+            return false;
+        }
+
+        if (!m_file.open(filepath))
+            return false;
+
+        const auto data = m_file.data();
+        if (data.size() < HeaderSize || std::memcmp(data.data(), Magic, sizeof(Magic)) != 0)
+        {
+            SDGL_ERROR("\"{}\" is not a pak archive", filepath);
+            m_file.close();
+            return false;
+        }
+
+        uint header[3]; // version, entry count, path table size
+        std::memcpy(header, data.data() + sizeof(Magic), sizeof(header));
+        if (header[0] != Version)
+        {
+            SDGL_ERROR("Unsupported pak archive version {} in \"{}\"", header[0], filepath);
+            m_file.close();
+            return false;
+        }
+
+        const auto entryCount = header[1];
+        const auto pathsSize = header[2];
+        const auto tocSize = static_cast<uint64>(entryCount) * sizeof(Entry) + pathsSize;
+        if (tocSize > data.size() - HeaderSize)
+        {
+            SDGL_ERROR("Pak archive \"{}\" is truncated", filepath);
+            m_file.close();
+            return false;
+        }
+
+        const auto entries = reinterpret_cast<const Entry *>(data.data() + HeaderSize);
+        const auto paths = reinterpret_cast<const char *>(entries + entryCount);
+
+        // validate the table once, so lookups can trust it
+        for (uint i = 0; i < entryCount; ++i)
+        {
+            const auto &entry = entries[i];
+            if (entry.path >= pathsSize || entry.pathLength >= pathsSize - entry.path ||
+                paths[entry.path + entry.pathLength] != '\0' ||
+                entry.offset > data.size() || entry.size > data.size() - entry.offset ||
+                (i > 0 && entries[i - 1].hash > entry.hash))
+            {
+                SDGL_ERROR("Pak archive \"{}\" has a malformed entry at index {}", filepath, i);
+                m_file.close();
+                return false;
+            }
+        }
+
+        m_path = filepath;
+        m_entries = entries;
+        m_entryCount = entryCount;
+        m_paths = paths;
+        m_pathsSize = pathsSize;
+        return true;
+    }
+
+    void PakArchive::close()
+    {
+        m_file.close();
+        m_path.clear();
+        m_entries = nullptr;
+        m_entryCount = 0;
+        m_paths = nullptr;
+        m_pathsSize = 0;
+    }
+
+    bool PakArchive::find(const fs::path &filepath, span<const ubyte> *outData) const
+    {
+        if (!isOpen())
+            return false;
+
+        const auto key = normalizePath(filepath);
+        const auto hash = hashPath(key);
+
+        const auto end = m_entries + m_entryCount;
+        for (auto it = std::lower_bound(m_entries, end, hash,
+                [](const Entry &entry, const uint64 value) { return entry.hash < value; });
+             it != end && it->hash == hash; ++it)
+        {
+            if (string_view(m_paths + it->path, it->pathLength) == key)
+            {
+                if (outData)
+                    *outData = m_file.data().subspan(it->offset, it->size);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool PakArchive::contains(const fs::path &filepath) const
+    {
+        return find(filepath, nullptr);
+    }
+
+    bool PakArchive::pack(const fs::path &rootDir, const span<const fs::path> files, const fs::path &filepath)
+    {
+        if constexpr (SystemEndian != Endian::Little)
+        {
+            SDGL_ERROR("Pak archives can only be written on little-endian systems");
+            return false;
+        }
+
+        struct Source
+        {
+            string path;
+            uint64 hash;
+            fs::path file;
+            uint64 offset;
+            uint64 size;
+        };
+
+        // Collect files
+        const auto root = fs::absolute(rootDir);
+        vector<Source> sources;
+        std::error_code ec;
+        if (files.empty())
+        {
+            for (auto it = fs::recursive_directory_iterator(root, ec); !ec && it != fs::recursive_directory_iterator();
+                 it.increment(ec))
+            {
+                if (it->is_regular_file())
+                    sources.push_back({normalizePath(it->path().lexically_relative(root)), 0, it->path(), 0, 0});
+            }
+
+            if (ec)
+            {
+                SDGL_ERROR("Failed to list files in \"{}\": {}", root, ec.message());
+                return false;
+            }
+        }
+        else
+        {
+            for (const auto &file : files)
+                sources.push_back({normalizePath(file), 0, root / file, 0, 0});
+        }
+
+        for (auto &source : sources)
+            source.hash = hashPath(source.path);
+
+        std::sort(sources.begin(), sources.end(), [](const Source &a, const Source &b) {
+            return a.hash < b.hash || (a.hash == b.hash && a.path < b.path);
+        });
+
+        // Lay out the archive
+        uint64 pathsSize = 0;
+        for (size_t i = 0; i < sources.size(); ++i)
+        {
+            if (i > 0 && sources[i - 1].path == sources[i].path)
+            {
+                SDGL_ERROR("Pak archive file \"{}\" was listed more than once", sources[i].path);
+                return false;
+            }
+
+            pathsSize += sources[i].path.size() + 1;
+        }
+
+        if (sources.size() > std::numeric_limits<uint>::max() || pathsSize > std::numeric_limits<uint>::max())
+        {
+            SDGL_ERROR("Too many files to pack into \"{}\"", filepath);
+            return false;
+        }
+
+        auto cursor = alignData(HeaderSize + sources.size() * sizeof(Entry) + pathsSize);
+        for (auto &source : sources)
+        {
+            source.size = fs::file_size(source.file, ec);
+            if (ec)
+            {
+                SDGL_ERROR("Failed to get size of file \"{}\": {}", source.file, ec.message());
+                return false;
+            }
+
+            source.offset = cursor;
+            cursor = alignData(cursor + source.size);
+        }
+
+        // Write it
+        if (filepath.has_parent_path())
+            fs::create_directories(filepath.parent_path(), ec);
+
+        FileWriter writer(filepath);
+        if (!writer.isOpen())
+        {
+            SDGL_ERROR("Failed to open \"{}\" for writing", filepath);
+            return false;
+        }
+
+        writer.writeRaw(Magic, sizeof(Magic));
+        writer.write(Version);
+        writer.write(static_cast<uint>(sources.size()));
+        writer.write(static_cast<uint>(pathsSize));
+
+        uint pathOffset = 0;
+        for (const auto &source : sources)
+        {
+            writer.write(source.hash);
+            writer.write(source.offset);
+            writer.write(source.size);
+            writer.write(pathOffset);
+            writer.write(static_cast<uint>(source.path.size()));
+            pathOffset += static_cast<uint>(source.path.size() + 1);
+        }
+
+        for (const auto &source : sources)
+            writer.write(source.path, true);
+
+        static constexpr ubyte Padding[DataAlignment] = {};
+        uint64 position = HeaderSize + sources.size() * sizeof(Entry) + pathsSize;
+        for (const auto &source : sources)
+        {
+            writer.writeRaw(Padding, source.offset - position);
+
+            MappedFile file;
+            if (!file.open(source.file))
+                return false;
+
+            if (file.size() != source.size)
+            {
+                SDGL_ERROR("File \"{}\" changed while packing", source.file);
+                return false;
+            }
+
+            if (file.size() > 0 && writer.writeRaw(file.data().data(), file.size()) != file.size())
+            {
+                SDGL_ERROR("Failed to write \"{}\" into \"{}\"", source.path, filepath);
+                return false;
+            }
+
+            position = source.offset + source.size;
+        }
+
+        return true;
+    }
+
+    string PakArchive::normalizePath(const fs::path &filepath)
+    {
+        auto normal = filepath.lexically_normal().generic_string();
+        if (normal == ".")
+            normal.clear();
+        else if (normal.starts_with("./"))
+            normal.erase(0, 2);
+
+        return normal;
+    }
+
+    uint64 PakArchive::hashPath(const string_view normalizedPath)
+    {
+        uint64 hash = 14695981039346656037ull;
+        for (const auto c : normalizedPath)
+        {
+            hash ^= static_cast<ubyte>(c);
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <sdgl/sdglib.h>
+
+#include "MappedFile.h"
+
+namespace sdgl::io {
+    /// Read-only archive of many files in one memory-mapped file, looked up through a table of contents sorted by path
+    /// hash. Files are returned as views into the mapping, without opening or copying anything.
+    ///
+    /// Format v1, all integers little endian:
+    /// 4 bytes "SPAK", uint32 version, uint32 entry count, uint32 byte size of the path table
+    /// entries: {uint64 path hash, uint64 data offset, uint64 data size, uint32 path offset, uint32 path length},
+    ///          sorted by hash, then path
+    /// path table: null-terminated paths relative to the archive root, '/' separated
+    /// file data, each file starting on a multiple of `DataAlignment` from the start of the archive
+    class PakArchive {
+    public:
+        static constexpr uint Version = 1;
+        /// Alignment of each file's data, enough for SBC files to be used in place
+        static constexpr size_t DataAlignment = 16;
+
+        PakArchive() : m_file(), m_path(), m_entries(), m_entryCount(), m_paths(), m_pathsSize() { }
+
+        PakArchive(const PakArchive &) = delete;
+        PakArchive &operator=(const PakArchive &) = delete;
+
+        /// Map an archive and validate its table of contents, closing any archive already open
+        /// @param filepath path to the archive, if it is a relative path, it stems from the resource directory
+        /// @returns whether the archive is open
+        bool open(const fs::path &filepath);
+
+        /// Unmap the archive; views of its files become invalid
+        void close();
+
+        [[nodiscard]]
+        bool isOpen() const { return m_file.isOpen(); }
+
+        /// Path the archive was opened from
+        [[nodiscard]]
+        const fs::path &path() const { return m_path; }
+
+        /// Number of files in the archive
+        [[nodiscard]]
+        size_t fileCount() const { return m_entryCount; }
+
+        /// Find a file in the archive
+        /// @param filepath     path relative to the archive root
+        /// @param outData [out] receives a view of the file, valid until the archive is closed
+        /// @returns whether the archive holds the file
+        bool find(const fs::path &filepath, span<const ubyte> *outData) const;
+
+        [[nodiscard]]
+        bool contains(const fs::path &filepath) const;
+
+        /// Write an archive
+        /// @param rootDir  directory that archive paths are relative to
+        /// @param files    files to pack, relative to `rootDir`; if empty, every regular file under `rootDir` is packed
+        /// @param filepath path of the archive to write
+        /// @returns whether function succeeded
+        static bool pack(const fs::path &rootDir, span<const fs::path> files, const fs::path &filepath);
+
+        /// Archive form of a relative path: lexically normal, '/' separated, without a leading "./"
+        static string normalizePath(const fs::path &filepath);
+
+        /// 64-bit FNV-1a hash of a normalized path
+        static uint64 hashPath(string_view normalizedPath);
+
+    private:
+        struct Entry;
+
+        MappedFile m_file;
+        fs::path m_path;
+        const Entry *m_entries;
+        uint m_entryCount;
+        const char *m_paths;
+        uint m_pathsSize;
+    };
+}
@@ -0,0 +1,122 @@
+#include "SbcReader.h"
+#include "endian.h"
+
+#include <sdgl/logging.h>
+
+#include <cstring>
+
+namespace sdgl::io {
+    /// Read a little-endian uint32 at an offset known to be in range
+    static uint readUint(const ubyte *data)
+    {
+        uint value;
+        std::memcpy(&value, data, sizeof(uint));
+        return value;
+    }
+
+    bool SbcReader::open(const span<const ubyte> data, const char *subFormat, const ubyte maxVersion)
+    {
+        m_data = {};
+        m_version = 0;
+        m_chunks.clear();
+
+        if constexpr (SystemEndian != Endian::Little)
+        {
+            SDGL_ERROR("SBC files can only be used in place on little-endian systems");
+            return false;
+        }
+
+        if (reinterpret_cast<uintptr_t>(data.data()) % sbc::ChunkAlignment != 0)
+        {
+            SDGL_ERROR("SBC data must be {}-byte aligned", sbc::ChunkAlignment);
+            return false;
+        }
+
+        if (data.size() < sbc::HeaderSize || std::memcmp(data.data(), "SBC", 3) != 0)
+        {
+            SDGL_ERROR("Data is not in SBC format");
+            return false;
+        }
+
+        if (data[3] != sbc::Version)
+        {
+            SDGL_ERROR("Unsupported SBC version {}", static_cast<int>(data[3]));
+            return false;
+        }
+
+        if (std::memcmp(data.data() + 4, subFormat, 3) != 0)
+        {
+            SDGL_ERROR("SBC sub-format mismatch: expected \"{}\", got \"{}\"", subFormat,
+                string_view(reinterpret_cast<const char *>(data.data() + 4), 3));
+            return false;
+        }
+
+        if (data[7] == 0 || data[7] > maxVersion)
+        {
+            SDGL_ERROR("Unsupported SBC {} version {}", subFormat, static_cast<int>(data[7]));
+            return false;
+        }
+
+        const auto size = readUint(data.data() + 8);
+        if (size != data.size() - 8)
+        {
+            SDGL_ERROR("SBC size mismatch: header declares {} bytes, got {}", size, data.size() - 8);
+            return false;
+        }
+
+        // index chunks
+        for (size_t pos = sbc::HeaderSize; pos < data.size(); )
+        {
+            if (data.size() - pos < 8)
+            {
+                SDGL_ERROR("SBC chunk header at byte {} is truncated", pos);
+                m_chunks.clear();
+                return false;
+            }
+
+            Chunk chunk;
+            std::memcpy(chunk.name, data.data() + pos, 4);
+            const auto length = readUint(data.data() + pos + 4);
+            pos += 8;
+
+            if (length > data.size() - pos)
+            {
+                SDGL_ERROR("SBC chunk \"{}\" exceeds the end of the file", string_view(chunk.name, 4));
+                m_chunks.clear();
+                return false;
+            }
+
+            chunk.data = data.subspan(pos, length);
+            m_chunks.emplace_back(chunk);
+
+            // chunks are padded so that the next one stays aligned
+            pos += (length + sbc::ChunkAlignment - 1) / sbc::ChunkAlignment * sbc::ChunkAlignment;
+        }
+
+        m_data = data;
+        m_version = data[7];
+        return true;
+    }
+
+    span<const ubyte> SbcReader::chunk(const char *name) const
+    {
+        for (const auto &chunk : m_chunks)
+        {
+            if (std::memcmp(chunk.name, name, 4) == 0)
+                return chunk.data;
+        }
+
+        return {};
+    }
+
+    string_view SbcReader::getString(const uint offset) const
+    {
+        const auto strings = chunk("STRS");
+        if (offset >= strings.size())
+            return {};
+
+        const auto start = reinterpret_cast<const char *>(strings.data()) + offset;
+        const auto end = static_cast<const char *>(std::memchr(start, 0, strings.size() - offset));
+        return end ? string_view(start, end - start) : string_view();
+    }
+}
@@ -0,0 +1,174 @@
+#pragma once
+#include <sdgl/sdglib.h>
+
+namespace sdgl::io {
+    /// Fixed-size records of SBC files, laid out exactly as they are stored so that they can be used in place.
+    /// See `io/convert/content.h` for the format.
+    namespace sbc {
+        inline constexpr ubyte Version = 1;
+
+        /// Sub-format codes and versions
+        inline constexpr char ImageFormat[] = "IMG";
+        inline constexpr ubyte ImageVersion = 1;
+        inline constexpr char AtlasFormat[] = "ATL";
+        inline constexpr ubyte AtlasVersion = 1;
+        inline constexpr char FontFormat[] = "FNT";
+        inline constexpr ubyte FontVersion = 1;
+
+        /// Bytes before the first chunk
+        inline constexpr size_t HeaderSize = 12;
+        /// Chunk data starts and ends on multiples of this from the start of the file
+        inline constexpr size_t ChunkAlignment = 4;
+
+        struct PixelFormat
+        {
+            enum Enum : uint
+            {
+                RGBA8888,
+            };
+        };
+
+        /// IMG "HEAD" chunk
+        struct ImageHeader
+        {
+            uint width;
+            uint height;
+            PixelFormat::Enum format;
+            uint levelCount;  ///< number of mip levels, same as the "MIPS" record count
+        };
+
+        /// IMG "MIPS" chunk entry, the full-size image first, then each half-size level down to 1x1
+        struct ImageLevel
+        {
+            uint width;
+            uint height;
+            uint offset;  ///< byte offset of the level's pixels within the "DATA" chunk
+            uint size;    ///< byte size of the level's pixels
+        };
+
+        /// ATL "PAGE" and FNT "PAGE" chunk entry
+        struct Page
+        {
+            uint name;    ///< string table offset of the page image file, relative to the containing file
+        };
+
+        /// ATL "FRMS" chunk entry; sorted by name
+        struct AtlasFrame
+        {
+            uint name;    ///< string table offset of the frame name
+            int16 x, y, width, height;          ///< source rectangle in the page, as rotated in the page
+            int16 offsetX, offsetY;             ///< trim offset
+            int16 sourceWidth, sourceHeight;    ///< untrimmed size
+            uint16 page;                        ///< index of the page
+            ubyte rotated;
+            ubyte padding;
+        };
+
+        /// FNT "INFO" chunk
+        struct FontInfo
+        {
+            uint name;    ///< string table offset of the font name
+            int16 fontSize;
+            uint16 lineHeight;
+            uint16 base;
+            uint16 padding;
+        };
+
+        /// FNT "CHRS" chunk entry; sorted by id
+        struct FontChar
+        {
+            uint id;
+            uint16 x, y, width, height;
+            int16 xoffset, yoffset, xadvance;
+            ubyte page;
+            ubyte channel;
+        };
+
+        /// FNT "KERN" chunk entry; sorted by first, then second
+        struct FontKerning
+        {
+            uint first;
+            uint second;
+            int16 amount;
+            int16 padding;
+        };
+
+        static_assert(sizeof(ImageHeader) == 16);
+        static_assert(sizeof(ImageLevel) == 16);
+        static_assert(sizeof(Page) == 4);
+        static_assert(sizeof(AtlasFrame) == 24);
+        static_assert(sizeof(FontInfo) == 12);
+        static_assert(sizeof(FontChar) == 20);
+        static_assert(sizeof(FontKerning) == 12);
+    }
+
+    /// Validates an SBC file in memory and views its chunks in place, without copying or decoding anything
+    class SbcReader {
+    public:
+        SbcReader() : m_data(), m_version(), m_chunks() { }
+
+        /// Check the file header and index the chunks
+        /// @param data       file contents, must outlive the reader and be 4-byte aligned
+        /// @param subFormat  expected three character sub-format code, e.g. `sbc::ImageFormat`
+        /// @param maxVersion newest sub-format version the caller understands
+        /// @returns whether the data is a well-formed SBC file of the sub-format
+        bool open(span<const ubyte> data, const char *subFormat, ubyte maxVersion);
+
+        /// Version of the opened sub-format
+        [[nodiscard]]
+        ubyte version() const { return m_version; }
+
+        /// Get a chunk's data
+        /// @param name four character chunk name
+        /// @returns chunk data, or an empty span if the file has no such chunk
+        [[nodiscard]]
+        span<const ubyte> chunk(const char *name) const;
+
+        /// View a chunk holding a single record
+        /// @returns the record, or nullptr if the chunk is missing or too small
+        template <typename T>
+        [[nodiscard]]
+        const T *record(const char *name) const
+        {
+            const auto data = chunk(name);
+            return data.size() >= sizeof(T) ? reinterpret_cast<const T *>(data.data()) : nullptr;
+        }
+
+        /// View a chunk holding a uint32 count followed by that many records
+        /// @param outRecords [out] receives the records; empty if the chunk is missing
+        /// @returns false if the chunk is too small for its count
+        template <typename T>
+        bool records(const char *name, span<const T> *outRecords) const
+        {
+            *outRecords = {};
+            const auto data = chunk(name);
+            if (data.empty())
+                return true;
+
+            if (data.size() < sizeof(uint))
+                return false;
+            const auto count = *reinterpret_cast<const uint *>(data.data());
+            if ((data.size() - sizeof(uint)) / sizeof(T) < count)
+                return false;
+
+            *outRecords = {reinterpret_cast<const T *>(data.data() + sizeof(uint)), count};
+            return true;
+        }
+
+        /// Get a string from the "STRS" chunk
+        /// @returns the null-terminated string at the offset, or an empty string if it's out of range
+        [[nodiscard]]
+        string_view getString(uint offset) const;
+
+    private:
+        struct Chunk
+        {
+            char name[4];
+            span<const ubyte> data;
+        };
+
+        span<const ubyte> m_data;
+        ubyte m_version;
+        vector<Chunk> m_chunks;
+    };
+}
@@ -1,23 +1,336 @@
 #include "content.h"
 
 #include <stb_image.h>
+#include <sdgl/graphics/atlas/CrunchAtlasData.h>
+#include <sdgl/graphics/font/BMFontData.h>
+#include <sdgl/io/endian.h>
 #include <sdgl/io/io.h>
+#include <sdgl/io/SbcReader.h>
 #include <sdgl/logging.h>
 
-bool sdgl::io::convert::writeImageToSbc(const string &imageData, const string &filepath)
-{
-    int width, height, bytesPerPixel;
-    const auto data = stbi_load_from_memory(
-        reinterpret_cast<const stbi_uc *>(imageData.data()),
-        static_cast<int>(imageData.size()),
-        &width, &height, &bytesPerPixel, 0);
+#include <algorithm>
+#include <cstring>
 
-    if (!data)
+namespace sdgl::io::convert {
+namespace {
+    /// Builds an SBC file in memory
+    class SbcWriter {
+    public:
+        SbcWriter(const char *subFormat, const ubyte subFormatVersion) : m_data(), m_chunkStart()
+        {
+            append("SBC", 3);
+            write(sbc::Version);
+            append(subFormat, 3);
+            write(subFormatVersion);
+            write<uint>(0); // size, patched on save
+        }
+
+        template <typename T>
+        void write(const T &value)
+        {
+            append(&value, sizeof(T));
+        }
+
+        void append(const void *data, const size_t size)
+        {
+            const auto bytes = static_cast<const ubyte *>(data);
+            m_data.insert(m_data.end(), bytes, bytes + size);
+        }
+
+        void beginChunk(const char *name)
+        {
+            append(name, 4);
+            m_chunkStart = m_data.size();
+            write<uint>(0); // length, patched by `endChunk`
+        }
+
+        void endChunk()
+        {
+            const auto length = static_cast<uint>(m_data.size() - m_chunkStart - sizeof(uint));
+            std::memcpy(m_data.data() + m_chunkStart, &length, sizeof(uint));
+
+            // keep the next chunk aligned
+            m_data.resize((m_data.size() + sbc::ChunkAlignment - 1) / sbc::ChunkAlignment * sbc::ChunkAlignment);
+        }
+
+        /// Write a chunk of a uint32 count followed by the records
+        template <typename T>
+        void writeTable(const char *name, const vector<T> &records)
+        {
+            beginChunk(name);
+            write(static_cast<uint>(records.size()));
+            append(records.data(), records.size() * sizeof(T));
+            endChunk();
+        }
+
+        bool save(const fs::path &filepath)
+        {
+            if constexpr (SystemEndian != Endian::Little)
+            {
+                SDGL_ERROR("SBC files can only be written on little-endian systems");
+                return false;
+            }
+
+            const auto size = static_cast<uint>(m_data.size() - 8);
+            std::memcpy(m_data.data() + 8, &size, sizeof(uint));
+
+            if (filepath.has_parent_path())
+            {
+                std::error_code ec;
+                fs::create_directories(filepath.parent_path(), ec);
+            }
+
+            return writeFile(filepath, m_data);
+        }
+
+    private:
+        vector<ubyte> m_data;
+        size_t m_chunkStart; ///< position of the open chunk's length field
+    };
+
+    /// Collects null-terminated strings for an "STRS" chunk, storing each distinct string once
+    class StringTable {
+    public:
+        StringTable() : m_data(), m_offsets() { }
+
+        /// @returns byte offset of the string in the table
+        uint add(const string &str)
+        {
+            const auto [it, inserted] = m_offsets.try_emplace(str, static_cast<uint>(m_data.size()));
+            if (inserted)
+                m_data.insert(m_data.end(), str.c_str(), str.c_str() + str.size() + 1);
+            return it->second;
+        }
+
+        void write(SbcWriter &writer) const
+        {
+            writer.beginChunk("STRS");
+            writer.append(m_data.data(), m_data.size());
+            writer.endChunk();
+        }
+
+    private:
+        vector<char> m_data;
+        map<string, uint> m_offsets;
+    };
+}
+
+    /// Halve an RGBA8888 image with a box filter, clamping at odd edges
+    static void downsample(const ubyte *src, const uint width, const uint height, vector<ubyte> *outPixels,
+        uint *outWidth, uint *outHeight)
+    {
+        const auto dstWidth = std::max(width / 2, 1u), dstHeight = std::max(height / 2, 1u);
+        outPixels->resize(static_cast<size_t>(dstWidth) * dstHeight * 4);
+
+        auto dst = outPixels->data();
+        for (uint y = 0; y < dstHeight; ++y)
+        {
+            const auto y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+            for (uint x = 0; x < dstWidth; ++x)
+            {
+                const auto x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+                for (uint c = 0; c < 4; ++c)
+                {
+                    const auto sum =
+                        src[(static_cast<size_t>(y0) * width + x0) * 4 + c] +
+                        src[(static_cast<size_t>(y0) * width + x1) * 4 + c] +
+                        src[(static_cast<size_t>(y1) * width + x0) * 4 + c] +
+                        src[(static_cast<size_t>(y1) * width + x1) * 4 + c];
+                    *dst++ = static_cast<ubyte>((sum + 2) / 4);
+                }
+            }
+        }
+
+        *outWidth = dstWidth;
+        *outHeight = dstHeight;
+    }
+
+    static bool writeImage(const string &imageData, const fs::path &filepath)
+    {
+        int width, height, bytesPerPixel;
+        const auto data = stbi_load_from_memory(
+            reinterpret_cast<const stbi_uc *>(imageData.data()),
+            static_cast<int>(imageData.size()),
+            &width, &height, &bytesPerPixel, STBI_rgb_alpha);
+
+        if (!data)
+        {
+            SDGL_ERROR("stb_image failed to load image: {}", stbi_failure_reason());
+            return false;
+        }
+
+        // precompute the whole mip chain, so that loading only uploads it
+        vector<sbc::ImageLevel> levels;
+        vector<ubyte> pixels(data, data + static_cast<size_t>(width) * height * 4);
+        stbi_image_free(data);
+
+        levels.push_back({static_cast<uint>(width), static_cast<uint>(height), 0, static_cast<uint>(pixels.size())});
+        vector<ubyte> level;
+        while (levels.back().width > 1 || levels.back().height > 1)
+        {
+            const auto &last = levels.back();
+            uint levelWidth, levelHeight;
+            downsample(pixels.data() + last.offset, last.width, last.height, &level, &levelWidth, &levelHeight);
+
+            levels.push_back({levelWidth, levelHeight, static_cast<uint>(pixels.size()),
+                static_cast<uint>(level.size())});
+            pixels.insert(pixels.end(), level.begin(), level.end());
+        }
+
+        SbcWriter writer(sbc::ImageFormat, sbc::ImageVersion);
+
+        writer.beginChunk("HEAD");
+        writer.write(sbc::ImageHeader{
+            static_cast<uint>(width), static_cast<uint>(height), sbc::PixelFormat::RGBA8888,
+            static_cast<uint>(levels.size())
+        });
+        writer.endChunk();
+
+        writer.writeTable("MIPS", levels);
+
+        writer.beginChunk("DATA");
+        writer.append(pixels.data(), pixels.size());
+        writer.endChunk();
+
+        return writer.save(filepath);
+    }
+
+    bool writeImageToSbc(const string &imageData, const string &filepath)
+    {
+        return writeImage(imageData, filepath);
+    }
+
+    bool writeCrunchAtlasToSbc(const string &crunchData, const fs::path &sourceDir, const fs::path &filepath,
+        const bool convertPages)
     {
-        SDGL_ERROR("stb_image failed to load image: {}", stbi_failure_reason());
-        return false;
+        CrunchAtlasData data;
+        if (!CrunchAtlasData::loadBinary(crunchData, true, true, &data))
+            return false;
+
+        StringTable strings;
+        vector<sbc::Page> pages;
+        vector<sbc::AtlasFrame> frames;
+        vector<string> frameNames;
+        for (uint16 pageIndex = 0; const auto &[pageName, images] : data.textures)
+        {
+            // convert the page image next to the atlas
+            if (convertPages)
+            {
+                string imageData;
+                if (!readFile(sourceDir / (pageName + ".png"), &imageData) ||
+                    !writeImage(imageData, filepath.parent_path() / (pageName + ".sbc")))
+                {
+                    return false;
+                }
+            }
+
+            pages.push_back({strings.add(pageName + ".sbc")});
+
+            for (const auto &image : images)
+            {
+                frames.push_back({
+                    .name = strings.add(image.name),
+                    .x = image.x,
+                    .y = image.y,
+                    .width = image.rotated ? image.height : image.width,
+                    .height = image.rotated ? image.width : image.height,
+                    .offsetX = image.frameX,
+                    .offsetY = image.frameY,
+                    .sourceWidth = image.frameWidth,
+                    .sourceHeight = image.frameHeight,
+                    .page = pageIndex,
+                    .rotated = static_cast<ubyte>(image.rotated ? 1 : 0),
+                    .padding = 0,
+                });
+                frameNames.emplace_back(image.name);
+            }
+
+            ++pageIndex;
+        }
+
+        // sort frames by name, so that they can be searched in place
+        vector<size_t> order(frames.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), [&frameNames](const size_t a, const size_t b) {
+            return frameNames[a] < frameNames[b];
+        });
+
+        vector<sbc::AtlasFrame> sortedFrames;
+        sortedFrames.reserve(frames.size());
+        for (const auto i : order)
+            sortedFrames.emplace_back(frames[i]);
+
+        SbcWriter writer(sbc::AtlasFormat, sbc::AtlasVersion);
+        strings.write(writer);
+        writer.writeTable("PAGE", pages);
+        writer.writeTable("FRMS", sortedFrames);
+
+        return writer.save(filepath);
     }
 
-    writeFile(filepath, data, width * height * bytesPerPixel);
-    return true;
+    bool writeBMFontToSbc(const string &fontData, const fs::path &sourceDir, const fs::path &filepath,
+        const bool convertPages)
+    {
+        BMFontData data;
+        if (!BMFontData::fromBuffer(fontData, &data))
+            return false;
+
+        StringTable strings;
+        vector<sbc::Page> pages;
+        for (const auto &page : data.pages)
+        {
+            const auto pageName = fs::path(page.file).replace_extension(".sbc");
+            if (convertPages)
+            {
+                string imageData;
+                if (!readFile(sourceDir / page.file, &imageData) ||
+                    !writeImage(imageData, filepath.parent_path() / pageName))
+                {
+                    return false;
+                }
+            }
+
+            pages.push_back({strings.add(pageName.generic_string())});
+        }
+
+        const sbc::FontInfo info{
+            .name = strings.add(data.info.fontName),
+            .fontSize = data.info.fontSize,
+            .lineHeight = data.common.lineHeight,
+            .base = data.common.base,
+            .padding = 0,
+        };
+
+        vector<sbc::FontChar> chars;
+        chars.reserve(data.chars.size());
+        for (const auto &c : data.chars)
+        {
+            chars.push_back({c.id, c.x, c.y, c.width, c.height, c.xoffset, c.yoffset, c.xadvance, c.page, c.chnl});
+        }
+        std::sort(chars.begin(), chars.end(), [](const auto &a, const auto &b) { return a.id < b.id; });
+
+        vector<sbc::FontKerning> kernings;
+        kernings.reserve(data.kernings.size());
+        for (const auto &k : data.kernings)
+        {
+            kernings.push_back({k.first, k.second, k.amount, 0});
+        }
+        std::sort(kernings.begin(), kernings.end(), [](const auto &a, const auto &b) {
+            return a.first < b.first || (a.first == b.first && a.second < b.second);
+        });
+
+        SbcWriter writer(sbc::FontFormat, sbc::FontVersion);
+        strings.write(writer);
+
+        writer.beginChunk("INFO");
+        writer.write(info);
+        writer.endChunk();
+
+        writer.writeTable("PAGE", pages);
+        writer.writeTable("CHRS", chars);
+        writer.writeTable("KERN", kernings);
+
+        return writer.save(filepath);
+    }
 }
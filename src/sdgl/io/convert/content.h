@@ -5,7 +5,8 @@ namespace sdgl::io::convert {
 
     /// SBC (SDGL Binary Content) Format v1
     /// Purpose of this format is to strip out any unnecessary header data, converted to a format that can be directly
-    /// used by the engine.
+    /// used by the engine. Records are fixed-size and aligned, so a loaded or mapped file is used in place without
+    /// decoding or parsing; see `io/SbcReader.h` for the record structs.
     /// All integers are little endian, and unsigned unless otherwise noted. Strings are little endian.
     ///
     /// Format:
@@ -18,18 +19,66 @@ namespace sdgl::io::convert {
     /// Rest of the file consists of a series of chunks which are defined depending on the sub file format type.
     /// A chunk consists of:
     /// 4 byte string - chunk name (case-sensitive)
-    /// uint32 - length of rest of chunk in bytes (adding this many bytes from here will jump to the next chunk)
-    /// data filling the bytes specified in the length
+    /// uint32 - length of rest of chunk in bytes, not including padding
+    /// data filling the bytes specified in the length, then zero padding up to a multiple of 4 bytes, where the next
+    /// chunk begins
+    ///
+    /// Table chunks hold a uint32 record count followed by that many records. The "STRS" chunk holds null-terminated
+    /// strings that other chunks refer to by byte offset.
 
-    /// .SB IMG format v1
+    /// .SBC IMG format v1
     /// header string "IMG", version 1
-    /// [size]
-    /// length = 8
+    /// [HEAD]
+    /// length = 16
     /// uint32 - width in pixels
     /// uint32 - height in pixels
-    /// [data]
+    /// uint32 - pixel format, 0 = RGBA8888
+    /// uint32 - number of mip levels
+    /// [MIPS]
+    /// table of {uint32 width, uint32 height, uint32 byte offset into DATA, uint32 byte size}, one per mip level,
+    /// starting at full size and halving down to 1x1
+    /// [DATA]
     /// length = variable
-    /// series of uint32 indicating RGBA value for a pixel
+    /// pixels of each level; a series of uint32 indicating the RGBA value of a pixel
+    /// @param imageData contents of a .png, .jpg, .tga, .bmp or .hdr file
+    /// @param filepath  path of the file to write
     bool writeImageToSbc(const string &imageData, const string &filepath);
 
-}
\ No newline at end of file
+    /// .SBC ATL format v1, converted from a crunch binary atlas with trimming and rotation enabled
+    /// header string "ATL", version 1
+    /// [STRS]
+    /// [PAGE]
+    /// table of {uint32 image file name}, one per page; names are IMG files relative to the atlas file
+    /// [FRMS]
+    /// table of {uint32 name, int16 x, y, width, height, int16 offsetX, offsetY, int16 sourceWidth, sourceHeight,
+    /// uint16 page, ubyte rotated, ubyte padding}, sorted by name; the rectangle is as stored in the page
+    /// @param crunchData   contents of the crunch .bin file
+    /// @param sourceDir    directory holding the atlas' page .png files
+    /// @param filepath     path of the file to write
+    /// @param convertPages whether to write each page as an IMG file next to the atlas; disable it when the page
+    ///                     images are converted on their own
+    bool writeCrunchAtlasToSbc(const string &crunchData, const fs::path &sourceDir, const fs::path &filepath,
+        bool convertPages = true);
+
+    /// .SBC FNT format v1, converted from an AngelCode BMFont binary file
+    /// header string "FNT", version 1
+    /// [STRS]
+    /// [INFO]
+    /// length = 12
+    /// uint32 - font name, int16 - font size, uint16 - line height, uint16 - base, uint16 - padding
+    /// [PAGE]
+    /// table of {uint32 image file name}, one per page; names are IMG files relative to the font file
+    /// [CHRS]
+    /// table of {uint32 id, uint16 x, y, width, height, int16 xoffset, yoffset, xadvance, ubyte page,
+    /// ubyte channel}, sorted by id
+    /// [KERN]
+    /// table of {uint32 first, uint32 second, int16 amount, int16 padding}, sorted by first, then second
+    /// @param fontData     contents of the BMFont binary file
+    /// @param sourceDir    directory holding the font's page image files
+    /// @param filepath     path of the file to write
+    /// @param convertPages whether to write each page as an IMG file next to the font; disable it when the pages
+    ///                     are loaded from a texture atlas
+    bool writeBMFontToSbc(const string &fontData, const fs::path &sourceDir, const fs::path &filepath,
+        bool convertPages = true);
+
+}
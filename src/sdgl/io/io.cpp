@@ -1,18 +1,105 @@
 #include "io.h"
+#include "PakArchive.h"
 
 #include <sdgl/assert.h>
 #include <sdgl/logging.h>
 
 #include <SDL_filesystem.h>
 
+#include <algorithm>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 
 namespace sdgl::io {
+    /// Mounted archives, newest last
+    static vector<std::unique_ptr<PakArchive>> s_mounts;
+    static std::shared_mutex s_mountMutex;
+
+    /// Find a file in the mounted archives; caller holds `s_mountMutex`
+    static bool findMountedLocked(const fs::path &filepath, span<const ubyte> *outData)
+    {
+        if (s_mounts.empty())
+            return false;
+
+        auto archivePath = filepath;
+        if (filepath.is_absolute())
+        {
+            archivePath = filepath.lexically_relative(getResourcePath());
+            if (archivePath.empty() || *archivePath.begin() == "..")
+                return false;
+        }
+
+        for (auto it = s_mounts.rbegin(); it != s_mounts.rend(); ++it)
+        {
+            if ((*it)->find(archivePath, outData))
+                return true;
+        }
+
+        return false;
+    }
+
+    /// Copy a file out of the mounted archives, sparing an open and seek of the file system
+    template <typename Buffer>
+    static bool readMounted(const fs::path &filepath, Buffer *outBuffer)
+    {
+        std::shared_lock lock(s_mountMutex);
+
+        span<const ubyte> data;
+        if (!findMountedLocked(filepath, &data))
+            return false;
+
+        outBuffer->assign(data.begin(), data.end());
+        return true;
+    }
+
+    bool mount(const fs::path &pakPath)
+    {
+        auto archive = std::make_unique<PakArchive>();
+        if (!archive->open(pakPath))
+            return false;
+
+        std::unique_lock lock(s_mountMutex);
+        s_mounts.emplace_back(std::move(archive));
+        return true;
+    }
+
+    bool unmount(const fs::path &pakPath)
+    {
+        std::unique_lock lock(s_mountMutex);
+        const auto it = std::find_if(s_mounts.begin(), s_mounts.end(), [&pakPath](const auto &archive) {
+            return archive->path() == pakPath;
+        });
+
+        if (it == s_mounts.end())
+            return false;
+
+        s_mounts.erase(it);
+        return true;
+    }
+
+    void unmountAll()
+    {
+        std::unique_lock lock(s_mountMutex);
+        s_mounts.clear();
+    }
+
+    bool findMounted(const fs::path &filepath, span<const ubyte> *outData)
+    {
+        SDGL_ASSERT(outData, "Out data should not be null");
+
+        std::shared_lock lock(s_mountMutex);
+        return findMountedLocked(filepath, outData);
+    }
 
     bool readFile(const fs::path &filepath, string *outBuffer)
     {
         SDGL_ASSERT(outBuffer, "Out buffer should not be null");
 
+        if (readMounted(filepath, outBuffer))
+            return true;
+
         const auto fullpath = (filepath.is_absolute()) ? filepath : (getResourcePath() / filepath);
 
         std::ifstream file(fullpath, std::ios::binary | std::ios::in);
@@ -47,6 +134,9 @@ namespace sdgl::io {
     {
         SDGL_ASSERT(outBuffer, "Out buffer should not be null");
 
+        if (readMounted(filepath, outBuffer))
+            return true;
+
         const auto fullpath = (filepath.is_absolute()) ? filepath : (getResourcePath() / filepath);
 
         std::ifstream file(fullpath, std::ios::binary | std::ios::in);
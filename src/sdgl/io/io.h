@@ -4,12 +4,33 @@
 namespace sdgl::io {
 
     /// Read entire file into a null-terminated buffer string
-    /// @param filepath        path to the file to open, if it is a relative path, it stems from the resource directory
+    /// @param filepath        path to the file to open, if it is a relative path, it stems from the resource directory;
+    ///                        files under the resource directory are read from mounted archives first
     /// @param outBuffer [out] buffer to receive data
     /// @returns file buffer string, or unset std::optional if file failed to load
     bool readFile(const fs::path &filepath, string *outBuffer);
     bool readFile(const fs::path &filepath, vector<ubyte> *outBuffer);
 
+    /// Mount a pak archive at the resource directory, so that `readFile` and the asset loaders find its files there.
+    /// Archives mounted later take precedence. Mounting isn't synchronized with views already handed out: unmount
+    /// only when no asset is loading from the archive.
+    /// @param pakPath path to the archive, if it is a relative path, it stems from the resource directory
+    /// @returns whether the archive was mounted
+    bool mount(const fs::path &pakPath);
+
+    /// Unmount an archive mounted via `mount`; views of its files become invalid
+    /// @returns whether the archive was mounted
+    bool unmount(const fs::path &pakPath);
+
+    /// Unmount every archive
+    void unmountAll();
+
+    /// Find a file in the mounted archives without copying it
+    /// @param filepath      path to the file, if it is a relative path, it stems from the resource directory
+    /// @param outData [out] receives a view of the file, valid until its archive is unmounted
+    /// @returns whether a mounted archive holds the file
+    bool findMounted(const fs::path &filepath, span<const ubyte> *outData);
+
     /// Get path to read-only resource directory
     const fs::path &getResourcePath();
 
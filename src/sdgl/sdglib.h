@@ -7,6 +7,7 @@
 #include <functional>
 #include <map>
 #include <set>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -33,6 +34,7 @@ namespace sdgl {
 
         using std::array;
 
+        using std::span;
         using std::vector;
         using std::set;
 
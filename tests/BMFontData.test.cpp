@@ -1,5 +1,6 @@
 #include "lib.h"
 #include <sdgl/graphics/font/BMFontData.h>
+#include <sdgl/io/MappedFile.h>
 
 using sdgl::BMFontData;
 
@@ -16,4 +17,16 @@ TEST_CASE("BMFontData tests", "sdgl::graphics::BMFontData")
         REQUIRE(data.pages.size() == 1);
         REQUIRE(data.pages[0].file == "font_0.png");
     }
+
+    SECTION("Read mapped file in place")
+    {
+        io::MappedFile file;
+        REQUIRE(file.open("assets/bmfont/arial.fnt"));
+
+        BMFontData data;
+        REQUIRE(BMFontData::fromBuffer(file.data(), &data));
+
+        REQUIRE(data.info.fontName == "Arial");
+        REQUIRE(data.pages.size() == 1);
+    }
 }
\ No newline at end of file
@@ -46,6 +46,17 @@ TEST_CASE("BufferView tests", "sdgl::io::BufferView")
         REQUIRE(value == "Hello world!");
     }
 
+    SECTION("span<const ubyte> constructor")
+    {
+        const ubyte buffer[] = {'H', 'e', 'l', 'l', 'o', ' ', 'w', 'o', 'r', 'l', 'd', '!', '\0' };
+        auto view = io::BufferView(span<const ubyte>(buffer));
+
+        string value;
+        REQUIRE(view.read(value));
+
+        REQUIRE(value == "Hello world!");
+    }
+
     SECTION("Can read into cstring")
     {
         auto buffer = "Hello world!";
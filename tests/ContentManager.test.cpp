@@ -0,0 +1,74 @@
+#include "lib.h"
+#include <sdgl/ContentManager.h>
+#include <sdgl/core/backend/Backend.h>
+#include <sdgl/io/io.h>
+#include <sdgl/io/convert/content.h>
+
+/// Hidden window whose GL context textures upload to, torn down when it leaves scope
+struct TestContext
+{
+    TestContext() : backend(), window()
+    {
+        if (backend.init())
+        {
+            window = backend.createWindow("sdgl ContentManager test", 64, 64, WindowInit::None,
+                PluginConfig{.imgui = false});
+            if (window)
+                window->setHidden(true);
+        }
+    }
+
+    ~TestContext()
+    {
+        if (window)
+            backend.destroyWindow(window);
+        backend.shutdown();
+    }
+
+    Backend backend;
+    Window *window;
+};
+
+TEST_CASE("ContentManager tests", "sdgl::ContentManager")
+{
+    TestContext context;
+    if (!context.window)
+        SKIP("No GL context available");
+
+    SECTION("A failed background load keeps showing the placeholder")
+    {
+        ContentManager content;
+        const auto texture = content.loadTextureAsync("assets/missing.png");
+        REQUIRE(texture);
+
+        const auto placeholderId = texture->id();
+        REQUIRE(placeholderId != 0);
+
+        content.finishLoading();
+        REQUIRE_FALSE(content.isLoading("assets/missing.png"));
+        REQUIRE(texture->id() == placeholderId);
+        REQUIRE_FALSE(content.useTexture(texture));
+    }
+
+    SECTION("Loads an SBC texture in the background")
+    {
+        const auto sbcPath = fs::temp_directory_path() / "sdgl_ContentManager_test.sbc";
+        string imageData;
+        REQUIRE(io::readFile("assets/bmfont/font_0.png", &imageData));
+        REQUIRE(io::convert::writeImageToSbc(imageData, sbcPath.string()));
+
+        ContentManager content;
+        const auto texture = content.loadTextureAsync(sbcPath);
+        REQUIRE(texture);
+        const auto placeholderId = texture->id();
+
+        content.finishLoading();
+        REQUIRE_FALSE(content.isLoading(sbcPath));
+        REQUIRE(texture->id() != placeholderId);
+        REQUIRE(texture->size() == Point(256, 256));
+        REQUIRE(content.useTexture(texture));
+
+        content.unloadAll();
+        fs::remove(sbcPath);
+    }
+}
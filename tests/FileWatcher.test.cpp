@@ -0,0 +1,50 @@
+#include "lib.h"
+#include <sdgl/io/FileWatcher.h>
+
+#include <fstream>
+
+TEST_CASE("FileWatcher tests", "sdgl::io::FileWatcher")
+{
+    if (!io::FileWatcher::isSupported())
+        return;
+
+    const auto root = (fs::temp_directory_path() / "sdgl_FileWatcher_test").lexically_normal();
+    fs::remove_all(root);
+    fs::create_directories(root / "sub");
+
+    io::FileWatcher watcher;
+    REQUIRE(watcher.open(root, 0));
+
+    vector<fs::path> changed;
+
+    SECTION("Reports a burst of writes to a file once")
+    {
+        for (int i = 0; i < 3; ++i)
+            std::ofstream(root / "sub" / "image.png") << i;
+
+        REQUIRE(watcher.poll(&changed) == 1);
+        REQUIRE(changed.back() == root / "sub" / "image.png");
+        REQUIRE(watcher.poll(&changed) == 0);
+    }
+
+    SECTION("Watches directories created after opening")
+    {
+        fs::create_directories(root / "new");
+        REQUIRE(watcher.poll(&changed) == 0);
+
+        std::ofstream(root / "new" / "font.fnt") << "data";
+        REQUIRE(watcher.poll(&changed) == 1);
+        REQUIRE(changed.back() == root / "new" / "font.fnt");
+    }
+
+    SECTION("Waits for files to go quiet")
+    {
+        REQUIRE(watcher.open(root, 60000));
+
+        std::ofstream(root / "atlas.bin") << "data";
+        REQUIRE(watcher.poll(&changed) == 0);
+    }
+
+    watcher.close();
+    fs::remove_all(root);
+}
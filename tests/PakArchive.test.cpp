@@ -0,0 +1,72 @@
+#include "lib.h"
+#include <sdgl/io/io.h>
+#include <sdgl/io/PakArchive.h>
+
+/// Unmounts an archive when it leaves scope, so a failed check doesn't leave it mounted for later tests
+struct MountGuard
+{
+    explicit MountGuard(fs::path path) : path(std::move(path)) { }
+    ~MountGuard() { io::unmount(path); }
+
+    fs::path path;
+};
+
+TEST_CASE("PakArchive tests", "sdgl::io::PakArchive")
+{
+    const auto pakPath = fs::temp_directory_path() / "sdgl_PakArchive_test.pak";
+    const auto assetDir = io::getResourcePath() / "assets";
+
+    SECTION("Packs a folder and finds its files")
+    {
+        REQUIRE(io::PakArchive::pack(assetDir, {}, pakPath));
+
+        io::PakArchive archive;
+        REQUIRE(archive.open(pakPath));
+        REQUIRE(archive.contains("bmfont/arial.fnt"));
+        REQUIRE(archive.contains("bmfont/font_0.png"));
+
+        string expected;
+        REQUIRE(io::readFile("assets/bmfont/arial.fnt", &expected));
+
+        span<const ubyte> data;
+        REQUIRE(archive.find("bmfont/arial.fnt", &data));
+        REQUIRE(string(data.begin(), data.end()) == expected);
+        REQUIRE(reinterpret_cast<uintptr_t>(data.data()) % io::PakArchive::DataAlignment == 0);
+
+        REQUIRE(archive.contains("./bmfont/../bmfont/font_0.png"));
+        REQUIRE_FALSE(archive.contains("bmfont/missing.png"));
+    }
+
+    SECTION("Packs a file list")
+    {
+        const fs::path files[] = {"bmfont/font_0.png"};
+        REQUIRE(io::PakArchive::pack(assetDir, files, pakPath));
+
+        io::PakArchive archive;
+        REQUIRE(archive.open(pakPath));
+        REQUIRE(archive.fileCount() == 1);
+        REQUIRE(archive.contains("bmfont/font_0.png"));
+        REQUIRE_FALSE(archive.contains("bmfont/arial.fnt"));
+    }
+
+    SECTION("Mounted archives are read at the resource path")
+    {
+        const fs::path files[] = {"assets/bmfont/arial.fnt"};
+        REQUIRE(io::PakArchive::pack(io::getResourcePath(), files, pakPath));
+        REQUIRE(io::mount(pakPath));
+        MountGuard mounted(pakPath);
+
+        span<const ubyte> data;
+        REQUIRE(io::findMounted("assets/bmfont/arial.fnt", &data));
+        REQUIRE(io::findMounted(io::getResourcePath() / "assets/bmfont/arial.fnt", &data));
+
+        string buffer;
+        REQUIRE(io::readFile("assets/bmfont/arial.fnt", &buffer));
+        REQUIRE(string(data.begin(), data.end()) == buffer);
+
+        REQUIRE(io::unmount(pakPath));
+        REQUIRE_FALSE(io::findMounted("assets/bmfont/arial.fnt", &data));
+    }
+
+    fs::remove(pakPath);
+}
@@ -0,0 +1,48 @@
+#include "lib.h"
+#include <sdgl/graphics/RenderThread.h>
+
+TEST_CASE("RenderThread tests", "sdgl::RenderThread")
+{
+    SECTION("Executes submitted frames before a later invokeSync")
+    {
+        RenderThread thread;
+        REQUIRE(thread.start(nullptr));
+
+        // only touched on the render thread until it's stopped
+        vector<int> order;
+        for (int i = 0; i < 100; ++i)
+        {
+            thread.commands().invoke([&order, i] { order.emplace_back(i * 2); });
+            thread.submit();
+            thread.invokeSync([&order, i] { order.emplace_back(i * 2 + 1); });
+        }
+        thread.stop();
+
+        REQUIRE(order.size() == 200);
+        for (int i = 0; i < 200; ++i)
+            REQUIRE(order[i] == i);
+    }
+
+    SECTION("Runs invokeSync right away while stopped")
+    {
+        RenderThread thread;
+        auto called = false;
+        thread.invokeSync([&called] { called = true; });
+        REQUIRE(called);
+    }
+
+    SECTION("Only the running render thread is the GL thread")
+    {
+        RenderThread thread;
+        REQUIRE(RenderThread::isRenderThread());
+
+        REQUIRE(thread.start(nullptr));
+        REQUIRE_FALSE(RenderThread::isRenderThread());
+        auto onRenderThread = false;
+        thread.invokeSync([&onRenderThread] { onRenderThread = RenderThread::isRenderThread(); });
+        REQUIRE(onRenderThread);
+
+        thread.stop();
+        REQUIRE(RenderThread::isRenderThread());
+    }
+}
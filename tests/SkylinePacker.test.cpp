@@ -0,0 +1,75 @@
+#include "lib.h"
+#include <sdgl/graphics/atlas/SkylinePacker.h>
+#include <sdgl/math/Rectangle.h>
+
+TEST_CASE("SkylinePacker tests", "sdgl::SkylinePacker")
+{
+    SECTION("Fills the area exactly with equal rectangles")
+    {
+        SkylinePacker packer(64, 64);
+        for (int i = 0; i < 16; ++i)
+        {
+            Point position;
+            REQUIRE(packer.insert(16, 16, &position));
+            REQUIRE(position.x % 16 == 0);
+            REQUIRE(position.y % 16 == 0);
+        }
+
+        REQUIRE(packer.occupancy() == 1.f);
+        REQUIRE_FALSE(packer.insert(1, 1, nullptr));
+    }
+
+    SECTION("Rejects rectangles larger than the area")
+    {
+        SkylinePacker packer(32, 32);
+        REQUIRE_FALSE(packer.insert(33, 1, nullptr));
+        REQUIRE_FALSE(packer.insert(1, 33, nullptr));
+        REQUIRE_FALSE(packer.insert(0, 4, nullptr));
+        REQUIRE(packer.insert(32, 32, nullptr));
+    }
+
+    SECTION("Rectangles stay in bounds and don't overlap")
+    {
+        SkylinePacker packer(128, 128);
+        vector<Rectangle> placed;
+        for (int i = 0; i < 200; ++i)
+        {
+            const auto width = 1 + (i * 7) % 23;
+            const auto height = 1 + (i * 13) % 19;
+
+            Point position;
+            if (!packer.insert(width, height, &position))
+                continue;
+
+            const Rectangle rect(position.x, position.y, width, height);
+            REQUIRE(rect.x >= 0);
+            REQUIRE(rect.y >= 0);
+            REQUIRE(rect.x + rect.w <= 128);
+            REQUIRE(rect.y + rect.h <= 128);
+
+            for (const auto &other : placed)
+            {
+                const auto overlaps = rect.x < other.x + other.w && other.x < rect.x + rect.w &&
+                    rect.y < other.y + other.h && other.y < rect.y + rect.h;
+                REQUIRE_FALSE(overlaps);
+            }
+
+            placed.emplace_back(rect);
+        }
+
+        REQUIRE(placed.size() > 50);
+        REQUIRE(packer.occupancy() > 0.5f);
+    }
+
+    SECTION("Reset empties and resizes the area")
+    {
+        SkylinePacker packer(16, 16);
+        REQUIRE(packer.insert(16, 16, nullptr));
+
+        packer.reset(32, 8);
+        REQUIRE(packer.width() == 32);
+        REQUIRE(packer.height() == 8);
+        REQUIRE(packer.occupancy() == 0);
+        REQUIRE(packer.insert(32, 8, nullptr));
+    }
+}
@@ -0,0 +1,346 @@
+/// Cooks a content tree into runtime formats, converting changed inputs in parallel
+///
+/// Usage: sdgl_cook <source directory> <output directory> [--jobs:<count>] [--manifest:<path>] [--force]
+///
+/// Each file under the source directory is cooked to the same relative path under the output directory:
+/// images (.png, .jpg, .jpeg, .tga, .bmp) become SBC IMG .sbc files, crunch atlases (.bin) SBC ATL .sbc files and
+/// BMFont binaries (.fnt) SBC FNT .sbc files; anything else is copied. Atlas and font pages are images in the tree,
+/// so each is converted once, by itself.
+///
+/// The manifest, ".sdgl_cook" in the output directory by default, records the size, modification time and content
+/// hash of each input. Inputs whose size and time are unchanged are skipped without being read; touched inputs with
+/// unchanged content are only hashed. Outputs of inputs that were deleted are removed.
+#include <sdgl/ArgParser.h>
+#include <sdgl/ThreadPool.h>
+#include <sdgl/io/io.h>
+#include <sdgl/io/convert/content.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace sdgl;
+
+/// Bump when converters change output, so everything is cooked again
+static constexpr int ManifestVersion = 1;
+static constexpr const char *ManifestHeader = "sdgl_cook manifest";
+
+struct InputKind
+{
+    enum Enum
+    {
+        Image,
+        CrunchAtlas,
+        BMFont,
+        Copy,
+    };
+};
+
+/// State of an input when it was last cooked
+struct ManifestEntry
+{
+    string output;      ///< path relative to the output directory
+    uint64 size;
+    int64 time;         ///< modification time, in file clock ticks
+    uint64 hash;
+};
+
+struct CookJob
+{
+    string source;                      ///< path relative to the source directory, '/' separated
+    string output;                      ///< path relative to the output directory, '/' separated
+    InputKind::Enum kind;
+    const ManifestEntry *previous;      ///< null if it wasn't cooked before
+    ManifestEntry result;
+    bool cooked;
+    bool failed;
+};
+
+static InputKind::Enum getInputKind(const fs::path &filepath)
+{
+    auto extension = filepath.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+        [](const char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+
+    if (extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" ||
+        extension == ".bmp")
+        return InputKind::Image;
+    if (extension == ".bin")
+        return InputKind::CrunchAtlas;
+    if (extension == ".fnt")
+        return InputKind::BMFont;
+    return InputKind::Copy;
+}
+
+/// 64-bit FNV-1a hash of file contents
+static uint64 hashContent(const string &data)
+{
+    uint64 hash = 14695981039346656037ull;
+    for (const auto c : data)
+    {
+        hash ^= static_cast<ubyte>(c);
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+/// Read a manifest; a missing, outdated or malformed one leaves it empty, cooking everything
+static void loadManifest(const fs::path &filepath, map<string, ManifestEntry> *outEntries)
+{
+    std::ifstream file(filepath);
+    if (!file.is_open())
+        return;
+
+    string line;
+    if (!std::getline(file, line) || line != ManifestHeader + (" " + std::to_string(ManifestVersion)))
+        return;
+
+    map<string, ManifestEntry> entries;
+    while (std::getline(file, line))
+    {
+        // source \t output \t size \t time \t hash
+        std::istringstream fields(line);
+        string source, output, size, time, hash;
+        if (!std::getline(fields, source, '\t') || !std::getline(fields, output, '\t') ||
+            !std::getline(fields, size, '\t') || !std::getline(fields, time, '\t') || !std::getline(fields, hash))
+        {
+            std::fprintf(stderr, "Ignoring malformed manifest \"%s\"\n", filepath.string().c_str());
+            return;
+        }
+
+        try
+        {
+            entries[source] = {output, std::stoull(size), std::stoll(time), std::stoull(hash, nullptr, 16)};
+        }
+        catch (const std::exception &)
+        {
+            std::fprintf(stderr, "Ignoring malformed manifest \"%s\"\n", filepath.string().c_str());
+            return;
+        }
+    }
+
+    outEntries->swap(entries);
+}
+
+static bool saveManifest(const fs::path &filepath, const map<string, ManifestEntry> &entries)
+{
+    std::ostringstream out;
+    out << ManifestHeader << ' ' << ManifestVersion << '\n';
+    for (const auto &[source, entry] : entries)
+    {
+        out << source << '\t' << entry.output << '\t' << entry.size << '\t' << entry.time << '\t' << std::hex <<
+            entry.hash << std::dec << '\n';
+    }
+
+    return io::writeFile(filepath, out.str());
+}
+
+static bool convert(const CookJob &job, const string &data, const fs::path &sourceFile, const fs::path &outputFile)
+{
+    switch (job.kind)
+    {
+    case InputKind::Image:
+        return io::convert::writeImageToSbc(data, outputFile.string());
+    case InputKind::CrunchAtlas:
+        return io::convert::writeCrunchAtlasToSbc(data, sourceFile.parent_path(), outputFile, false);
+    case InputKind::BMFont:
+        return io::convert::writeBMFontToSbc(data, sourceFile.parent_path(), outputFile, false);
+    case InputKind::Copy:
+        {
+            std::error_code ec;
+            fs::create_directories(outputFile.parent_path(), ec);
+            return io::writeFile(outputFile, data);
+        }
+    }
+
+    return false;
+}
+
+static void cook(CookJob &job, const fs::path &sourceDir, const fs::path &outputDir, const bool force)
+{
+    const auto sourceFile = sourceDir / job.source;
+    const auto outputFile = outputDir / job.output;
+
+    std::error_code ec;
+    const auto size = fs::file_size(sourceFile, ec);
+    const auto time = ec ? 0 : static_cast<int64>(fs::last_write_time(sourceFile, ec).time_since_epoch().count());
+    if (ec)
+    {
+        std::fprintf(stderr, "Failed to stat \"%s\": %s\n", sourceFile.string().c_str(), ec.message().c_str());
+        job.failed = true;
+        return;
+    }
+
+    const auto upToDate = !force && job.previous && job.previous->output == job.output && fs::exists(outputFile, ec);
+    if (upToDate && job.previous->size == size && job.previous->time == time)
+    {
+        job.result = *job.previous;
+        return;
+    }
+
+    string data;
+    if (!io::readFile(sourceFile, &data))
+    {
+        job.failed = true;
+        return;
+    }
+
+    job.result = {job.output, size, time, hashContent(data)};
+    if (upToDate && job.previous->hash == job.result.hash)
+        return;
+
+    if (!convert(job, data, sourceFile, outputFile))
+    {
+        std::fprintf(stderr, "Failed to cook \"%s\"\n", job.source.c_str());
+        job.failed = true;
+        return;
+    }
+
+    job.cooked = true;
+}
+
+int main(int argc, char *argv[])
+{
+    ArgParser args;
+    string sourceArg, outputArg;
+    if (!args.setArgs(argc, argv) || !args.getNamelessArg(1, &sourceArg) || !args.getNamelessArg(2, &outputArg))
+    {
+        std::fprintf(stderr,
+            "Usage: %s <source directory> <output directory> [--jobs:<count>] [--manifest:<path>] [--force]\n",
+            argv[0]);
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto sourceDir = fs::absolute(sourceArg).lexically_normal();
+    const auto outputDir = fs::absolute(outputArg).lexically_normal();
+
+    int jobCount = static_cast<int>(std::thread::hardware_concurrency());
+    if (ArgParser::Arg arg("", ""); args.getNamedArg("jobs", &arg) || args.getNamedArg("j", &arg))
+    {
+        if (!arg.getValue(&jobCount) || jobCount < 1)
+        {
+            std::fprintf(stderr, "--jobs expects a positive number\n");
+            return 1;
+        }
+    }
+
+    auto manifestPath = outputDir / ".sdgl_cook";
+    if (ArgParser::Arg arg("", ""); args.getNamedArg("manifest", &arg))
+    {
+        string value;
+        if (!arg.getValue(&value))
+        {
+            std::fprintf(stderr, "--manifest expects a path\n");
+            return 1;
+        }
+        manifestPath = fs::absolute(value);
+    }
+
+    ArgParser::Arg forceArg("", "");
+    const auto force = args.getNamedArg("force", &forceArg);
+
+    map<string, ManifestEntry> manifest;
+    if (!force)
+        loadManifest(manifestPath, &manifest);
+
+    // Collect inputs, skipping the output directory if it's inside the source directory
+    vector<CookJob> jobs;
+    map<string, string> outputs; ///< source of each output, to catch inputs that cook to the same file
+    std::error_code ec;
+    for (auto it = fs::recursive_directory_iterator(sourceDir, ec); !ec && it != fs::recursive_directory_iterator();
+         it.increment(ec))
+    {
+        if (it->is_directory() && it->path() == outputDir)
+        {
+            it.disable_recursion_pending();
+            continue;
+        }
+
+        if (!it->is_regular_file() || it->path() == manifestPath)
+            continue;
+
+        const auto source = it->path().lexically_relative(sourceDir);
+        const auto kind = getInputKind(source);
+        auto output = source;
+        if (kind != InputKind::Copy)
+            output.replace_extension(".sbc");
+
+        auto job = CookJob {
+            .source = source.generic_string(),
+            .output = output.generic_string(),
+            .kind = kind,
+            .previous = nullptr,
+            .result = {},
+            .cooked = false,
+            .failed = false,
+        };
+
+        if (const auto [other, inserted] = outputs.try_emplace(job.output, job.source); !inserted)
+        {
+            std::fprintf(stderr, "\"%s\" and \"%s\" both cook to \"%s\", skipping the latter\n",
+                other->second.c_str(), job.source.c_str(), job.output.c_str());
+            continue;
+        }
+
+        if (const auto previous = manifest.find(job.source); previous != manifest.end())
+            job.previous = &previous->second;
+        jobs.emplace_back(std::move(job));
+    }
+
+    if (ec)
+    {
+        std::fprintf(stderr, "Failed to list files in \"%s\": %s\n", sourceDir.string().c_str(),
+            ec.message().c_str());
+        return 1;
+    }
+
+    // Cook, each job writing only its own results
+    {
+        ThreadPool workers(jobCount);
+        for (auto &job : jobs)
+        {
+            workers.push([&job, &sourceDir, &outputDir, force] {
+                cook(job, sourceDir, outputDir, force);
+            });
+        }
+        workers.wait();
+    }
+
+    // Record results; failed inputs are left out so they're retried next time
+    map<string, ManifestEntry> cooked;
+    int cookedCount = 0, failedCount = 0, removedCount = 0;
+    for (const auto &job : jobs)
+    {
+        if (job.failed)
+        {
+            ++failedCount;
+            continue;
+        }
+
+        cookedCount += job.cooked;
+        cooked.emplace(job.source, job.result);
+    }
+
+    // Remove outputs of deleted inputs, unless another input now cooks to the same file
+    for (const auto &[source, entry] : manifest)
+    {
+        if (cooked.contains(source) || outputs.contains(entry.output))
+            continue;
+
+        if (fs::remove(outputDir / entry.output, ec))
+            ++removedCount;
+    }
+
+    if (!saveManifest(manifestPath, cooked))
+        return 1;
+
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    std::printf("Cooked %d, up to date %d, failed %d, removed %d in %.0f ms\n", cookedCount,
+        static_cast<int>(jobs.size()) - cookedCount - failedCount, failedCount, removedCount, elapsed.count());
+    return failedCount > 0 ? 1 : 0;
+}
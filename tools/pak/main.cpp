@@ -0,0 +1,34 @@
+/// Packs asset files into a pak archive, to be mounted via io::mount
+///
+/// Usage: sdgl_pak <output archive> <root directory> [files relative to the root...]
+/// Without a file list, every regular file under the root directory is packed.
+#include <sdgl/io/PakArchive.h>
+
+#include <cstdio>
+
+using namespace sdgl;
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        std::fprintf(stderr, "Usage: %s <output archive> <root directory> [files...]\n", argv[0]);
+        return 1;
+    }
+
+    const fs::path output = argv[1];
+    const fs::path root = argv[2];
+
+    vector<fs::path> files;
+    files.reserve(argc - 3);
+    for (int i = 3; i < argc; ++i)
+        files.emplace_back(argv[i]);
+
+    if (!io::PakArchive::pack(root, files, output))
+    {
+        std::fprintf(stderr, "Failed to pack \"%s\"\n", output.string().c_str());
+        return 1;
+    }
+
+    return 0;
+}